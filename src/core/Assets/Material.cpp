@@ -9,6 +9,41 @@ namespace chronicle {
 
 CHR_CONCRETE(Material);
 
+/// @brief Texture bound in place of a missing material texture.
+enum class DefaultTexture {
+    white, ///< Opaque white, neutral for the color, metallic-roughness, occlusion and emissive textures.
+    normal, ///< Flat tangent space normal.
+};
+
+struct MaterialContext {
+    static inline std::array<std::weak_ptr<Texture>, 2> defaultTextures = {};
+    static inline std::mutex mutex = {}; ///< The materials are built by the asynchronous imports.
+};
+
+/// @brief Get a default texture, it's shared by the materials while they use it.
+/// @param defaultTexture Default texture.
+/// @return The texture.
+static TextureRef getDefaultTexture(DefaultTexture defaultTexture)
+{
+    std::scoped_lock<std::mutex> lock(MaterialContext::mutex);
+
+    auto& cached = MaterialContext::defaultTextures[static_cast<size_t>(defaultTexture)];
+    if (auto texture = cached.lock()) {
+        return texture;
+    }
+
+    // 1x1 pixel, the sampler repeats it on the whole surface
+    std::array<uint8_t, 4> pixel = { 255, 255, 255, 255 };
+    if (defaultTexture == DefaultTexture::normal) {
+        pixel = { 128, 128, 255, 255 };
+    }
+    auto texture = Texture::createSampled(
+        { .generateMipmaps = false, .data = pixel, .width = 1, .height = 1 },
+        fmt::format("Default texture: {}", magic_enum::enum_name(defaultTexture)));
+    cached = texture;
+    return texture;
+}
+
 Material::Material(const char* debugName) { }
 
 void Material::build()
@@ -19,29 +54,46 @@ void Material::build()
 
     const char* debugName = "test";
 
+    // the missing textures are kept alive by the material, the descriptor set doesn't reference them
+    _defaultTextures.clear();
+    auto textureOrDefault = [this](const TextureRef& texture, DefaultTexture defaultTexture) {
+        if (texture) {
+            return texture;
+        }
+        auto replacement = getDefaultTexture(defaultTexture);
+        _defaultTextures.push_back(replacement);
+        return replacement;
+    };
+
+    // the bindings follow the shader, from 1 to 5
+    std::array<TextureRef, 5> textures = { textureOrDefault(_baseColorTexture, DefaultTexture::white),
+        textureOrDefault(_metallicRoughnessTexture, DefaultTexture::white),
+        textureOrDefault(_normalTexture, DefaultTexture::normal),
+        textureOrDefault(_occlusionTexture, DefaultTexture::white),
+        textureOrDefault(_emissiveTexture, DefaultTexture::white) };
+
     _descriptorSet = DescriptorSet::create(debugName);
     _descriptorSet->addUniform<MaterialUBO>("ubo"_hs, ShaderStage::fragment);
-    if (_baseColorTexture) {
-        CHRLOG_DEBUG("Material: found base color texture");
-        _descriptorSet->addSampler(ShaderStage::fragment, _baseColorTexture);
-    }
-    if (_metallicRoughnessTexture) {
-        CHRLOG_DEBUG("Material: found metallic roughness texture");
-        _descriptorSet->addSampler(ShaderStage::fragment, _metallicRoughnessTexture);
-    }
-    if (_normalTexture) {
-        CHRLOG_DEBUG("Material: found normal texture");
-        _descriptorSet->addSampler(ShaderStage::fragment, _normalTexture);
-    }
-    if (_occlusionTexture) {
-        CHRLOG_DEBUG("Material: found occlusion texture");
-        _descriptorSet->addSampler(ShaderStage::fragment, _occlusionTexture);
-    }
-    if (_emissiveTexture) {
-        CHRLOG_DEBUG("Material: found emissive texture");
-        _descriptorSet->addSampler(ShaderStage::fragment, _emissiveTexture);
+    for (const auto& texture : textures) {
+        _descriptorSet->addSampler(ShaderStage::fragment, texture);
     }
     _descriptorSet->build();
+
+    // the value is kept by the descriptor set and copied in the uniform ring of the frames that draw the material
+    _descriptorSet->setUniform<MaterialUBO>("ubo"_hs, _ubo);
+}
+
+std::vector<SpecializationConstant> Material::specializationConstants() const
+{
+    // the IDs are the constant_id of the HAS_*_TEXTURE constants in MaterialPbr.glsl
+    auto enabled = [](const TextureRef& texture) -> uint32_t { return texture ? 1 : 0; };
+    return {
+        { .id = 0, .value = enabled(_baseColorTexture) },
+        { .id = 1, .value = enabled(_metallicRoughnessTexture) },
+        { .id = 2, .value = enabled(_normalTexture) },
+        { .id = 3, .value = enabled(_occlusionTexture) },
+        { .id = 4, .value = enabled(_emissiveTexture) },
+    };
 }
 
 MaterialRef Material::create(const char* debugName) { return std::make_shared<ConcreteMaterial>(debugName); }
@@ -160,9 +160,14 @@ public:
     /// @return True if available.
     bool haveEmissiveTexture() { return _emissiveTexture != nullptr; }
 
-    /// @brief Build the material.
+    /// @brief Build the material. The missing textures are replaced by default textures, so every material has the
+    ///        same descriptor set layout.
     void build();
 
+    /// @brief Get the specialization constants that enable the material textures in the shader.
+    /// @return Specialization constants, with the IDs declared in MaterialPbr.glsl.
+    [[nodiscard]] std::vector<SpecializationConstant> specializationConstants() const;
+
     /// @brief Get the descriptor set for the material.
     /// @return The descriptor set.
     DescriptorSetRef descriptorSet() const { return _descriptorSet; }
@@ -179,6 +184,7 @@ private:
     TextureRef _normalTexture {}; ///< The tangent space normal texture.
     TextureRef _occlusionTexture {}; ///< The occlusion texture.
     TextureRef _emissiveTexture {}; ///< The emissive texture.
+    std::vector<TextureRef> _defaultTextures {}; ///< Default textures bound in place of the missing ones.
     DescriptorSetRef _descriptorSet {}; ///< Descriptor set.
 };
 
@@ -7,11 +7,57 @@ namespace chronicle {
 
 CHR_CONCRETE(Mesh);
 
-Mesh::Mesh(const std::vector<Submesh>& submeshes)
+Mesh::Mesh(const std::vector<Submesh>& submeshes, const std::vector<glm::mat4>& instances)
     : _submeshes(submeshes)
+    , _instances(instances)
 {
+    CHRZONE_ASSETS;
+
+    // the instance data is shared by all the submeshes, the normal transforms are computed once here
+    std::vector<MeshInstance> instancesData(_instances.size());
+    for (size_t i = 0; i < _instances.size(); i++) {
+        instancesData[i].transform = _instances[i];
+        instancesData[i].normalTransform = glm::transpose(glm::inverse(glm::mat3(_instances[i])));
+    }
+    _instancesRange = GeometryPool::allocateVertices(
+        std::span(std::bit_cast<const uint8_t*>(instancesData.data()), instancesData.size() * sizeof(MeshInstance)),
+        sizeof(MeshInstance));
+}
+
+Mesh::~Mesh()
+{
+    CHRZONE_ASSETS;
+
+    // the ranges are reused after the frames in flight
+    for (const auto& submesh : _submeshes) {
+        GeometryPool::free(submesh.vertices);
+        GeometryPool::free(submesh.indices);
+    }
+    GeometryPool::free(_instancesRange);
 }
 
-MeshRef Mesh::create(const std::vector<Submesh>& submeshes) { return std::make_shared<ConcreteMesh>(submeshes); }
+VertexBufferInfo Mesh::instanceBufferInfo()
+{
+    // a column of the matrices for every location
+    VertexBufferInfo vertexBufferInfo = {};
+    vertexBufferInfo.stride = sizeof(MeshInstance);
+    vertexBufferInfo.inputRate = VertexInputRate::instance;
+    for (uint32_t column = 0; column < 4; column++) {
+        vertexBufferInfo.attributeDescriptions.push_back({ .format = Format::R32G32B32A32Sfloat,
+            .offset = static_cast<uint32_t>(offsetof(MeshInstance, transform) + column * sizeof(glm::vec4)),
+            .location = InstanceTransformLocation + column });
+    }
+    for (uint32_t column = 0; column < 3; column++) {
+        vertexBufferInfo.attributeDescriptions.push_back({ .format = Format::R32G32B32Sfloat,
+            .offset = static_cast<uint32_t>(offsetof(MeshInstance, normalTransform) + column * sizeof(glm::vec3)),
+            .location = InstanceNormalTransformLocation + column });
+    }
+    return vertexBufferInfo;
+}
+
+MeshRef Mesh::create(const std::vector<Submesh>& submeshes, const std::vector<glm::mat4>& instances)
+{
+    return std::make_shared<ConcreteMesh>(submeshes, instances);
+}
 
 } // namespace chronicle
\ No newline at end of file
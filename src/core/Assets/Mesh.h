@@ -19,19 +19,52 @@ struct BoundingBox {
     glm::vec3 max {};
 };
 
+/// @brief Push constants used by the vertex shader to dequantize the positions.
+struct VertexDequantization {
+    /// @brief Position offset, the minimal value of the quantization range.
+    glm::vec4 positionOffset { 0.0f };
+
+    /// @brief Position scale, the extent of the quantization range.
+    glm::vec4 positionScale { 1.0f };
+};
+
+/// @brief Location of the per instance transform, a matrix uses four consecutive locations.
+constexpr uint32_t InstanceTransformLocation = 8;
+
+/// @brief Location of the per instance normal transform, a matrix uses three consecutive locations.
+constexpr uint32_t InstanceNormalTransformLocation = 12;
+
+/// @brief Per instance data in the geometry pool.
+struct MeshInstance {
+    /// @brief Model transform.
+    glm::mat4 transform {};
+
+    /// @brief Inverse transpose of the model transform, correct for the normals with a non-uniform scale.
+    glm::mat3 normalTransform {};
+};
+
+/// @brief Maximum number of levels of detail for a submesh, the full detail included.
+constexpr uint32_t MaxSubmeshLods = 8;
+
+/// @brief Level of detail of a submesh, a range of the index buffer that shares the vertices with the others.
+struct SubmeshLod {
+    /// @brief First index in the index buffer.
+    uint32_t firstIndex { 0 };
+
+    /// @brief Indices count.
+    uint32_t indicesCount { 0 };
+
+    /// @brief Simplification error compared to the full detail, as a distance in the model space.
+    float error { 0.0f };
+};
+
 /// @brief Submesh data used to construct the mesh.
 struct Submesh {
     /// @brief Vertices count.
     uint32_t verticesCount { 0 };
 
-    /// @brief Vertex buffers.
-    std::vector<VertexBufferRef> vertexBuffers {};
-
-    /// @brief Vertex buffer ids.
-    std::vector<VertexBufferId> vertexBufferIds {};
-
-    /// @brief Vertex buffer offsets.
-    std::vector<uint64_t> vertexBufferOffsets {};
+    /// @brief Vertices range in the geometry pool, the first element is the base vertex.
+    GeometryRange vertices {};
 
     /// @brief Vertex buffers informations.
     std::vector<VertexBufferInfo> vertexBuffersInfo {};
@@ -39,14 +72,14 @@ struct Submesh {
     /// @brief Indices count.
     uint32_t indicesCount { 0 };
 
+    /// @brief Levels of detail, from the full detail to the coarsest.
+    std::vector<SubmeshLod> lods {};
+
     /// @brief Index type.
     IndexType indexType { IndexType::undefined };
 
-    /// @brief Index buffer.
-    IndexBufferRef indexBuffer {};
-
-    /// @brief Index buffer id.
-    IndexBufferId indexBufferId {};
+    /// @brief Indices range in the geometry pool, the first element is the first index.
+    GeometryRange indices {};
 
     /// @brief Material.
     MaterialRef material {};
@@ -56,6 +89,12 @@ struct Submesh {
 
     /// @brief Mesh bounding box.
     BoundingBox boundingBox {};
+
+    /// @brief True if the vertices are quantized.
+    bool quantized { false };
+
+    /// @brief Dequantization parameters, used when the vertices are quantized.
+    VertexDequantization dequantization {};
 };
 
 class Mesh;
@@ -66,11 +105,12 @@ class Mesh : private NonCopyable<Mesh> {
 protected:
     /// @brief Default constructor.
     /// @param submeshes Submeshes that compose the mesh.
-    explicit Mesh(const std::vector<Submesh>& submeshes);
+    /// @param instances Model transform of every instance.
+    explicit Mesh(const std::vector<Submesh>& submeshes, const std::vector<glm::mat4>& instances);
 
 public:
     /// @brief Destructor.
-    ~Mesh() = default;
+    ~Mesh();
 
     /// @brief Get the count of the submeshes that compose the mesh.
     /// @return Submesh count.
@@ -85,31 +125,13 @@ public:
         return _submeshes[submeshIndex].verticesCount;
     }
 
-    /// @brief Get the vertex buffers for a specific submesh.
-    /// @param submeshIndex Submesh index.
-    /// @return Vertex buffers.
-    [[nodiscard]] std::vector<VertexBufferRef> vertexBuffers(uint32_t submeshIndex) const
-    {
-        assert(_submeshes.size() > submeshIndex);
-        return _submeshes[submeshIndex].vertexBuffers;
-    }
-
-    /// @brief Get the vertex buffer ids for a specific submesh.
-    /// @param submeshIndex Submesh index.
-    /// @return Vertex buffer ids.
-    [[nodiscard]] std::vector<VertexBufferId> vertexBufferIds(uint32_t submeshIndex) const
-    {
-        assert(_submeshes.size() > submeshIndex);
-        return _submeshes[submeshIndex].vertexBufferIds;
-    }
-
-    /// @brief Get the vertex buffer offsets for a specific submesh.
+    /// @brief Get the vertices range in the geometry pool for a specific submesh.
     /// @param submeshIndex Submesh index.
-    /// @return Vertex buffer offsets.
-    [[nodiscard]] std::vector<uint64_t> vertexBufferOffsets(uint32_t submeshIndex) const
+    /// @return Vertices range, the first element is the base vertex.
+    [[nodiscard]] const GeometryRange& vertices(uint32_t submeshIndex) const
     {
         assert(_submeshes.size() > submeshIndex);
-        return _submeshes[submeshIndex].vertexBufferOffsets;
+        return _submeshes[submeshIndex].vertices;
     }
 
     /// @brief Get the vertex buffers informations for a specific submesh.
@@ -130,31 +152,31 @@ public:
         return _submeshes[submeshIndex].indicesCount;
     }
 
-    /// @brief Get the index type for a specific submesh.
+    /// @brief Get the levels of detail for a specific submesh.
     /// @param submeshIndex Submesh index.
-    /// @return Index type.
-    [[nodiscard]] IndexType indexType(uint32_t submeshIndex) const
+    /// @return Levels of detail, from the full detail to the coarsest.
+    [[nodiscard]] const std::vector<SubmeshLod>& lods(uint32_t submeshIndex) const
     {
         assert(_submeshes.size() > submeshIndex);
-        return _submeshes[submeshIndex].indexType;
+        return _submeshes[submeshIndex].lods;
     }
 
-    /// @brief Get the index buffer for a specific submesh.
+    /// @brief Get the index type for a specific submesh.
     /// @param submeshIndex Submesh index.
-    /// @return Index buffer.
-    [[nodiscard]] IndexBufferRef indexBuffer(uint32_t submeshIndex) const
+    /// @return Index type.
+    [[nodiscard]] IndexType indexType(uint32_t submeshIndex) const
     {
         assert(_submeshes.size() > submeshIndex);
-        return _submeshes[submeshIndex].indexBuffer;
+        return _submeshes[submeshIndex].indexType;
     }
 
-    /// @brief Get the index buffer id for a specific submesh.
+    /// @brief Get the indices range in the geometry pool for a specific submesh.
     /// @param submeshIndex Submesh index.
-    /// @return Index buffer id.
-    [[nodiscard]] IndexBufferId indexBufferId(uint32_t submeshIndex) const
+    /// @return Indices range, the first element is the first index.
+    [[nodiscard]] const GeometryRange& indices(uint32_t submeshIndex) const
     {
         assert(_submeshes.size() > submeshIndex);
-        return _submeshes[submeshIndex].indexBufferId;
+        return _submeshes[submeshIndex].indices;
     }
 
     /// @brief Get the material for a specific submesh.
@@ -175,13 +197,60 @@ public:
         return _submeshes[submeshIndex].pipeline;
     }
 
+    /// @brief Get the bounding box for a specific submesh.
+    /// @param submeshIndex Submesh index.
+    /// @return Bounding box.
+    [[nodiscard]] const BoundingBox& boundingBox(uint32_t submeshIndex) const
+    {
+        assert(_submeshes.size() > submeshIndex);
+        return _submeshes[submeshIndex].boundingBox;
+    }
+
+    /// @brief Check if the vertices of a specific submesh are quantized.
+    /// @param submeshIndex Submesh index.
+    /// @return True if the vertices are quantized.
+    [[nodiscard]] bool quantized(uint32_t submeshIndex) const
+    {
+        assert(_submeshes.size() > submeshIndex);
+        return _submeshes[submeshIndex].quantized;
+    }
+
+    /// @brief Get the dequantization parameters for a specific submesh.
+    /// @param submeshIndex Submesh index.
+    /// @return Dequantization parameters.
+    [[nodiscard]] const VertexDequantization& dequantization(uint32_t submeshIndex) const
+    {
+        assert(_submeshes.size() > submeshIndex);
+        return _submeshes[submeshIndex].dequantization;
+    }
+
+    /// @brief Get the instances count, every submesh is drawn once for every instance.
+    /// @return Instances count.
+    [[nodiscard]] uint32_t instancesCount() const { return static_cast<uint32_t>(_instances.size()); }
+
+    /// @brief Get the model transform of every instance, the same stored in the geometry pool.
+    /// @return Instance transforms.
+    [[nodiscard]] const std::vector<glm::mat4>& instances() const { return _instances; }
+
+    /// @brief Get the instance data range in the geometry pool, shared by all the submeshes.
+    /// @return Instances range, the first element is the first instance.
+    [[nodiscard]] const GeometryRange& instancesRange() const { return _instancesRange; }
+
+    /// @brief Get the layout of the per instance vertex buffer, bound after the vertices of every submesh.
+    /// @return Vertex buffer informations.
+    [[nodiscard]] static VertexBufferInfo instanceBufferInfo();
+
     /// @brief Factory for create a new mesh.
+    ///        The mesh owns the geometry pool ranges of the submeshes, they are freed with it.
     /// @param submeshes Submeshes that compose the mesh.
+    /// @param instances Model transform of every instance.
     /// @return The mesh.
-    [[nodiscard]] static MeshRef create(const std::vector<Submesh>& submeshes);
+    [[nodiscard]] static MeshRef create(const std::vector<Submesh>& submeshes, const std::vector<glm::mat4>& instances);
 
 private:
     std::vector<Submesh> _submeshes {}; ///< Submeshes that compose the mesh.
+    std::vector<glm::mat4> _instances {}; ///< Model transform of every instance.
+    GeometryRange _instancesRange {}; ///< Instance data in the geometry pool.
 };
 
 } // namespace chronicle
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "Assets/Material.h"
+#include "Assets/Mesh.h"
+#include "MeshOptimizer.h"
+#include "Storage/MappedFile.h"
+
+namespace chronicle {
+
+/// @brief Texture imported on the CPU, ready to be uploaded on the GPU.
+struct TextureData {
+    std::string name {}; ///< Texture name.
+    size_t hash { 0 }; ///< Texture loader hash.
+    uint64_t sourceSize { 0 }; ///< Size of the encoded image, checked with the hash by the texture loader.
+    SamplerInfo sampler {}; ///< Sampler state.
+    uint32_t width { 0 }; ///< Image width.
+    uint32_t height { 0 }; ///< Image height.
+    Format format { Format::R8G8B8A8Unorm }; ///< Image format.
+    std::vector<TextureMipLevel> mipLevels {}; ///< Mip levels in the pixels, empty if they must be generated.
+    std::span<const uint8_t> pixels {}; ///< Pixels, empty if the texture is already in cache.
+    TextureRef texture {}; ///< Cached texture, or texture created on first use.
+};
+
+/// @brief Material imported on the CPU, ready to be created.
+struct MaterialData {
+    std::string name {}; ///< Material name.
+    glm::vec4 baseColorFactor { 1.0f, 1.0f, 1.0f, 1.0f }; ///< The base color of the material.
+    float metallicFactor { 1.0f }; ///< The metalness of the material.
+    float roughnessFactor { 1.0f }; ///< The roughness of the material.
+    glm::vec3 emissiveFactor { 0.0f, 0.0f, 0.0f }; ///< The factors for the emissive color of the material.
+    AlphaMode alphaMode { AlphaMode::opaque }; ///< The alpha rendering mode of the material.
+    float alphaCutoff { 0.5f }; ///< The alpha cutoff value of the material.
+    bool doubleSided { false }; ///< Specifies whether the material is double sided.
+    int baseColorTexture { -1 }; ///< Base color texture index, negative if not available.
+    int metallicRoughnessTexture { -1 }; ///< Metallic-roughness texture index, negative if not available.
+    int normalTexture { -1 }; ///< Normal texture index, negative if not available.
+    int occlusionTexture { -1 }; ///< Occlusion texture index, negative if not available.
+    int emissiveTexture { -1 }; ///< Emissive texture index, negative if not available.
+};
+
+/// @brief Submesh converted on the CPU, ready to be uploaded on the GPU.
+struct SubmeshData {
+    std::string name {}; ///< Submesh name.
+    std::vector<uint8_t> vertexStorage {}; ///< Vertices owned by the submesh.
+    std::span<const uint8_t> vertexView {}; ///< Vertices stored elsewhere, used when the storage is empty.
+    uint32_t verticesCount { 0 }; ///< Vertices count.
+    VertexBufferInfo vertexBufferInfo {}; ///< Vertices layout.
+    BoundingBox boundingBox {}; ///< Submesh bounding box.
+    std::vector<uint8_t> indexStorage {}; ///< Indices owned by the submesh.
+    std::span<const uint8_t> indexView {}; ///< Indices stored elsewhere, used when the storage is empty.
+    uint32_t indicesCount { 0 }; ///< Indices count, of all the levels of detail.
+    std::vector<SubmeshLod> lods {}; ///< Levels of detail, empty if the indices are a single level.
+    IndexType indexType { IndexType::undefined }; ///< Index type.
+    int materialIndex { -1 }; ///< Material index, negative for the default material.
+    bool quantized { false }; ///< True if the positions are quantized in the bounding box.
+    bool valid { true }; ///< False if the submesh can't be imported.
+    ShaderRef shader {}; ///< Shader of the pipeline, loaded with the import and not cooked.
+    VertexCacheStatistics vertexCacheBefore {}; ///< Vertex cache statistics before the optimization.
+    VertexCacheStatistics vertexCacheAfter {}; ///< Vertex cache statistics after the optimization.
+
+    /// @brief Get the vertices data.
+    /// @return Vertices data.
+    [[nodiscard]] std::span<const uint8_t> vertices() const
+    {
+        return vertexStorage.empty() ? vertexView : std::span<const uint8_t>(vertexStorage);
+    }
+
+    /// @brief Get the indices data.
+    /// @return Indices data.
+    [[nodiscard]] std::span<const uint8_t> indices() const
+    {
+        return indexStorage.empty() ? indexView : std::span<const uint8_t>(indexStorage);
+    }
+};
+
+/// @brief Mesh converted on the CPU, ready to be uploaded on the GPU.
+struct MeshData {
+    std::string name {}; ///< Mesh name.
+    std::vector<SubmeshData> submeshes {}; ///< Converted submeshes.
+};
+
+/// @brief Node of the scene hierarchy, in depth first order so the parents come before their children.
+struct NodeData {
+    std::string name {}; ///< Node name.
+    int parent { -1 }; ///< Parent node index, negative for the root nodes.
+    int mesh { -1 }; ///< Mesh index, negative if the node doesn't place a mesh.
+    glm::mat4 localTransform { 1.0f }; ///< Transform relative to the parent.
+    glm::mat4 worldTransform { 1.0f }; ///< Transform relative to the asset.
+};
+
+/// @brief Asset imported on the CPU, from a glTF or a cooked file.
+struct AssetData {
+    std::vector<TextureData> textures {}; ///< Textures.
+    std::vector<MaterialData> materials {}; ///< Materials.
+    std::vector<MeshData> meshes {}; ///< Meshes.
+    std::vector<NodeData> nodes {}; ///< Nodes of the default scene.
+    tinygltf::Model model {}; ///< glTF model, it owns the buffers and the images not memory mapped.
+    std::vector<MappedFileRef> mappedFiles {}; ///< Memory mapped files that back the data.
+};
+
+} // namespace chronicle
@@ -3,11 +3,27 @@
 
 #include "AssetLoader.h"
 
+#include "AttributeConverter.h"
+#include "CookedAsset.h"
+#include "KtxTexture.h"
 #include "PipelineLoader.h"
 #include "ShaderLoader.h"
+#include "TextureLoader.h"
+
+#include <tinygltf/json.hpp>
 
 namespace chronicle {
 
+constexpr uint32_t GlbMagic = 0x46546C67; ///< "glTF"
+constexpr uint32_t GlbJsonChunk = 0x4E4F534A; ///< "JSON"
+constexpr uint32_t GlbBinaryChunk = 0x004E4942; ///< "BIN"
+
+/// @brief Placeholder for the buffers that are read from the memory mapped files.
+constexpr const char* PlaceholderBufferUri = "data:application/octet-stream;base64,AA==";
+
+/// @brief Placeholder for the images stored in buffer views, they are read from the memory mapped files.
+constexpr const char* PlaceholderImageUri = "data:image/png;base64,AA==";
+
 struct Vertex {
     glm::vec3 position {};
     glm::vec3 normal {};
@@ -16,17 +32,266 @@ struct Vertex {
     glm::vec4 color {};
 };
 
-AssetResult AssetLoader::load(const std::string& filename, const RenderPassRef& renderPass)
+/// @brief Worker threads used to import the assets loaded asynchronously.
+constexpr uint32_t AsyncImportThreads = 2;
+
+/// @brief State of the asynchronous loads.
+struct AssetLoaderContext {
+    static inline std::unique_ptr<ThreadPool> threadPool {}; ///< Workers that import the assets.
+    static inline std::vector<AssetLoadHandleRef> loads {}; ///< Loads not completed, used by the render thread.
+    static inline std::shared_ptr<ThreadPool> importPool {}; ///< Workers that decode the images and the primitives.
+    static inline uint32_t importPoolThreads { 0 }; ///< Thread count requested for the import pool.
+    static inline std::mutex importPoolMutex {}; ///< The pool is shared by the synchronous and asynchronous imports.
+};
+
+/// @brief Get the pool used by the parallel imports, created on the first use and kept for the next ones.
+/// @param threadCount Number of worker threads, 0 to use the hardware concurrency.
+/// @return Import pool.
+static std::shared_ptr<ThreadPool> getImportPool(uint32_t threadCount)
+{
+    std::scoped_lock<std::mutex> lock(AssetLoaderContext::importPoolMutex);
+
+    // a different thread count replaces the pool, the imports running on the old one keep it alive
+    if (!AssetLoaderContext::importPool || AssetLoaderContext::importPoolThreads != threadCount) {
+        AssetLoaderContext::importPool = std::make_shared<ThreadPool>(threadCount);
+        AssetLoaderContext::importPoolThreads = threadCount;
+    }
+    return AssetLoaderContext::importPool;
+}
+
+/// @brief Image decoded on the CPU, the pixels are stored in the glTF image.
+struct DecodedImage {
+    Format format { Format::R8G8B8A8Unorm }; ///< Image format.
+    std::vector<TextureMipLevel> mipLevels {}; ///< Pre-baked mip levels, empty if they must be generated.
+};
+
+/// @brief Data of the glTF buffers, owned by tinygltf or memory mapped.
+struct AssetBuffers {
+    std::vector<MappedFileRef> mappedFiles {}; ///< Memory mapped files that back the buffers.
+    std::vector<std::span<const uint8_t>> buffers {}; ///< Data for every glTF buffer.
+};
+
+AssetResult AssetLoader::load(
+    const std::string& filename, const RenderPassRef& renderPass, const AssetLoaderOptions& options)
 {
-    tinygltf::Model model;
+    CHRZONE_ASSETS;
+
+    CHRLOG_DEBUG("Load mesh: {}", filename);
+
+    AssetData assetData = {};
+    if (!importAsset(filename, options, assetData)) {
+        return {};
+    }
+
+    return createAsset(assetData, renderPass);
+}
+
+AssetLoadHandleRef AssetLoader::loadAsync(
+    const std::string& filename, const RenderPassRef& renderPass, const AssetLoaderOptions& options)
+{
+    CHRZONE_ASSETS;
+
+    CHRLOG_DEBUG("Load mesh asynchronously: {}", filename);
+
+    auto handle = std::make_shared<AssetLoadHandle>();
+    handle->_filename = filename;
+    handle->_renderPass = renderPass;
+    handle->_options = options;
+
+    if (!AssetLoaderContext::threadPool) {
+        AssetLoaderContext::threadPool = std::make_unique<ThreadPool>(AsyncImportThreads);
+    }
+
+    // the handle state reports the result, the future is not needed
+    (void)AssetLoaderContext::threadPool->submit([handle]() {
+        try {
+            auto imported = importAsset(handle->_filename, handle->_options, handle->_assetData);
+
+            // the shaders are compiled here, the poll only creates the GPU resources
+            if (imported) {
+                loadShaders(handle->_assetData);
+            }
+            handle->_state.store(imported ? AssetLoadState::uploading : AssetLoadState::failed,
+                std::memory_order_release);
+        } catch (const std::exception& error) {
+            CHRLOG_ERROR("Failed to load {}: {}", handle->_filename, error.what());
+            handle->_assetData = {};
+            handle->_state.store(AssetLoadState::failed, std::memory_order_release);
+        }
+    });
+
+    AssetLoaderContext::loads.push_back(handle);
+    return handle;
+}
+
+void AssetLoader::poll(uint64_t uploadBudget)
+{
+    CHRZONE_ASSETS;
+
+    // the budget is shared by the loads, in the order they are started
+    auto& loads = AssetLoaderContext::loads;
+    for (auto it = loads.begin(); it != loads.end();) {
+        auto& handle = **it;
+        auto state = handle.state();
+        if (state == AssetLoadState::importing) {
+            ++it;
+            continue;
+        }
+
+        if (state == AssetLoadState::uploading) {
+            if (uploadBudget == 0 || !uploadAsset(handle, uploadBudget)) {
+                ++it;
+                continue;
+            }
+
+            // the load is completed when the last pipelines are ready
+            if (!std::ranges::all_of(handle._pipelineBatches, [](const auto& batch) { return batch->done(); })) {
+                ++it;
+                continue;
+            }
+            auto pipelinesFailed
+                = std::ranges::any_of(handle._pipelineBatches, [](const auto& batch) { return batch->failed(); });
+            handle._pipelineBatches.clear();
+
+            // the meshes own their resources, the imported data is not needed anymore
+            handle._assetData = {};
+            handle._materials.clear();
+            if (pipelinesFailed) {
+                // the meshes release the pipelines already created with the other resources
+                CHRLOG_ERROR("Failed to create the pipelines of {}", handle._filename);
+                handle._result = {};
+                handle._defaultMaterial = nullptr;
+                handle._state.store(AssetLoadState::failed, std::memory_order_release);
+            } else {
+                handle._state.store(AssetLoadState::ready, std::memory_order_release);
+                CHRLOG_DEBUG("Mesh loaded: {}", handle._filename);
+            }
+        }
+
+        it = loads.erase(it);
+    }
+}
+
+void AssetLoader::deinit()
+{
+    CHRZONE_ASSETS;
+
+    // the pool waits the queued imports before joining the workers
+    AssetLoaderContext::threadPool.reset();
+    AssetLoaderContext::importPool.reset();
+
+    for (const auto& handle : AssetLoaderContext::loads) {
+        handle->_pipelineBatches.clear();
+        handle->_assetData = {};
+        handle->_materials.clear();
+        handle->_state.store(AssetLoadState::failed, std::memory_order_release);
+    }
+    AssetLoaderContext::loads.clear();
+
+    PipelineLoader::deinit();
+    ShaderLoader::clear();
+}
+
+bool AssetLoader::cook(
+    const std::string& filename, const std::filesystem::path& cookedFilename, const AssetLoaderOptions& options)
+{
+    CHRZONE_ASSETS;
+
+    CHRLOG_DEBUG("Cook mesh: {}", filename);
+
+    AssetData assetData = {};
+    if (!importGltf(filename, options, true, assetData)) {
+        return false;
+    }
+
+    try {
+        CookedAsset::write(cookedFilename, assetData, CookedAssetSource::fromFile(filename, cookOptionsHash(options)));
+    } catch (const std::exception& error) {
+        CHRLOG_ERROR("Failed to cook {}: {}", filename, error.what());
+        return false;
+    }
+
+    return true;
+}
+
+AssetResult AssetLoader::loadCooked(const std::filesystem::path& cookedFilename, const RenderPassRef& renderPass)
+{
+    CHRZONE_ASSETS;
+
+    CHRLOG_DEBUG("Load cooked mesh: {}", cookedFilename.string());
+
+    AssetData assetData = {};
+    if (!CookedAsset::read(cookedFilename, assetData)) {
+        CHRLOG_ERROR("Failed to load cooked mesh {}", cookedFilename.string());
+        return {};
+    }
+
+    return createAsset(assetData, renderPass);
+}
+
+bool AssetLoader::importAsset(const std::string& filename, const AssetLoaderOptions& options, AssetData& assetData)
+{
+    CHRZONE_ASSETS;
+
+    // use the cooked copy if it's up to date
+    std::filesystem::path cookedFilename = {};
+    CookedAssetSource source = {};
+    if (!options.cookedCacheDirectory.empty()) {
+        cookedFilename = CookedAsset::cacheFilename(filename, options.cookedCacheDirectory);
+        source = CookedAssetSource::fromFile(filename, cookOptionsHash(options));
+        if (CookedAsset::read(cookedFilename, assetData, source)) {
+            return true;
+        }
+    }
+
+    // the cooked asset needs all the images, also the ones already in the texture cache
+    if (!importGltf(filename, options, !cookedFilename.empty(), assetData)) {
+        return false;
+    }
+
+    if (!cookedFilename.empty()) {
+        try {
+            CookedAsset::write(cookedFilename, assetData, source);
+        } catch (const std::exception& error) {
+            CHRLOG_WARN("Failed to cook {}: {}", filename, error.what());
+        }
+    }
+
+    return true;
+}
+
+bool AssetLoader::importGltf(
+    const std::string& filename, const AssetLoaderOptions& options, bool decodeAllImages, AssetData& assetData)
+{
+    CHRZONE_ASSETS;
+
+    auto& model = assetData.model;
     tinygltf::TinyGLTF loader;
     std::string err;
     std::string warn;
 
-    CHRLOG_DEBUG("Load mesh: {}", filename);
+    auto extension = std::filesystem::path(filename).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    auto binary = extension == ".glb";
+
+    // keep the images encoded, they are decoded later (by the worker threads in parallel mode)
+    loader.SetImageLoader(storeImageData, nullptr);
 
-    bool ret = loader.LoadASCIIFromFile(&model, &err, &warn, filename.c_str());
-    // bool ret = loader.LoadBinaryFromFile(&model, &err, &warn, argv[1]); // for binary glTF(.glb)
+    std::shared_ptr<ThreadPool> threadPool {};
+    if (options.parallel) {
+        threadPool = getImportPool(options.threadCount);
+    }
+
+    AssetBuffers buffers = {};
+    bool ret = false;
+    if (options.mapBuffers) {
+        ret = loadMapped(loader, model, filename, binary, buffers, err, warn);
+    } else if (binary) {
+        ret = loader.LoadBinaryFromFile(&model, &err, &warn, filename.c_str());
+    } else {
+        ret = loader.LoadASCIIFromFile(&model, &err, &warn, filename.c_str());
+    }
 
     if (!warn.empty()) {
         printf("Warn: %s\n", warn.c_str());
@@ -38,27 +303,328 @@ AssetResult AssetLoader::load(const std::string& filename, const RenderPassRef&
 
     if (!ret) {
         printf("Failed to parse glTF\n");
-        return {};
+        return false;
     }
 
-    AssetResult result = {};
-    std::vector<MaterialRef> materials = {};
-    materials.reserve(model.materials.size());
+    // the mapped files must live as long as the data that reference them
+    assetData.mappedFiles = std::move(buffers.mappedFiles);
 
-    auto defaultMaterial = Material::create("Default material");
+    // the buffers not mapped are owned by tinygltf
+    buffers.buffers.resize(model.buffers.size());
+    for (size_t bufferIndex = 0; bufferIndex < model.buffers.size(); bufferIndex++) {
+        if (buffers.buffers[bufferIndex].data() == nullptr) {
+            buffers.buffers[bufferIndex] = model.buffers[bufferIndex].data;
+        }
+    }
 
-    // create materials
+    // collect the primitives to convert
+    assetData.meshes.resize(model.meshes.size());
+    std::vector<std::pair<uint32_t, uint32_t>> primitives {};
+    for (uint32_t meshIndex = 0; meshIndex < static_cast<uint32_t>(model.meshes.size()); meshIndex++) {
+        const auto& gltfMesh = model.meshes[meshIndex];
+        assetData.meshes[meshIndex].name = gltfMesh.name;
+        assetData.meshes[meshIndex].submeshes.resize(gltfMesh.primitives.size());
+        for (uint32_t primitiveIndex = 0; primitiveIndex < static_cast<uint32_t>(gltfMesh.primitives.size());
+             primitiveIndex++) {
+            primitives.emplace_back(meshIndex, primitiveIndex);
+        }
+    }
+
+    // hash the image sources, the textures are shared across materials and loads
+    auto basePath = std::filesystem::path(filename).parent_path();
+    std::vector<size_t> imageHashes(model.images.size());
+    auto imageCookOptions = options.cookMipmaps ? getImageCookOptions(model) : std::vector<TextureCookOptions>();
+    auto hashImageJob = [&model, &basePath, &imageHashes, &imageCookOptions](size_t index) {
+        imageHashes[index] = hashImageSource(model.images[index], basePath);
+        if (!imageCookOptions.empty()) {
+            std::hash_combine(imageHashes[index], imageCookOptions[index]);
+        }
+    };
+
+    if (threadPool) {
+        threadPool->parallelFor(model.images.size(), hashImageJob);
+    } else {
+        for (size_t index = 0; index < model.images.size(); index++) {
+            hashImageJob(index);
+        }
+    }
+
+    // get the textures already in cache, only the missing ones need to be decoded
+    assetData.textures.resize(model.textures.size());
+    std::vector<bool> requiredImages(model.images.size(), false);
+    for (size_t textureIndex = 0; textureIndex < model.textures.size(); textureIndex++) {
+        const auto& gltfTexture = model.textures[textureIndex];
+        auto& textureData = assetData.textures[textureIndex];
+        textureData.name = gltfTexture.name;
+        auto imageIndex = getTextureSource(gltfTexture);
+        if (imageIndex < 0 || imageIndex >= static_cast<int>(model.images.size())) {
+            continue;
+        }
+
+        textureData.sampler = getSamplerInfo(model, gltfTexture.sampler);
+        textureData.hash = TextureLoader::hash(imageHashes[imageIndex], textureData.sampler);
+        textureData.sourceSize = model.images[imageIndex].image.size();
+        textureData.texture = TextureLoader::get(textureData.hash, textureData.sourceSize);
+        if (decodeAllImages || !textureData.texture) {
+            requiredImages[imageIndex] = true;
+        }
+    }
+
+    // decode the images and convert the primitives (CPU only, every job writes only his own slot)
+    std::vector<DecodedImage> decodedImages(model.images.size());
+    auto decodeImageJob = [&model, &requiredImages, &decodedImages, &imageCookOptions](size_t index) {
+        if (requiredImages[index]) {
+            auto cookOptions = imageCookOptions.empty() ? std::optional<TextureCookOptions>()
+                                                        : std::optional<TextureCookOptions>(imageCookOptions[index]);
+            decodeImage(model.images[index], cookOptions, decodedImages[index]);
+        }
+    };
+    auto convertPrimitiveJob = [&model, &buffers, &assetData, &primitives, &options](size_t index) {
+        const auto& [meshIndex, primitiveIndex] = primitives[index];
+        assetData.meshes[meshIndex].submeshes[primitiveIndex]
+            = convertPrimitive(model, buffers, model.meshes[meshIndex], primitiveIndex, options);
+    };
+
+    if (threadPool) {
+        threadPool->parallelFor(model.images.size(), decodeImageJob);
+        threadPool->parallelFor(primitives.size(), convertPrimitiveJob);
+    } else {
+        for (size_t index = 0; index < model.images.size(); index++) {
+            decodeImageJob(index);
+        }
+        for (size_t index = 0; index < primitives.size(); index++) {
+            convertPrimitiveJob(index);
+        }
+    }
+
+    // vertex cache statistics for the optimized submeshes
+    if (options.optimizeMeshes) {
+        uint64_t trianglesCount = 0;
+        uint64_t verticesTransformedBefore = 0;
+        uint64_t verticesTransformedAfter = 0;
+        for (const auto& meshData : assetData.meshes) {
+            for (const auto& submeshData : meshData.submeshes) {
+                if (submeshData.vertexCacheBefore.verticesTransformed > 0) {
+                    trianglesCount += submeshData.vertexCacheBefore.trianglesCount;
+                    verticesTransformedBefore += submeshData.vertexCacheBefore.verticesTransformed;
+                    verticesTransformedAfter += submeshData.vertexCacheAfter.verticesTransformed;
+                }
+            }
+        }
+
+        if (trianglesCount > 0) {
+            CHRLOG_INFO("Mesh optimization for {}: ACMR {:.3f} -> {:.3f}", filename,
+                static_cast<double>(verticesTransformedBefore) / static_cast<double>(trianglesCount),
+                static_cast<double>(verticesTransformedAfter) / static_cast<double>(trianglesCount));
+        }
+    }
+
+    // the decoded pixels are owned by the glTF model
+    for (size_t textureIndex = 0; textureIndex < model.textures.size(); textureIndex++) {
+        auto imageIndex = getTextureSource(model.textures[textureIndex]);
+        if (imageIndex < 0 || imageIndex >= static_cast<int>(model.images.size())) {
+            continue;
+        }
+
+        const auto& gltfImage = model.images[imageIndex];
+        if (gltfImage.width <= 0 || gltfImage.height <= 0 || gltfImage.image.empty()) {
+            continue;
+        }
+
+        auto& textureData = assetData.textures[textureIndex];
+        textureData.width = static_cast<uint32_t>(gltfImage.width);
+        textureData.height = static_cast<uint32_t>(gltfImage.height);
+        textureData.pixels = gltfImage.image;
+        textureData.format = decodedImages[imageIndex].format;
+        textureData.mipLevels = decodedImages[imageIndex].mipLevels;
+    }
+
+    // get the materials
+    assetData.materials.reserve(model.materials.size());
     for (const auto& gltfMaterial : model.materials) {
-        auto material = createMaterial(model, gltfMaterial);
-        materials.push_back(std::move(material));
+        assetData.materials.push_back(getMaterialData(gltfMaterial));
     }
 
-    // create meshes
-    for (const auto& gltfMesh : model.meshes) {
-        result.meshes.push_back(createMesh(model, gltfMesh, materials, defaultMaterial, renderPass));
+    // get the node hierarchy
+    assetData.nodes = getNodes(model);
+
+    return true;
+}
+
+uint64_t AssetLoader::cookOptionsHash(const AssetLoaderOptions& options)
+{
+    // only the options that change the imported data, the others change only how it's imported
+    std::size_t hash = 0;
+    std::hash_combine(hash, options.quantizeVertices, options.optimizeMeshes, options.lodCount, options.uint8Indices,
+        options.cookMipmaps);
+    if (options.lodCount > 0) {
+        std::hash_combine(hash, options.lodReduction, options.lodMaxError);
     }
+    return hash;
+}
 
-    return result;
+bool AssetLoader::loadMapped(tinygltf::TinyGLTF& loader, tinygltf::Model& gltfModel, const std::string& filename,
+    bool binary, AssetBuffers& buffers, std::string& err, std::string& warn)
+{
+    CHRZONE_ASSETS;
+
+    auto basePath = std::filesystem::path(filename).parent_path();
+
+    MappedFileRef mappedFile = {};
+    try {
+        mappedFile = MappedFile::open(filename);
+    } catch (const StorageError& error) {
+        err = error.what();
+        return false;
+    }
+    buffers.mappedFiles.push_back(mappedFile);
+
+    // get the json and the binary chunk
+    auto json = mappedFile->span();
+    std::span<const uint8_t> binaryChunk = {};
+    if (binary) {
+        auto readUint32 = [&mappedFile](size_t offset) {
+            uint32_t value = 0;
+            std::memcpy(&value, mappedFile->data() + offset, sizeof(uint32_t));
+            return value;
+        };
+
+        if (mappedFile->size() < 20 || readUint32(0) != GlbMagic || readUint32(4) != 2) {
+            err = fmt::format("Invalid binary glTF header in {}", filename);
+            return false;
+        }
+
+        auto length = std::min(static_cast<size_t>(readUint32(8)), mappedFile->size());
+        auto jsonLength = static_cast<size_t>(readUint32(12));
+        if (readUint32(16) != GlbJsonChunk || 20 + jsonLength > length) {
+            err = fmt::format("Invalid JSON chunk in {}", filename);
+            return false;
+        }
+        json = mappedFile->span().subspan(20, jsonLength);
+
+        auto binaryOffset = 20 + jsonLength;
+        if (binaryOffset + 8 <= length && readUint32(binaryOffset + 4) == GlbBinaryChunk) {
+            auto binaryLength = std::min(static_cast<size_t>(readUint32(binaryOffset)), length - binaryOffset - 8);
+            binaryChunk = mappedFile->span().subspan(binaryOffset + 8, binaryLength);
+        }
+    }
+
+    auto document = nlohmann::json::parse(json.begin(), json.end(), nullptr, false);
+    if (document.is_discarded()) {
+        err = fmt::format("Failed to parse the JSON in {}", filename);
+        return false;
+    }
+
+    // map the buffers and replace them with a tiny placeholder, so tinygltf doesn't read them
+    if (document.contains("buffers")) {
+        auto& gltfBuffers = document["buffers"];
+        buffers.buffers.resize(gltfBuffers.size());
+        for (size_t bufferIndex = 0; bufferIndex < gltfBuffers.size(); bufferIndex++) {
+            auto& gltfBuffer = gltfBuffers[bufferIndex];
+            auto byteLength = gltfBuffer.value("byteLength", static_cast<size_t>(0));
+
+            std::span<const uint8_t> data = {};
+            if (!gltfBuffer.contains("uri")) {
+                // the first buffer without uri reference the binary chunk
+                data = binaryChunk;
+            } else {
+                auto uri = gltfBuffer["uri"].get<std::string>();
+
+                // embedded buffers are decoded by tinygltf
+                if (uri.starts_with("data:")) {
+                    continue;
+                }
+
+                try {
+                    auto bufferFile = MappedFile::open(basePath / decodeUri(uri));
+                    data = bufferFile->span();
+                    buffers.mappedFiles.push_back(std::move(bufferFile));
+                } catch (const StorageError& error) {
+                    err = error.what();
+                    return false;
+                }
+            }
+
+            if (data.size() < byteLength) {
+                err = fmt::format("Buffer {} is smaller than the declared size in {}", bufferIndex, filename);
+                return false;
+            }
+
+            buffers.buffers[bufferIndex] = data.first(byteLength);
+            gltfBuffer["uri"] = PlaceholderBufferUri;
+            gltfBuffer["byteLength"] = 1;
+        }
+    }
+
+    // images stored in buffer views would be read from the placeholders
+    std::vector<std::pair<size_t, size_t>> bufferViewImages = {};
+    if (document.contains("images")) {
+        auto& gltfImages = document["images"];
+        for (size_t imageIndex = 0; imageIndex < gltfImages.size(); imageIndex++) {
+            auto& gltfImage = gltfImages[imageIndex];
+            if (gltfImage.contains("bufferView")) {
+                bufferViewImages.emplace_back(imageIndex, gltfImage["bufferView"].get<size_t>());
+                gltfImage.erase("bufferView");
+                gltfImage["uri"] = PlaceholderImageUri;
+            }
+        }
+    }
+
+    auto patchedJson = document.dump();
+    if (!loader.LoadASCIIFromString(&gltfModel, &err, &warn, patchedJson.c_str(),
+            static_cast<unsigned int>(patchedJson.size()), basePath.string())) {
+        return false;
+    }
+
+    // the embedded buffers are owned by tinygltf
+    for (size_t bufferIndex = 0; bufferIndex < buffers.buffers.size(); bufferIndex++) {
+        if (buffers.buffers[bufferIndex].data() == nullptr) {
+            buffers.buffers[bufferIndex] = gltfModel.buffers[bufferIndex].data;
+        }
+    }
+
+    // copy the encoded images from the mapped buffers
+    for (const auto& [imageIndex, bufferViewIndex] : bufferViewImages) {
+        if (bufferViewIndex >= gltfModel.bufferViews.size()) {
+            err = fmt::format("Invalid buffer view for image {} in {}", imageIndex, filename);
+            return false;
+        }
+
+        const auto& bufferView = gltfModel.bufferViews[bufferViewIndex];
+        const auto& buffer = buffers.buffers[bufferView.buffer];
+        if (bufferView.byteOffset + bufferView.byteLength > buffer.size()) {
+            err = fmt::format("Invalid buffer view for image {} in {}", imageIndex, filename);
+            return false;
+        }
+
+        auto& gltfImage = gltfModel.images[imageIndex];
+        auto data = buffer.subspan(bufferView.byteOffset, bufferView.byteLength);
+        gltfImage.image.assign(data.begin(), data.end());
+        gltfImage.width = -1;
+        gltfImage.height = -1;
+        gltfImage.bufferView = static_cast<int>(bufferViewIndex);
+        gltfImage.uri.clear();
+    }
+
+    return true;
+}
+
+std::string AssetLoader::decodeUri(const std::string& uri)
+{
+    std::string decoded = {};
+    decoded.reserve(uri.size());
+
+    for (size_t i = 0; i < uri.size(); i++) {
+        if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit(static_cast<unsigned char>(uri[i + 1]))
+            && std::isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+            decoded.push_back(static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16)));
+            i += 2;
+        } else {
+            decoded.push_back(uri[i]);
+        }
+    }
+
+    return decoded;
 }
 
 Format AssetLoader::getAttributeFormat(const tinygltf::Accessor& accessor)
@@ -69,7 +635,11 @@ Format AssetLoader::getAttributeFormat(const tinygltf::Accessor& accessor)
             = { { TINYGLTF_TYPE_SCALAR, Format::R8Sint }, { TINYGLTF_TYPE_VEC2, Format::R8G8Sint },
                   { TINYGLTF_TYPE_VEC3, Format::R8G8B8Sint }, { TINYGLTF_TYPE_VEC4, Format::R8G8B8A8Sint } };
 
-        return mappedFormat.at(accessor.type);
+        static const std::map<int, Format> mappedFormatNormalize
+            = { { TINYGLTF_TYPE_SCALAR, Format::R8Snorm }, { TINYGLTF_TYPE_VEC2, Format::R8G8Snorm },
+                  { TINYGLTF_TYPE_VEC3, Format::R8G8B8Snorm }, { TINYGLTF_TYPE_VEC4, Format::R8G8B8A8Snorm } };
+
+        return accessor.normalized ? mappedFormatNormalize.at(accessor.type) : mappedFormat.at(accessor.type);
     }
     case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE: {
         static const std::map<int, Format> mappedFormat
@@ -87,7 +657,11 @@ Format AssetLoader::getAttributeFormat(const tinygltf::Accessor& accessor)
             = { { TINYGLTF_TYPE_SCALAR, Format::R16Sint }, { TINYGLTF_TYPE_VEC2, Format::R16G16Sint },
                   { TINYGLTF_TYPE_VEC3, Format::R16G16B16Sint }, { TINYGLTF_TYPE_VEC4, Format::R16G16B16A16Sint } };
 
-        return mappedFormat.at(accessor.type);
+        static const std::map<int, Format> mappedFormatNormalize
+            = { { TINYGLTF_TYPE_SCALAR, Format::R16Snorm }, { TINYGLTF_TYPE_VEC2, Format::R16G16Snorm },
+                  { TINYGLTF_TYPE_VEC3, Format::R16G16B16Snorm }, { TINYGLTF_TYPE_VEC4, Format::R16G16B16A16Snorm } };
+
+        return accessor.normalized ? mappedFormatNormalize.at(accessor.type) : mappedFormat.at(accessor.type);
     }
     case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
         static const std::map<int, Format> mappedFormat
@@ -129,6 +703,8 @@ Format AssetLoader::getAttributeFormat(const tinygltf::Accessor& accessor)
 IndexType AssetLoader::getIndexType(Format format)
 {
     switch (format) {
+    case chronicle::Format::R8Uint:
+        return IndexType::uint8;
     case chronicle::Format::R16Uint:
         return IndexType::uint16;
     case chronicle::Format::R32Uint:
@@ -186,45 +762,678 @@ uint32_t AssetLoader::getLocationFromAttributeType(AttributeType attributeType)
     return 0;
 }
 
-TextureRef AssetLoader::createTexture(const tinygltf::Model& gltfModel, uint32_t textureIndex)
+SamplerInfo AssetLoader::getSamplerInfo(const tinygltf::Model& gltfModel, int samplerIndex)
+{
+    SamplerInfo samplerInfo = {};
+    if (samplerIndex < 0 || samplerIndex >= static_cast<int>(gltfModel.samplers.size())) {
+        return samplerInfo;
+    }
+
+    auto getAddressMode = [](int wrap) {
+        switch (wrap) {
+        case TINYGLTF_TEXTURE_WRAP_CLAMP_TO_EDGE:
+            return SamplerAddressMode::clampToEdge;
+        case TINYGLTF_TEXTURE_WRAP_MIRRORED_REPEAT:
+            return SamplerAddressMode::mirroredRepeat;
+        default:
+            return SamplerAddressMode::repeat;
+        }
+    };
+
+    const auto& gltfSampler = gltfModel.samplers[samplerIndex];
+    if (gltfSampler.magFilter == TINYGLTF_TEXTURE_FILTER_NEAREST) {
+        samplerInfo.magFilter = Filter::nearest;
+    }
+
+    // the filters without a mipmap mode sample only the first level
+    switch (gltfSampler.minFilter) {
+    case TINYGLTF_TEXTURE_FILTER_NEAREST:
+        samplerInfo.minFilter = Filter::nearest;
+        samplerInfo.mipmapMode = SamplerMipmapMode::nearest;
+        samplerInfo.mipmaps = false;
+        break;
+    case TINYGLTF_TEXTURE_FILTER_LINEAR:
+        samplerInfo.mipmapMode = SamplerMipmapMode::nearest;
+        samplerInfo.mipmaps = false;
+        break;
+    case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_NEAREST:
+        samplerInfo.minFilter = Filter::nearest;
+        samplerInfo.mipmapMode = SamplerMipmapMode::nearest;
+        break;
+    case TINYGLTF_TEXTURE_FILTER_NEAREST_MIPMAP_LINEAR:
+        samplerInfo.minFilter = Filter::nearest;
+        break;
+    case TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_NEAREST:
+        samplerInfo.mipmapMode = SamplerMipmapMode::nearest;
+        break;
+    default:
+        break;
+    }
+
+    samplerInfo.addressModeU = getAddressMode(gltfSampler.wrapS);
+    samplerInfo.addressModeV = getAddressMode(gltfSampler.wrapT);
+    return samplerInfo;
+}
+
+int AssetLoader::getTextureSource(const tinygltf::Texture& gltfTexture)
+{
+    // the KHR_texture_basisu image can't be transcoded, the source is the fallback for the loaders without it
+    return gltfTexture.source;
+}
+
+size_t AssetLoader::hashImageSource(const tinygltf::Image& gltfImage, const std::filesystem::path& basePath)
+{
+    CHRZONE_ASSETS;
+
+    // external images are identified by path, the embedded ones by content
+    if (!gltfImage.uri.empty() && !gltfImage.uri.starts_with("data:")) {
+        auto path = std::filesystem::absolute(basePath / decodeUri(gltfImage.uri)).lexically_normal();
+        return std::hash<std::string>()(path.generic_string());
+    }
+
+    return std::hash<std::string_view>()(
+        std::string_view(std::bit_cast<const char*>(gltfImage.image.data()), gltfImage.image.size()));
+}
+
+bool AssetLoader::storeImageData(tinygltf::Image* image, [[maybe_unused]] const int imageIndex,
+    [[maybe_unused]] std::string* err, [[maybe_unused]] std::string* warn, [[maybe_unused]] int reqWidth,
+    [[maybe_unused]] int reqHeight, const unsigned char* bytes, int size, [[maybe_unused]] void* userData)
+{
+    // store the encoded data, the image is decoded by decodeImage
+    image->image.assign(bytes, bytes + size);
+    image->width = -1;
+    image->height = -1;
+    return true;
+}
+
+void AssetLoader::decodeImage(
+    tinygltf::Image& gltfImage, const std::optional<TextureCookOptions>& cookOptions, DecodedImage& decodedImage)
+{
+    CHRZONE_ASSETS;
+
+    // already decoded or without data
+    if (gltfImage.width > 0 || gltfImage.image.empty()) {
+        return;
+    }
+
+    // the KTX2 images are already compressed
+    if (KtxTexture::isKtx2(gltfImage.image)) {
+        KtxTextureData textureData = {};
+        if (!KtxTexture::read(gltfImage.image, textureData)) {
+            CHRLOG_ERROR("Failed to read KTX2 image {}", gltfImage.name);
+            gltfImage.image.clear();
+            return;
+        }
+
+        gltfImage.width = static_cast<int>(textureData.width);
+        gltfImage.height = static_cast<int>(textureData.height);
+        gltfImage.image = std::move(textureData.data);
+        decodedImage.format = textureData.format;
+        decodedImage.mipLevels = std::move(textureData.mipLevels);
+        return;
+    }
+
+    int width = 0;
+    int height = 0;
+    int components = 0;
+    auto* pixels = stbi_load_from_memory(gltfImage.image.data(), static_cast<int>(gltfImage.image.size()), &width,
+        &height, &components, STBI_rgb_alpha);
+    if (pixels == nullptr) {
+        CHRLOG_ERROR("Failed to decode image {}: {}", gltfImage.name, stbi_failure_reason());
+        gltfImage.image.clear();
+        return;
+    }
+
+    gltfImage.width = width;
+    gltfImage.height = height;
+    gltfImage.component = STBI_rgb_alpha;
+    gltfImage.bits = 8;
+    gltfImage.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+
+    // the levels follow the first one in the image data
+    auto pixelsSize = static_cast<size_t>(width) * height * STBI_rgb_alpha;
+    if (cookOptions.has_value()) {
+        KtxTextureData textureData = {};
+        TextureCooker::generateMipChain(std::span(pixels, pixelsSize), static_cast<uint32_t>(width),
+            static_cast<uint32_t>(height), cookOptions.value(), textureData);
+        gltfImage.image = std::move(textureData.data);
+        decodedImage.mipLevels = std::move(textureData.mipLevels);
+    } else {
+        gltfImage.image.assign(pixels, pixels + pixelsSize);
+    }
+
+    stbi_image_free(pixels);
+}
+
+std::vector<TextureCookOptions> AssetLoader::getImageCookOptions(const tinygltf::Model& gltfModel)
+{
+    std::vector<TextureCookOptions> imageCookOptions(gltfModel.images.size());
+    auto getImage = [&gltfModel, &imageCookOptions](int textureIndex) -> TextureCookOptions* {
+        if (textureIndex < 0 || textureIndex >= static_cast<int>(gltfModel.textures.size())) {
+            return nullptr;
+        }
+        auto imageIndex = getTextureSource(gltfModel.textures[textureIndex]);
+        if (imageIndex < 0 || imageIndex >= static_cast<int>(gltfModel.images.size())) {
+            return nullptr;
+        }
+        return &imageCookOptions[imageIndex];
+    };
+
+    // the base color and emissive textures are sRGB, the others are data
+    for (const auto& gltfMaterial : gltfModel.materials) {
+        auto materialData = getMaterialData(gltfMaterial);
+        if (auto* cookOptions = getImage(materialData.baseColorTexture)) {
+            cookOptions->srgb = true;
+            if (materialData.alphaMode == AlphaMode::mask) {
+                cookOptions->alphaCutoff = materialData.alphaCutoff;
+            }
+        }
+        if (auto* cookOptions = getImage(materialData.emissiveTexture)) {
+            cookOptions->srgb = true;
+        }
+    }
+
+    return imageCookOptions;
+}
+
+SubmeshData AssetLoader::convertPrimitive(const tinygltf::Model& gltfModel, const AssetBuffers& buffers,
+    const tinygltf::Mesh& gltfMesh, uint32_t primitiveIndex, const AssetLoaderOptions& options)
+{
+    CHRZONE_ASSETS;
+
+    const tinygltf::Primitive& gltfPrimitive = gltfMesh.primitives[primitiveIndex];
+
+    SubmeshData submeshData = {};
+    submeshData.name = fmt::format("'{}' mesh, primitive #{}", gltfMesh.name, primitiveIndex);
+    submeshData.materialIndex = gltfPrimitive.material;
+    CHRLOG_DEBUG("{}", submeshData.name);
+
+    uint32_t verticesCount = 0;
+
+    const unsigned char* positionBuffer = nullptr;
+    const unsigned char* normalBuffer = nullptr;
+    const unsigned char* texCoord0Buffer = nullptr;
+    const unsigned char* texCoord1Buffer = nullptr;
+    const unsigned char* colorBuffer = nullptr;
+
+    uint32_t positionStride = 0;
+    uint32_t normalStride = 0;
+    uint32_t texCoord0Stride = 0;
+    uint32_t texCoord1Stride = 0;
+    uint32_t colorStride = 0;
+
+    Format positionFormat = Format::undefined;
+    Format normalFormat = Format::undefined;
+    Format texCoord0Format = Format::undefined;
+    Format texCoord1Format = Format::undefined;
+    Format colorFormat = Format::undefined;
+
+    // vertex buffers attributes, every range is checked against its buffer
+    std::vector<size_t> attributeCounts = {};
+    for (const auto& [attributeName, accessorId] : gltfPrimitive.attributes) {
+        auto attributeType = getAttributeType(attributeName);
+        if (attributeType == AttributeType::undefined)
+            continue;
+
+        uint32_t stride = 0;
+        auto data = getAccessorData(gltfModel, buffers, accessorId, stride);
+        if (data.empty()) {
+            CHRLOG_ERROR("Invalid {} accessor for mesh {}", attributeName, gltfMesh.name);
+            submeshData.valid = false;
+            return submeshData;
+        }
+
+        const auto& accessor = gltfModel.accessors[accessorId];
+        attributeCounts.push_back(accessor.count);
+        if (attributeType == AttributeType::position) {
+            if (accessor.minValues.size() < 3 || accessor.maxValues.size() < 3) {
+                CHRLOG_ERROR("Missing position bounds for mesh {}", gltfMesh.name);
+                submeshData.valid = false;
+                return submeshData;
+            }
+
+            verticesCount = static_cast<uint32_t>(accessor.count);
+            submeshData.boundingBox.min
+                = glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]);
+            submeshData.boundingBox.max
+                = glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2]);
+        }
+
+        const auto* buffer = data.data();
+
+        switch (attributeType) {
+        case chronicle::AttributeType::position:
+            positionBuffer = buffer;
+            positionStride = stride;
+            positionFormat = getAttributeFormat(accessor);
+            break;
+        case chronicle::AttributeType::normal:
+            normalBuffer = buffer;
+            normalStride = stride;
+            normalFormat = getAttributeFormat(accessor);
+            break;
+        case chronicle::AttributeType::textcoord0:
+            texCoord0Buffer = buffer;
+            texCoord0Stride = stride;
+            texCoord0Format = getAttributeFormat(accessor);
+            break;
+        case chronicle::AttributeType::textcoord1:
+            texCoord1Buffer = buffer;
+            texCoord1Stride = stride;
+            texCoord1Format = getAttributeFormat(accessor);
+            break;
+        case chronicle::AttributeType::color0:
+            colorBuffer = buffer;
+            colorStride = stride;
+            colorFormat = getAttributeFormat(accessor);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // the attributes are read for every vertex
+    if (positionBuffer == nullptr
+        || std::ranges::any_of(attributeCounts, [verticesCount](size_t count) { return count != verticesCount; })) {
+        CHRLOG_ERROR("Invalid vertex attributes for mesh {}", gltfMesh.name);
+        submeshData.valid = false;
+        return submeshData;
+    }
+
+    submeshData.verticesCount = verticesCount;
+    submeshData.vertexStorage.resize(static_cast<size_t>(verticesCount) * sizeof(Vertex));
+    auto* vertices = std::bit_cast<Vertex*>(submeshData.vertexStorage.data());
+
+    submeshData.vertexBufferInfo.stride = sizeof(Vertex);
+    submeshData.vertexBufferInfo.attributeDescriptions
+        = { { .format = Format::R32G32B32Sfloat,
+                .offset = offsetof(Vertex, position),
+                .location = getLocationFromAttributeType(AttributeType::position) },
+              { .format = Format::R32G32B32Sfloat,
+                  .offset = offsetof(Vertex, normal),
+                  .location = getLocationFromAttributeType(AttributeType::normal) },
+              { .format = Format::R32G32Sfloat,
+                  .offset = offsetof(Vertex, texCoord0),
+                  .location = getLocationFromAttributeType(AttributeType::textcoord0) },
+              { .format = Format::R32G32Sfloat,
+                  .offset = offsetof(Vertex, texCoord1),
+                  .location = getLocationFromAttributeType(AttributeType::textcoord1) },
+              { .format = Format::R32G32B32A32Sfloat,
+                  .offset = offsetof(Vertex, color),
+                  .location = getLocationFromAttributeType(AttributeType::color0) } };
+
+    // interleave the attributes, one pass for every attribute (the missing ones are left to zero)
+    auto convertAttribute = [verticesCount](const unsigned char* buffer, uint32_t stride, Format format,
+                                float* destination, uint32_t components) {
+        return buffer == nullptr
+            || AttributeConverter::convert(
+                buffer, stride, format, verticesCount, destination, sizeof(Vertex), components);
+    };
+
+    if (!convertAttribute(positionBuffer, positionStride, positionFormat, &vertices->position.x, 3)
+        || !convertAttribute(normalBuffer, normalStride, normalFormat, &vertices->normal.x, 3)
+        || !convertAttribute(texCoord0Buffer, texCoord0Stride, texCoord0Format, &vertices->texCoord0.x, 2)
+        || !convertAttribute(texCoord1Buffer, texCoord1Stride, texCoord1Format, &vertices->texCoord1.x, 2)
+        || !convertAttribute(colorBuffer, colorStride, colorFormat, &vertices->color.x, 4)) {
+        CHRLOG_ERROR("Unsupported vertex attribute format for mesh {}", gltfMesh.name);
+        submeshData.valid = false;
+        return submeshData;
+    }
+
+    // get indices if availables
+    if (gltfPrimitive.indices >= 0) {
+        uint32_t stride = 0;
+        auto data = getAccessorData(gltfModel, buffers, gltfPrimitive.indices, stride);
+        if (data.empty()) {
+            CHRLOG_ERROR("Invalid indices accessor for mesh {}", gltfMesh.name);
+            submeshData.valid = false;
+            return submeshData;
+        }
+
+        const auto& accessor = gltfModel.accessors[gltfPrimitive.indices];
+        submeshData.indicesCount = static_cast<uint32_t>(accessor.count);
+        auto format = getAttributeFormat(accessor);
+        submeshData.indexType = getIndexType(format);
+
+        // the indices are tightly packed
+        if (submeshData.indexType == IndexType::undefined || data.size() != accessor.count * stride) {
+            CHRLOG_ERROR("Unsupported index type for mesh {}", gltfMesh.name);
+            submeshData.valid = false;
+            return submeshData;
+        }
+
+        submeshData.indexView = data;
+
+        // reorder the triangles and the vertices, and generate the levels of detail
+        if ((options.optimizeMeshes || options.lodCount > 0) && gltfPrimitive.mode == TINYGLTF_MODE_TRIANGLES) {
+            optimizeSubmesh(submeshData, options);
+        } else if (getSmallestIndexType(submeshData.verticesCount, options.uint8Indices) != submeshData.indexType) {
+            convertIndices(submeshData, options);
+        }
+    }
+
+    // pack the vertices, the attributes not available are not stored
+    if (options.quantizeVertices) {
+        quantizeVertices(submeshData, texCoord1Buffer != nullptr, colorBuffer != nullptr);
+    }
+
+    return submeshData;
+}
+
+std::span<const uint8_t> AssetLoader::getAccessorData(
+    const tinygltf::Model& gltfModel, const AssetBuffers& buffers, int accessorIndex, uint32_t& stride)
 {
-    assert(gltfModel.textures.size() > textureIndex);
+    if (accessorIndex < 0 || accessorIndex >= static_cast<int>(gltfModel.accessors.size())) {
+        return {};
+    }
+
+    // the accessors without a buffer view (initialized to zero) and the sparse ones are not supported
+    const auto& accessor = gltfModel.accessors[accessorIndex];
+    if (accessor.sparse.isSparse || accessor.bufferView < 0
+        || accessor.bufferView >= static_cast<int>(gltfModel.bufferViews.size())) {
+        return {};
+    }
+
+    const auto& bufferView = gltfModel.bufferViews[accessor.bufferView];
+    if (bufferView.buffer < 0 || bufferView.buffer >= static_cast<int>(buffers.buffers.size())) {
+        return {};
+    }
 
-    const auto& gltfTexture = gltfModel.textures[textureIndex];
-    auto imageIndex = gltfTexture.source;
-    assert(gltfModel.images.size() > imageIndex);
+    const auto& buffer = buffers.buffers[bufferView.buffer];
+    auto byteStride = accessor.ByteStride(bufferView);
+    auto elementSize = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType))
+        * tinygltf::GetNumComponentsInType(static_cast<uint32_t>(accessor.type));
+    if (byteStride <= 0 || elementSize <= 0 || accessor.count == 0) {
+        return {};
+    }
 
-    const auto& gltfImage = gltfModel.images[imageIndex];
-    assert(gltfImage.image.size() > 0);
-    assert(gltfImage.width > 0);
-    assert(gltfImage.height > 0);
+    // the view must be in the buffer and the last element in the view, an element is at least a byte
+    if (bufferView.byteOffset > buffer.size() || bufferView.byteLength > buffer.size() - bufferView.byteOffset
+        || accessor.count > bufferView.byteLength || accessor.byteOffset > bufferView.byteLength) {
+        return {};
+    }
+    auto size = (accessor.count - 1) * static_cast<size_t>(byteStride) + static_cast<size_t>(elementSize);
+    if (size > bufferView.byteLength - accessor.byteOffset) {
+        return {};
+    }
 
-    // TODO: handle texture sampler
-    auto texture = Texture::createSampled({ .generateMipmaps = true,
-                                              .data = gltfImage.image,
-                                              .width = static_cast<uint32_t>(gltfImage.width),
-                                              .height = static_cast<uint32_t>(gltfImage.height) },
-        fmt::format("{}", gltfModel.textures[textureIndex].name));
-    return texture;
+    stride = static_cast<uint32_t>(byteStride);
+    return buffer.subspan(bufferView.byteOffset + accessor.byteOffset, size);
 }
 
-MaterialRef AssetLoader::createMaterial(const tinygltf::Model& gltfModel, const tinygltf::Material& gltfMaterial)
+void AssetLoader::optimizeSubmesh(SubmeshData& submeshData, const AssetLoaderOptions& options)
 {
-    auto material = Material::create(gltfMaterial.name.c_str());
+    CHRZONE_ASSETS;
+
+    auto indices = decodeIndices(submeshData);
+
+    // malformed primitives are uploaded as they are
+    auto verticesCount = submeshData.verticesCount;
+    auto isInvalidIndex = [verticesCount](uint32_t index) { return index >= verticesCount; };
+    if (indices.size() % 3 != 0 || std::any_of(indices.begin(), indices.end(), isInvalidIndex)) {
+        CHRLOG_WARN("Invalid indices in {}, optimization skipped", submeshData.name);
+        if (submeshData.indexType == IndexType::uint8 && !options.uint8Indices) {
+            encodeIndices(submeshData, indices, IndexType::uint16);
+        }
+        return;
+    }
+
+    // vertex cache first, the overdraw pass moves only whole clusters
+    if (options.optimizeMeshes) {
+        submeshData.vertexCacheBefore = MeshOptimizer::analyzeVertexCache(indices, verticesCount);
+
+        std::vector<uint32_t> clusters = {};
+        MeshOptimizer::optimizeVertexCache(indices, verticesCount, clusters);
+        MeshOptimizer::optimizeOverdraw(indices, clusters,
+            submeshData.vertexStorage.data() + offsetof(Vertex, position), sizeof(Vertex), verticesCount);
+    }
+
+    // the levels of detail are appended to the full detail indices
+    if (options.lodCount > 0) {
+        generateLods(submeshData, indices, options);
+    }
+
+    // then the vertices in order of use, by all the levels
+    if (options.optimizeMeshes) {
+        submeshData.verticesCount
+            = MeshOptimizer::optimizeVertexFetch(indices, submeshData.vertexStorage, sizeof(Vertex));
+
+        auto fullDetailCount = submeshData.lods.empty() ? indices.size() : submeshData.lods.front().indicesCount;
+        submeshData.vertexCacheAfter = MeshOptimizer::analyzeVertexCache(
+            std::span<const uint32_t>(indices).first(fullDetailCount), submeshData.verticesCount);
+    }
+
+    // store the indices with the smallest type, the unused vertices are removed
+    encodeIndices(submeshData, indices, getSmallestIndexType(submeshData.verticesCount, options.uint8Indices));
+}
+
+void AssetLoader::convertIndices(SubmeshData& submeshData, const AssetLoaderOptions& options)
+{
+    CHRZONE_ASSETS;
+
+    auto indices = decodeIndices(submeshData);
+
+    // the indices out of range don't fit in the smallest type, they are only widened to the supported types
+    auto indexType = getSmallestIndexType(submeshData.verticesCount, options.uint8Indices);
+    if (auto maxIndex = std::max_element(indices.begin(), indices.end());
+        maxIndex != indices.end() && *maxIndex >= submeshData.verticesCount) {
+        CHRLOG_WARN("Invalid indices in {}, conversion skipped", submeshData.name);
+        if (submeshData.indexType != IndexType::uint8 || options.uint8Indices) {
+            return;
+        }
+        indexType = IndexType::uint16;
+    }
+
+    encodeIndices(submeshData, indices, indexType);
+}
+
+IndexType AssetLoader::getSmallestIndexType(uint32_t verticesCount, bool allowUint8)
+{
+    if (allowUint8 && verticesCount <= std::numeric_limits<uint8_t>::max() + 1u) {
+        return IndexType::uint8;
+    }
+
+    if (verticesCount <= std::numeric_limits<uint16_t>::max() + 1u) {
+        return IndexType::uint16;
+    }
+
+    return IndexType::uint32;
+}
+
+std::vector<uint32_t> AssetLoader::decodeIndices(const SubmeshData& submeshData)
+{
+    auto indexData = submeshData.indices();
+    std::vector<uint32_t> indices(submeshData.indicesCount);
+    switch (submeshData.indexType) {
+    case IndexType::uint8:
+        std::copy_n(indexData.data(), indices.size(), indices.begin());
+        break;
+    case IndexType::uint16:
+        for (size_t i = 0; i < indices.size(); i++) {
+            uint16_t index = 0;
+            std::memcpy(&index, indexData.data() + i * sizeof(uint16_t), sizeof(uint16_t));
+            indices[i] = index;
+        }
+        break;
+    default:
+        std::memcpy(indices.data(), indexData.data(), indices.size() * sizeof(uint32_t));
+        break;
+    }
+    return indices;
+}
+
+void AssetLoader::encodeIndices(SubmeshData& submeshData, std::span<const uint32_t> indices, IndexType indexType)
+{
+    switch (indexType) {
+    case IndexType::uint8:
+        submeshData.indexStorage.resize(indices.size());
+        std::transform(indices.begin(), indices.end(), submeshData.indexStorage.begin(),
+            [](uint32_t index) { return static_cast<uint8_t>(index); });
+        break;
+    case IndexType::uint16:
+        submeshData.indexStorage.resize(indices.size() * sizeof(uint16_t));
+        for (size_t i = 0; i < indices.size(); i++) {
+            auto index = static_cast<uint16_t>(indices[i]);
+            std::memcpy(submeshData.indexStorage.data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+        }
+        break;
+    default:
+        submeshData.indexStorage.resize(indices.size() * sizeof(uint32_t));
+        std::memcpy(submeshData.indexStorage.data(), indices.data(), submeshData.indexStorage.size());
+        break;
+    }
+    submeshData.indexType = indexType;
+    submeshData.indexView = {};
+    submeshData.indicesCount = static_cast<uint32_t>(indices.size());
+}
+
+void AssetLoader::generateLods(
+    SubmeshData& submeshData, std::vector<uint32_t>& indices, const AssetLoaderOptions& options)
+{
+    CHRZONE_ASSETS;
+
+    const auto* positions = submeshData.vertexStorage.data() + offsetof(Vertex, position);
+    auto diagonal = glm::length(submeshData.boundingBox.max - submeshData.boundingBox.min);
+    auto maxError = options.lodMaxError * diagonal;
+
+    submeshData.lods.clear();
+    submeshData.lods.push_back({ .firstIndex = 0, .indicesCount = static_cast<uint32_t>(indices.size()) });
+
+    // every level is simplified from the previous one, so the errors add up
+    std::vector<uint32_t> lodIndices = indices;
+    while (submeshData.lods.size() <= options.lodCount && submeshData.lods.size() < MaxSubmeshLods) {
+        auto remainingError = maxError - submeshData.lods.back().error;
+        if (remainingError <= 0.0f) {
+            break;
+        }
+
+        auto targetIndicesCount = static_cast<size_t>(static_cast<float>(lodIndices.size()) * options.lodReduction);
+        targetIndicesCount -= targetIndicesCount % 3;
+
+        float error = 0.0f;
+        auto simplified = MeshOptimizer::simplify(lodIndices, positions, sizeof(Vertex), submeshData.verticesCount,
+            targetIndicesCount, remainingError, error);
+
+        // stop when the error limit or the locked vertices don't allow a meaningful reduction
+        if (simplified.empty() || simplified.size() * 20 > lodIndices.size() * 19) {
+            break;
+        }
+
+        if (options.optimizeMeshes) {
+            std::vector<uint32_t> clusters = {};
+            MeshOptimizer::optimizeVertexCache(simplified, submeshData.verticesCount, clusters);
+        }
+
+        submeshData.lods.push_back({ .firstIndex = static_cast<uint32_t>(indices.size()),
+            .indicesCount = static_cast<uint32_t>(simplified.size()),
+            .error = submeshData.lods.back().error + error });
+        indices.insert(indices.end(), simplified.begin(), simplified.end());
+        lodIndices = std::move(simplified);
+    }
+
+    CHRLOG_DEBUG("Generated {} levels of detail for {}", submeshData.lods.size() - 1, submeshData.name);
+}
+
+void AssetLoader::quantizeVertices(SubmeshData& submeshData, bool hasTexCoord1, bool hasColor)
+{
+    CHRZONE_ASSETS;
+
+    const auto* vertices = std::bit_cast<const Vertex*>(submeshData.vertexStorage.data());
+
+    // the quantization range is the real bounding box, the accessor bounds can be inaccurate
+    BoundingBox boundingBox = { .min = vertices[0].position, .max = vertices[0].position };
+    for (uint32_t i = 1; i < submeshData.verticesCount; i++) {
+        boundingBox.min = glm::min(boundingBox.min, vertices[i].position);
+        boundingBox.max = glm::max(boundingBox.max, vertices[i].position);
+    }
+
+    auto extent = boundingBox.max - boundingBox.min;
+    auto inverseExtent = glm::vec3(extent.x > 0.0f ? 1.0f / extent.x : 0.0f, extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+        extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+
+    // layout
+    VertexBufferInfo vertexBufferInfo = {};
+    uint32_t offset = 0;
+    auto addAttribute = [&vertexBufferInfo, &offset](Format format, uint32_t size, AttributeType attributeType) {
+        vertexBufferInfo.attributeDescriptions.push_back(
+            { .format = format, .offset = offset, .location = getLocationFromAttributeType(attributeType) });
+        offset += size;
+    };
+
+    addAttribute(Format::R16G16B16A16Unorm, 8, AttributeType::position);
+    addAttribute(Format::R16G16Snorm, 4, AttributeType::normal);
+    addAttribute(Format::R16G16Sfloat, 4, AttributeType::textcoord0);
+    if (hasTexCoord1) {
+        addAttribute(Format::R16G16Sfloat, 4, AttributeType::textcoord1);
+    }
+    if (hasColor) {
+        addAttribute(Format::R8G8B8A8Unorm, 4, AttributeType::color0);
+    }
+    vertexBufferInfo.stride = offset;
+
+    // pack the vertices
+    std::vector<uint8_t> vertexStorage(static_cast<size_t>(submeshData.verticesCount) * vertexBufferInfo.stride);
+    for (uint32_t i = 0; i < submeshData.verticesCount; i++) {
+        const auto& vertex = vertices[i];
+        auto* data = vertexStorage.data() + static_cast<size_t>(i) * vertexBufferInfo.stride;
+
+        auto position = glm::clamp((vertex.position - boundingBox.min) * inverseExtent, 0.0f, 1.0f);
+        std::array<uint32_t, 6> packed = { glm::packUnorm2x16(glm::vec2(position.x, position.y)),
+            glm::packUnorm2x16(glm::vec2(position.z, 1.0f)), glm::packSnorm2x16(encodeOctahedral(vertex.normal)),
+            glm::packHalf2x16(vertex.texCoord0), 0, 0 };
+
+        size_t count = 4;
+        if (hasTexCoord1) {
+            packed[count++] = glm::packHalf2x16(vertex.texCoord1);
+        }
+        if (hasColor) {
+            packed[count++] = glm::packUnorm4x8(vertex.color);
+        }
+
+        std::memcpy(data, packed.data(), vertexBufferInfo.stride);
+    }
+
+    submeshData.vertexStorage = std::move(vertexStorage);
+    submeshData.vertexBufferInfo = std::move(vertexBufferInfo);
+    submeshData.boundingBox = boundingBox;
+    submeshData.quantized = true;
+}
+
+glm::vec2 AssetLoader::encodeOctahedral(const glm::vec3& normal)
+{
+    auto length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (length <= 0.0f) {
+        return glm::vec2(0.0f);
+    }
+
+    // project on the octahedron and fold the lower hemisphere
+    auto projected = normal / length;
+    if (projected.z >= 0.0f) {
+        return glm::vec2(projected.x, projected.y);
+    }
+
+    return glm::vec2((1.0f - std::abs(projected.y)) * (projected.x >= 0.0f ? 1.0f : -1.0f),
+        (1.0f - std::abs(projected.x)) * (projected.y >= 0.0f ? 1.0f : -1.0f));
+}
+
+MaterialData AssetLoader::getMaterialData(const tinygltf::Material& gltfMaterial)
+{
+    MaterialData materialData = {};
+    materialData.name = gltfMaterial.name;
 
     // get the material parameters
     for (const auto& [name, parameter] : gltfMaterial.values) {
         if (name == "baseColorFactor") {
             const auto& colorFactor = parameter.ColorFactor();
-            material->setBaseColorFactor(glm::vec4(colorFactor[0], colorFactor[1], colorFactor[2], colorFactor[3]));
+            materialData.baseColorFactor = glm::vec4(colorFactor[0], colorFactor[1], colorFactor[2], colorFactor[3]);
         } else if (name == "metallicFactor") {
-            material->setMetallicFactor(static_cast<float>(parameter.Factor()));
+            materialData.metallicFactor = static_cast<float>(parameter.Factor());
         } else if (name == "roughnessFactor") {
-            material->setRoughnessFactor(static_cast<float>(parameter.Factor()));
+            materialData.roughnessFactor = static_cast<float>(parameter.Factor());
         } else if (name == "baseColorTexture") {
-            material->setBaseColorTexture(createTexture(gltfModel, parameter.TextureIndex()));
+            materialData.baseColorTexture = parameter.TextureIndex();
         } else if (name == "metallicRoughnessTexture") {
-            material->setMetallicRoughnessTexture(createTexture(gltfModel, parameter.TextureIndex()));
+            materialData.metallicRoughnessTexture = parameter.TextureIndex();
         }
     }
 
@@ -232,190 +1441,411 @@ MaterialRef AssetLoader::createMaterial(const tinygltf::Model& gltfModel, const
     for (const auto& [name, parameter] : gltfMaterial.additionalValues) {
         if (name == "emissiveFactor") {
             const auto& emissiveFactor = parameter.number_array;
-            material->setEmissiveFactor(glm::vec3(emissiveFactor[0], emissiveFactor[1], emissiveFactor[2]));
+            materialData.emissiveFactor = glm::vec3(emissiveFactor[0], emissiveFactor[1], emissiveFactor[2]);
         } else if (name == "alphaMode") {
             if (parameter.string_value == "BLEND") {
-                material->setAlphaMode(AlphaMode::blend);
+                materialData.alphaMode = AlphaMode::blend;
             } else if (parameter.string_value == "OPAQUE") {
-                material->setAlphaMode(AlphaMode::opaque);
+                materialData.alphaMode = AlphaMode::opaque;
             } else if (parameter.string_value == "MASK") {
-                material->setAlphaMode(AlphaMode::mask);
+                materialData.alphaMode = AlphaMode::mask;
             }
         } else if (name == "alphaCutoff") {
-            material->setAlphaCutoff(static_cast<float>(parameter.number_value));
+            materialData.alphaCutoff = static_cast<float>(parameter.number_value);
         } else if (name == "doubleSided") {
-            material->setDoubleSided(parameter.bool_value);
+            materialData.doubleSided = parameter.bool_value;
         } else if (name == "normalTexture") {
-            material->setNormalTexture(createTexture(gltfModel, parameter.TextureIndex()));
+            materialData.normalTexture = parameter.TextureIndex();
         } else if (name == "occlusionTexture") {
-            material->setOcclusionTexture(createTexture(gltfModel, parameter.TextureIndex()));
+            materialData.occlusionTexture = parameter.TextureIndex();
         } else if (name == "emissiveTexture") {
-            material->setEmissiveTexture(createTexture(gltfModel, parameter.TextureIndex()));
+            materialData.emissiveTexture = parameter.TextureIndex();
         }
     }
 
-    material->build();
-    return material;
+    return materialData;
 }
 
-MeshRef AssetLoader::createMesh(const tinygltf::Model& gltfModel, const tinygltf::Mesh& gltfMesh,
-    const std::vector<MaterialRef>& materials, const MaterialRef& defaultMaterial, const RenderPassRef& renderPass)
+std::vector<NodeData> AssetLoader::getNodes(const tinygltf::Model& gltfModel)
 {
-    std::vector<Submesh> submeshes = {};
+    CHRZONE_ASSETS;
+
+    // the default scene, or all the root nodes if the asset has no scenes
+    std::vector<int> roots = {};
+    if (!gltfModel.scenes.empty()) {
+        auto sceneIndex = 0;
+        if (gltfModel.defaultScene >= 0 && gltfModel.defaultScene < static_cast<int>(gltfModel.scenes.size())) {
+            sceneIndex = gltfModel.defaultScene;
+        }
+        roots = gltfModel.scenes[sceneIndex].nodes;
+    } else {
+        std::vector<bool> isChild(gltfModel.nodes.size(), false);
+        for (const auto& gltfNode : gltfModel.nodes) {
+            for (auto child : gltfNode.children) {
+                if (child >= 0 && child < static_cast<int>(gltfModel.nodes.size())) {
+                    isChild[child] = true;
+                }
+            }
+        }
+        for (int nodeIndex = 0; nodeIndex < static_cast<int>(gltfModel.nodes.size()); nodeIndex++) {
+            if (!isChild[nodeIndex]) {
+                roots.push_back(nodeIndex);
+            }
+        }
+    }
 
-    // every primitive is a submesh
-    for (uint32_t primitiveIndex = 0; primitiveIndex < static_cast<uint32_t>(gltfMesh.primitives.size());
-         primitiveIndex++) {
-        const tinygltf::Primitive& gltfPrimitive = gltfMesh.primitives[primitiveIndex];
+    // depth first visit, the glTF nodes form a forest so every node is visited once
+    std::vector<NodeData> nodes = {};
+    std::vector<bool> visited(gltfModel.nodes.size(), false);
+    std::vector<std::pair<int, int>> stack = {}; // glTF node index, parent index
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it) {
+        stack.emplace_back(*it, -1);
+    }
 
-        auto submeshName = fmt::format("'{}' mesh, primitive #{}", gltfMesh.name, primitiveIndex);
-        CHRLOG_DEBUG("{}", submeshName);
+    while (!stack.empty()) {
+        auto [gltfNodeIndex, parentIndex] = stack.back();
+        stack.pop_back();
+        if (gltfNodeIndex < 0 || gltfNodeIndex >= static_cast<int>(gltfModel.nodes.size()) || visited[gltfNodeIndex]) {
+            continue;
+        }
+        visited[gltfNodeIndex] = true;
+
+        const auto& gltfNode = gltfModel.nodes[gltfNodeIndex];
+        NodeData nodeData = {};
+        nodeData.name = gltfNode.name;
+        nodeData.parent = parentIndex;
+        if (gltfNode.mesh >= 0 && gltfNode.mesh < static_cast<int>(gltfModel.meshes.size())) {
+            nodeData.mesh = gltfNode.mesh;
+        }
+        nodeData.localTransform = getNodeTransform(gltfNode);
+        nodeData.worldTransform = parentIndex < 0 ? nodeData.localTransform
+                                                  : nodes[parentIndex].worldTransform * nodeData.localTransform;
+
+        auto nodeIndex = static_cast<int>(nodes.size());
+        nodes.push_back(std::move(nodeData));
+        for (auto it = gltfNode.children.rbegin(); it != gltfNode.children.rend(); ++it) {
+            stack.emplace_back(*it, nodeIndex);
+        }
+    }
 
-        Submesh submesh = {};
+    return nodes;
+}
 
-        const unsigned char* positionBuffer = nullptr;
-        const unsigned char* normalBuffer = nullptr;
-        const unsigned char* texCoord0Buffer = nullptr;
-        const unsigned char* texCoord1Buffer = nullptr;
-        const unsigned char* colorBuffer = nullptr;
+glm::mat4 AssetLoader::getNodeTransform(const tinygltf::Node& gltfNode)
+{
+    // the matrix is column major, like glm
+    if (gltfNode.matrix.size() == 16) {
+        glm::dmat4 matrix = glm::make_mat4(gltfNode.matrix.data());
+        return glm::mat4(matrix);
+    }
 
-        uint32_t positionStride = 0;
-        uint32_t normalStride = 0;
-        uint32_t texCoord0Stride = 0;
-        uint32_t texCoord1Stride = 0;
-        uint32_t colorStride = 0;
+    glm::mat4 translation(1.0f);
+    if (gltfNode.translation.size() == 3) {
+        translation = glm::translate(glm::mat4(1.0f),
+            glm::vec3(static_cast<float>(gltfNode.translation[0]), static_cast<float>(gltfNode.translation[1]),
+                static_cast<float>(gltfNode.translation[2])));
+    }
 
-        // vertex buffers attributes
-        for (const auto& [attributeName, accessorId] : gltfPrimitive.attributes) {
-            const auto& accessor = gltfModel.accessors[accessorId];
-            const auto& bufferView = gltfModel.bufferViews[accessor.bufferView];
-            auto stride = accessor.ByteStride(bufferView);
-            auto attributeType = getAttributeType(attributeName);
+    glm::mat4 rotation(1.0f);
+    if (gltfNode.rotation.size() == 4) {
+        // the glTF quaternion is x, y, z, w
+        rotation = glm::mat4_cast(glm::quat(static_cast<float>(gltfNode.rotation[3]),
+            static_cast<float>(gltfNode.rotation[0]), static_cast<float>(gltfNode.rotation[1]),
+            static_cast<float>(gltfNode.rotation[2])));
+    }
 
-            assert(stride >= 0);
+    glm::mat4 scale(1.0f);
+    if (gltfNode.scale.size() == 3) {
+        scale = glm::scale(glm::mat4(1.0f),
+            glm::vec3(static_cast<float>(gltfNode.scale[0]), static_cast<float>(gltfNode.scale[1]),
+                static_cast<float>(gltfNode.scale[2])));
+    }
 
-            if (attributeType == AttributeType::undefined)
-                continue;
+    return translation * rotation * scale;
+}
 
-            if (attributeType == AttributeType::position) {
-                submesh.verticesCount = static_cast<uint32_t>(accessor.count);
-                submesh.boundingBox.min
-                    = glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]);
-                submesh.boundingBox.max
-                    = glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2]);
-            }
+std::vector<glm::mat4> AssetLoader::getMeshInstances(const std::vector<NodeData>& nodes, int meshIndex)
+{
+    std::vector<glm::mat4> instances = {};
+    for (const auto& nodeData : nodes) {
+        if (nodeData.mesh == meshIndex) {
+            instances.push_back(nodeData.worldTransform);
+        }
+    }
+
+    // the meshes not placed by any node are drawn once at the origin
+    if (instances.empty()) {
+        instances.emplace_back(1.0f);
+    }
+
+    return instances;
+}
+
+AssetResult AssetLoader::createAsset(AssetData& assetData, const RenderPassRef& renderPass)
+{
+    CHRZONE_ASSETS;
+
+    loadShaders(assetData);
+
+    // the GPU resources are created on the calling thread, the command pool and the queues are not thread safe
+    AssetResult result = {};
+    std::vector<MaterialRef> materials = {};
+    materials.reserve(assetData.materials.size());
+
+    auto defaultMaterial = Material::create("Default material");
+
+    // create materials
+    for (const auto& materialData : assetData.materials) {
+        auto material = createMaterial(materialData, assetData.textures);
+        materials.push_back(std::move(material));
+    }
+
+    // create meshes, every mesh is uploaded once and drawn for all his instances
+    PipelineBatch pipelineBatch = {};
+    for (size_t meshIndex = 0; meshIndex < assetData.meshes.size(); meshIndex++) {
+        auto instances = getMeshInstances(assetData.nodes, static_cast<int>(meshIndex));
+        result.meshes.push_back(createMesh(
+            assetData.meshes[meshIndex], instances, materials, defaultMaterial, renderPass, pipelineBatch));
+    }
+    result.nodes = assetData.nodes;
+
+    // the pipelines are created in parallel, the asset is returned with all of them ready
+    pipelineBatch.submit();
+    pipelineBatch.wait();
+    if (pipelineBatch.failed()) {
+        CHRLOG_ERROR("Failed to create the pipelines of the asset");
+        return {};
+    }
 
-            const tinygltf::BufferView& view = gltfModel.bufferViews[accessor.bufferView];
-
-            const auto* buffer = &gltfModel.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset];
-
-            switch (attributeType) {
-            case chronicle::AttributeType::position:
-                positionBuffer = buffer;
-                positionStride = stride;
-                break;
-            case chronicle::AttributeType::normal:
-                normalBuffer = buffer;
-                normalStride = stride;
-                break;
-            case chronicle::AttributeType::textcoord0:
-                texCoord0Buffer = buffer;
-                texCoord0Stride = stride;
-                break;
-            case chronicle::AttributeType::textcoord1:
-                texCoord1Buffer = buffer;
-                texCoord1Stride = stride;
-                break;
-            case chronicle::AttributeType::color0:
-                colorBuffer = buffer;
-                colorStride = stride;
-                break;
-            default:
-                break;
+    return result;
+}
+
+bool AssetLoader::uploadAsset(AssetLoadHandle& handle, uint64_t& uploadBudget)
+{
+    CHRZONE_ASSETS;
+
+    auto& assetData = handle._assetData;
+    auto consumeBudget = [&uploadBudget](uint64_t size) { uploadBudget -= std::min(uploadBudget, size); };
+
+    if (!handle._defaultMaterial) {
+        handle._defaultMaterial = Material::create("Default material");
+        handle._materials.reserve(assetData.materials.size());
+    }
+
+    // the materials first, with the textures not created yet
+    while (handle._materials.size() < assetData.materials.size()) {
+        if (uploadBudget == 0) {
+            return false;
+        }
+
+        const auto& materialData = assetData.materials[handle._materials.size()];
+        for (auto textureIndex : { materialData.baseColorTexture, materialData.metallicRoughnessTexture,
+                 materialData.normalTexture, materialData.occlusionTexture, materialData.emissiveTexture }) {
+            if (textureIndex >= 0 && static_cast<size_t>(textureIndex) < assetData.textures.size()
+                && !assetData.textures[textureIndex].texture) {
+                consumeBudget(assetData.textures[textureIndex].pixels.size());
             }
         }
+        handle._materials.push_back(createMaterial(materialData, assetData.textures));
+    }
 
-        assert(submesh.verticesCount > 0);
-        assert(positionBuffer != nullptr);
-
-        std::vector<Vertex> stagingVertexBuffer(submesh.verticesCount);
-
-        for (auto i = 0; i < submesh.verticesCount; i++) {
-            auto& vertex = stagingVertexBuffer[i];
-
-            // TODO: make dynamic and try to convert the format (see getAttributeFormat)
-            vertex.position = glm::make_vec3(std::bit_cast<const float*>(&positionBuffer[i * positionStride]));
-            vertex.normal = normalBuffer ? glm::make_vec3(std::bit_cast<const float*>(&normalBuffer[i * normalStride]))
-                                         : glm::vec3(0.0f);
-            vertex.texCoord0 = texCoord0Buffer
-                ? glm::make_vec2(std::bit_cast<const float*>(&texCoord0Buffer[i * texCoord0Stride]))
-                : glm::vec2(0.0f);
-            vertex.texCoord1 = texCoord1Buffer
-                ? glm::make_vec2(std::bit_cast<const float*>(&texCoord1Buffer[i * texCoord1Stride]))
-                : glm::vec2(0.0f);
-            vertex.color = colorBuffer ? glm::make_vec4(std::bit_cast<const float*>(&colorBuffer[i * colorStride]))
-                                       : glm::vec4(0.0f);
-        }
-
-        {
-            auto vertexBuffer = VertexBuffer::create((uint8_t*)stagingVertexBuffer.data(),
-                stagingVertexBuffer.size() * sizeof(Vertex),
-                fmt::format("'{}' mesh, primitive #{}: vertex buffer", gltfMesh.name, primitiveIndex));
-            submesh.vertexBuffers.push_back(vertexBuffer);
-            submesh.vertexBufferIds.push_back(vertexBuffer->vertexBufferId());
-            submesh.vertexBufferOffsets.push_back(0);
-
-            VertexBufferInfo vertexBufferInfo = {};
-            vertexBufferInfo.stride = sizeof(Vertex);
-            vertexBufferInfo.attributeDescriptions
-                = { { .format = Format::R32G32B32Sfloat,
-                        .offset = offsetof(Vertex, position),
-                        .location = getLocationFromAttributeType(AttributeType::position) },
-                      { .format = Format::R32G32B32Sfloat,
-                          .offset = offsetof(Vertex, normal),
-                          .location = getLocationFromAttributeType(AttributeType::normal) },
-                      { .format = Format::R32G32Sfloat,
-                          .offset = offsetof(Vertex, texCoord0),
-                          .location = getLocationFromAttributeType(AttributeType::textcoord0) },
-                      { .format = Format::R32G32Sfloat,
-                          .offset = offsetof(Vertex, texCoord1),
-                          .location = getLocationFromAttributeType(AttributeType::textcoord1) },
-                      { .format = Format::R32G32B32A32Sfloat,
-                          .offset = offsetof(Vertex, color),
-                          .location = getLocationFromAttributeType(AttributeType::color0) } };
-            submesh.vertexBuffersInfo.push_back(vertexBufferInfo);
+    // then the meshes, drawable as soon as they are created and their pipelines are ready
+    if (handle._result.nodes.empty()) {
+        handle._result.nodes = assetData.nodes;
+    }
+
+    // the pipelines of the meshes created by this call are built together on the worker threads
+    auto pipelineBatch = std::make_unique<PipelineBatch>();
+    auto submitPipelines = [&handle, &pipelineBatch]() {
+        if (!pipelineBatch->empty()) {
+            pipelineBatch->submit();
+            handle._pipelineBatches.push_back(std::move(pipelineBatch));
         }
+    };
 
-        // create indices if availables
-        if (gltfPrimitive.indices >= 0) {
-            const auto& accessor = gltfModel.accessors[gltfPrimitive.indices];
-            submesh.indicesCount = static_cast<uint32_t>(accessor.count);
-            auto format = getAttributeFormat(accessor);
-            submesh.indexType = getIndexType(format);
-
-            if (submesh.indexType == IndexType::undefined) {
-                CHRLOG_ERROR("Unsupported index type for mesh {}", gltfMesh.name);
-                break;
+    while (handle._result.meshes.size() < assetData.meshes.size()) {
+        if (uploadBudget == 0) {
+            submitPipelines();
+            return false;
+        }
+
+        auto meshIndex = static_cast<int>(handle._result.meshes.size());
+        const auto& meshData = assetData.meshes[meshIndex];
+        auto instances = getMeshInstances(assetData.nodes, meshIndex);
+        for (const auto& submeshData : meshData.submeshes) {
+            consumeBudget(submeshData.vertices().size() + submeshData.indices().size());
+        }
+        consumeBudget(instances.size() * sizeof(MeshInstance));
+        handle._result.meshes.push_back(createMesh(
+            meshData, instances, handle._materials, handle._defaultMaterial, handle._renderPass, *pipelineBatch));
+    }
+
+    submitPipelines();
+    return true;
+}
+
+TextureRef AssetLoader::createTexture(std::vector<TextureData>& textures, int textureIndex)
+{
+    if (textureIndex < 0) {
+        return nullptr;
+    }
+
+    assert(textures.size() > textureIndex);
+    auto& textureData = textures[textureIndex];
+
+    // already created for another material
+    if (textureData.texture) {
+        return textureData.texture;
+    }
+
+    // loaded by another asset after the import
+    textureData.texture = TextureLoader::get(textureData.hash, textureData.sourceSize);
+    if (textureData.texture) {
+        return textureData.texture;
+    }
+
+    if (textureData.pixels.empty()) {
+        CHRLOG_ERROR("Missing image for texture {}", textureData.name);
+        return nullptr;
+    }
+
+    assert(textureData.width > 0);
+    assert(textureData.height > 0);
+
+    if (!RenderContext::supportsSampledFormat(textureData.format)) {
+        CHRLOG_ERROR(
+            "Unsupported format {} for texture {}", magic_enum::enum_name(textureData.format), textureData.name);
+        return nullptr;
+    }
+
+    textureData.texture = TextureLoader::load(textureData.hash, textureData.sourceSize,
+        { .generateMipmaps = true,
+            .data = textureData.pixels,
+            .format = textureData.format,
+            .mipLevels = textureData.mipLevels,
+            .width = textureData.width,
+            .height = textureData.height,
+            .sampler = textureData.sampler },
+        textureData.name);
+    return textureData.texture;
+}
+
+MaterialRef AssetLoader::createMaterial(const MaterialData& materialData, std::vector<TextureData>& textures)
+{
+    auto material = Material::create(materialData.name.c_str());
+
+    material->setBaseColorFactor(materialData.baseColorFactor);
+    material->setMetallicFactor(materialData.metallicFactor);
+    material->setRoughnessFactor(materialData.roughnessFactor);
+    material->setEmissiveFactor(materialData.emissiveFactor);
+    material->setAlphaMode(materialData.alphaMode);
+    material->setAlphaCutoff(materialData.alphaCutoff);
+    material->setDoubleSided(materialData.doubleSided);
+    material->setBaseColorTexture(createTexture(textures, materialData.baseColorTexture));
+    material->setMetallicRoughnessTexture(createTexture(textures, materialData.metallicRoughnessTexture));
+    material->setNormalTexture(createTexture(textures, materialData.normalTexture));
+    material->setOcclusionTexture(createTexture(textures, materialData.occlusionTexture));
+    material->setEmissiveTexture(createTexture(textures, materialData.emissiveTexture));
+
+    material->build();
+    return material;
+}
+
+ShaderInfo AssetLoader::getShaderInfo(const SubmeshData& submeshData)
+{
+    // the variant depends on the vertex layout
+    ShaderInfo shaderInfo = {};
+    shaderInfo.filename = "Built-In/MaterialPbr.glsl";
+    if (submeshData.quantized) {
+        shaderInfo.macroDefinitions.emplace_back("QUANTIZED_VERTICES");
+    }
+    for (const auto& attribute : submeshData.vertexBufferInfo.attributeDescriptions) {
+        if (attribute.location == getLocationFromAttributeType(AttributeType::textcoord1)) {
+            shaderInfo.macroDefinitions.emplace_back("HAS_TEXCOORD1");
+        } else if (attribute.location == getLocationFromAttributeType(AttributeType::color0)) {
+            shaderInfo.macroDefinitions.emplace_back("HAS_COLOR0");
+        }
+    }
+    return shaderInfo;
+}
+
+void AssetLoader::loadShaders(AssetData& assetData)
+{
+    CHRZONE_ASSETS;
+
+    // the submeshes with the same variant share the shader, it's compiled once
+    for (auto& meshData : assetData.meshes) {
+        for (auto& submeshData : meshData.submeshes) {
+            if (submeshData.valid && !submeshData.shader) {
+                submeshData.shader = ShaderLoader::load(getShaderInfo(submeshData));
             }
+        }
+    }
+}
+
+MeshRef AssetLoader::createMesh(const MeshData& meshData, const std::vector<glm::mat4>& instances,
+    const std::vector<MaterialRef>& materials, const MaterialRef& defaultMaterial, const RenderPassRef& renderPass,
+    PipelineBatch& pipelineBatch)
+{
+    CHRZONE_ASSETS;
+
+    assert(!instances.empty());
 
-            const auto& bufferView = gltfModel.bufferViews[accessor.bufferView];
-            auto stride = accessor.ByteStride(bufferView);
-            const auto& buffer = gltfModel.buffers[bufferView.buffer];
+    std::vector<Submesh> submeshes = {};
 
-            auto startByte = accessor.byteOffset + bufferView.byteOffset;
-            auto endByte = accessor.count * stride;
+    // every primitive is a submesh
+    for (const auto& submeshData : meshData.submeshes) {
+        // the primitives that can't be converted are skipped, the others are still drawn
+        if (!submeshData.valid) {
+            continue;
+        }
 
-            submesh.indexBuffer = IndexBuffer::create((uint8_t*)(buffer.data.data() + startByte), endByte,
-                fmt::format("'{}' mesh, primitive #{}: index buffer", gltfMesh.name, primitiveIndex));
-            submesh.indexBufferId = (vk::Buffer)submesh.indexBuffer->indexBufferId();
+        Submesh submesh = {};
+        submesh.verticesCount = submeshData.verticesCount;
+        submesh.boundingBox = submeshData.boundingBox;
+
+        // the positions are quantized in the bounding box
+        if (submeshData.quantized) {
+            submesh.quantized = true;
+            submesh.dequantization.positionOffset = glm::vec4(submeshData.boundingBox.min, 0.0f);
+            submesh.dequantization.positionScale
+                = glm::vec4(submeshData.boundingBox.max - submeshData.boundingBox.min, 0.0f);
+        }
+
+        // the vertices and the indices are sub-allocated from the geometry pool, the instances are in the mesh
+        submesh.vertices = GeometryPool::allocateVertices(submeshData.vertices(), submeshData.vertexBufferInfo.stride);
+        submesh.vertexBuffersInfo.push_back(submeshData.vertexBufferInfo);
+        submesh.vertexBuffersInfo.push_back(Mesh::instanceBufferInfo());
+
+        // create indices if availables
+        if (auto indices = submeshData.indices(); !indices.empty()) {
+            // 8 bit indices are widened when the GPU doesn't support them
+            std::vector<uint8_t> widenedIndices = {};
+            submesh.indexType = submeshData.indexType;
+            if (submesh.indexType == IndexType::uint8 && !RenderContext::supportsIndexTypeUint8()) {
+                widenedIndices.resize(submeshData.indicesCount * sizeof(uint16_t));
+                for (uint32_t i = 0; i < submeshData.indicesCount; i++) {
+                    auto index = static_cast<uint16_t>(indices[i]);
+                    std::memcpy(widenedIndices.data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+                }
+                indices = widenedIndices;
+                submesh.indexType = IndexType::uint16;
+            }
+
+            submesh.indicesCount = submeshData.indicesCount;
+            submesh.lods = submeshData.lods;
+            if (submesh.lods.empty()) {
+                submesh.lods.push_back({ .firstIndex = 0, .indicesCount = submeshData.indicesCount });
+            }
+            submesh.indices = GeometryPool::allocateIndices(indices, submesh.indexType);
         }
 
         // set material
-        if (gltfPrimitive.material < 0) {
+        if (submeshData.materialIndex < 0) {
             submesh.material = defaultMaterial;
         } else {
-            assert(materials.size() > gltfPrimitive.material);
-            submesh.material = materials[gltfPrimitive.material];
+            assert(materials.size() > submeshData.materialIndex);
+            submesh.material = materials[submeshData.materialIndex];
         }
 
         // create descriptor set layout
@@ -423,63 +1853,46 @@ MeshRef AssetLoader::createMesh(const tinygltf::Model& gltfModel, const tinygltf
         descriptorLayout.setNumber = 1;
         descriptorLayout.bindings[0] = DescriptorSetLayoutBinding { .binding = 0,
             .descriptorSet = 1,
-            .descriptorType = DescriptorType::uniformBuffer,
+            .descriptorType = DescriptorType::uniformBufferDynamic,
             .name = "MaterialBufferObject",
             .stages = ShaderStage::fragment };
 
-        // create pipeline
-        ShaderInfo shaderInfo = {};
-        shaderInfo.filename = "Built-In/MaterialPbr.glsl";
-        if (submesh.material->haveBaseColorTexture()) {
-            shaderInfo.macroDefinitions.emplace_back("HAS_BASE_COLOR_TEXTURE");
-            descriptorLayout.bindings[1] = DescriptorSetLayoutBinding { .binding = 1,
-                .descriptorType = DescriptorType::combinedImageSampler,
-                .name = "baseColorTexSampler",
-                .stages = ShaderStage::fragment };
-        }
-        if (submesh.material->haveMetallicRoughnessTexture()) {
-            shaderInfo.macroDefinitions.emplace_back("HAS_METALLIC_ROUGHNESS_TEXTURE");
-            descriptorLayout.bindings[2] = DescriptorSetLayoutBinding { .binding = 2,
+        // the textures are bound for every material, their presence is a specialization constant
+        constexpr std::array<const char*, 5> samplerNames = { "baseColorTexSampler", "metallicRoughnessSampler",
+            "normalSampler", "occlusionSampler", "emissiveSampler" };
+        for (uint32_t i = 0; i < samplerNames.size(); i++) {
+            descriptorLayout.bindings[i + 1] = DescriptorSetLayoutBinding { .binding = i + 1,
                 .descriptorType = DescriptorType::combinedImageSampler,
-                .name = "metallicRoughnessSampler",
-                .stages = ShaderStage::fragment };
-        }
-        if (submesh.material->haveNormalTexture()) {
-            shaderInfo.macroDefinitions.emplace_back("HAS_NORMAL_TEXTURE");
-            descriptorLayout.bindings[3] = DescriptorSetLayoutBinding { .binding = 3,
-                .descriptorType = DescriptorType::combinedImageSampler,
-                .name = "normalSampler",
-                .stages = ShaderStage::fragment };
-        }
-        if (submesh.material->haveOcclusionTexture()) {
-            shaderInfo.macroDefinitions.emplace_back("HAS_OCCLUSION_TEXTURE");
-            descriptorLayout.bindings[4] = DescriptorSetLayoutBinding { .binding = 4,
-                .descriptorType = DescriptorType::combinedImageSampler,
-                .name = "occlusionSampler",
-                .stages = ShaderStage::fragment };
-        }
-        if (submesh.material->haveEmissiveTexture()) {
-            shaderInfo.macroDefinitions.emplace_back("HAS_EMISSIVE_TEXTURE");
-            descriptorLayout.bindings[5] = DescriptorSetLayoutBinding { .binding = 5,
-                .descriptorType = DescriptorType::combinedImageSampler,
-                .name = "emissiveSampler",
+                .name = samplerNames[i],
                 .stages = ShaderStage::fragment };
         }
 
+        // create pipeline, the shader is already loaded by the import
+        assert(submeshData.shader);
         PipelineInfo pipelineInfo = {};
-        pipelineInfo.shader = ShaderLoader::load(shaderInfo);
+        pipelineInfo.shader = submeshData.shader;
         pipelineInfo.renderPass = renderPass;
         pipelineInfo.vertexBuffers = submesh.vertexBuffersInfo;
         pipelineInfo.descriptorSetsLayout.push_back(RenderContext::descriptorSetLayout());
         pipelineInfo.descriptorSetsLayout.push_back(descriptorLayout);
-        submesh.pipeline = PipelineLoader::load(pipelineInfo, "test"); // TODO: handle debug name
+        pipelineInfo.specializationConstants = submesh.material->specializationConstants();
+        if (submesh.quantized) {
+            pipelineInfo.pushConstants.push_back({ .stages = ShaderStage::vertex,
+                .offset = 0,
+                .size = static_cast<uint32_t>(sizeof(VertexDequantization)) });
+        }
+        submesh.pipeline = pipelineBatch.add(pipelineInfo, fmt::format("{}: pipeline", submeshData.name));
 
         submeshes.push_back(std::move(submesh));
     }
 
-    assert(submeshes.size() > 0);
+    // the slot of the mesh is kept, the nodes reference the meshes by index
+    if (submeshes.empty()) {
+        CHRLOG_WARN("Mesh {} doesn't have valid primitives", meshData.name);
+        return nullptr;
+    }
 
-    return Mesh::create(submeshes);
+    return Mesh::create(submeshes, instances);
 }
 
 } // namespace chronicle
\ No newline at end of file
@@ -5,30 +5,206 @@
 
 #include "pch.h"
 
-#include "Assets/Material.h"
-#include "Assets/Mesh.h"
+#include "AssetData.h"
+#include "PipelineLoader.h"
+#include "TextureCooker.h"
+#include "Utils/ThreadPool.h"
 
 namespace chronicle {
 
 struct AssetResult {
-    std::vector<MeshRef> meshes {};
+    std::vector<MeshRef> meshes {}; ///< Meshes, drawn once for every node that places them, null if not valid.
+    std::vector<NodeData> nodes {}; ///< Nodes of the default scene.
 };
 
+/// @brief Options used to import an asset.
+struct AssetLoaderOptions {
+    /// @brief Decode the images and convert the primitives in parallel on a worker pool.
+    bool parallel { true };
+
+    /// @brief Number of worker threads of the pool shared by the imports, 0 to use the hardware concurrency.
+    uint32_t threadCount { 0 };
+
+    /// @brief Read the buffers straight from memory mapped files, instead of copying them in memory.
+    bool mapBuffers { false };
+
+    /// @brief Directory used to cache the cooked assets, empty to disable the cache.
+    ///        When enabled the asset is loaded from the cooked copy if up to date, otherwise it's cooked on import.
+    std::filesystem::path cookedCacheDirectory {};
+
+    /// @brief Pack the vertices in compact formats: unorm16 positions dequantized in the vertex shader, octahedral
+    ///        snorm16 normals, half float texture coordinates and RGBA8 colors. The missing attributes are omitted.
+    bool quantizeVertices { false };
+
+    /// @brief Reorder the triangles for the post-transform vertex cache and to reduce the overdraw, then reorder the
+    ///        vertices for the fetch locality. The vertex cache statistics before and after are logged.
+    bool optimizeMeshes { false };
+
+    /// @brief Store the indices in 8 bits when the submesh has at most 256 vertices. The indices are widened to 16 bits
+    ///        when the mesh is created, if the GPU doesn't support VK_EXT_index_type_uint8.
+    ///        The other indices are always stored in the smallest type between 16 and 32 bits.
+    bool uint8Indices { false };
+
+    /// @brief Generate the mip chain of the uncompressed textures at import, instead of blitting it on the GPU when
+    ///        the texture is created. The color textures are filtered in linear space, the alpha tested ones keep
+    ///        their coverage. The levels are stored in the cooked asset.
+    bool cookMipmaps { true };
+
+    /// @brief Levels of detail generated for every submesh by simplification, besides the full detail one.
+    ///        The levels share the vertices and are stored as consecutive ranges of the index buffer.
+    uint32_t lodCount { 0 };
+
+    /// @brief Target indices count of a level of detail, relative to the previous one.
+    float lodReduction { 0.5f };
+
+    /// @brief Maximum simplification error, relative to the bounding box diagonal of the submesh.
+    float lodMaxError { 0.05f };
+};
+
+/// @brief State of an asynchronous load.
+enum class AssetLoadState {
+    importing, ///< The asset is parsed and converted on a worker thread.
+    uploading, ///< The resources are created on the GPU, a few for every poll.
+    ready, ///< All the meshes are resident.
+    failed ///< The asset can't be imported, or its pipelines can't be created.
+};
+
+class AssetLoadHandle;
+using AssetLoadHandleRef = std::shared_ptr<AssetLoadHandle>;
+
+/// @brief Handle used to follow an asynchronous load, see @ref AssetLoader#loadAsync.
+class AssetLoadHandle : private NonCopyable<AssetLoadHandle> {
+public:
+    /// @brief Get the load state.
+    /// @return Load state.
+    [[nodiscard]] AssetLoadState state() const { return _state.load(std::memory_order_acquire); }
+
+    /// @brief Check if all the meshes are resident.
+    /// @return True if the load is completed.
+    [[nodiscard]] bool ready() const { return state() == AssetLoadState::ready; }
+
+    /// @brief Check if the load is failed.
+    /// @return True if the asset can't be imported, or its pipelines can't be created.
+    [[nodiscard]] bool failed() const { return state() == AssetLoadState::failed; }
+
+    /// @brief Get the meshes already resident on the GPU, in the asset order.
+    ///        The meshes are drawable as soon as they are here. It must be used on the render thread.
+    /// @return Resident meshes.
+    [[nodiscard]] const AssetResult& result() const { return _result; }
+
+    /// @brief Get the asset filename.
+    /// @return Asset filename.
+    [[nodiscard]] const std::string& filename() const { return _filename; }
+
+private:
+    std::string _filename {}; ///< Asset filename.
+    RenderPassRef _renderPass {}; ///< Render pass used to create the pipelines.
+    AssetLoaderOptions _options {}; ///< Import options.
+    std::atomic<AssetLoadState> _state { AssetLoadState::importing }; ///< Load state.
+    AssetData _assetData {}; ///< Imported data, owned by the worker thread until the upload.
+    std::vector<MaterialRef> _materials {}; ///< Materials created on the GPU.
+    MaterialRef _defaultMaterial {}; ///< Material used by the submeshes without one.
+    AssetResult _result {}; ///< Meshes created on the GPU.
+    std::vector<std::unique_ptr<PipelineBatch>> _pipelineBatches {}; ///< Pipelines of the meshes in progress.
+
+    friend class AssetLoader;
+};
+
+struct AssetBuffers;
+struct DecodedImage;
+
 class AssetLoader {
 public:
-    [[nodiscard]] static AssetResult load(const std::string& filename, const RenderPassRef& renderPass);
+    /// @brief Bytes uploaded on the GPU by default for every poll.
+    static constexpr uint64_t DefaultUploadBudget = 16 * 1024 * 1024;
+
+    [[nodiscard]] static AssetResult load(
+        const std::string& filename, const RenderPassRef& renderPass, const AssetLoaderOptions& options = {});
+
+    /// @brief Load an asset without blocking the caller.
+    ///        The asset is imported on a worker thread, then the GPU resources are created by @ref AssetLoader#poll.
+    /// @param filename Source filename.
+    /// @param renderPass Render pass used to create the pipelines.
+    /// @param options Import options.
+    /// @return Handle used to follow the load.
+    [[nodiscard]] static AssetLoadHandleRef loadAsync(
+        const std::string& filename, const RenderPassRef& renderPass, const AssetLoaderOptions& options = {});
+
+    /// @brief Create on the GPU the resources of the imported asynchronous loads.
+    ///        It must be called once for every frame on the render thread, at least one resource is created.
+    /// @param uploadBudget Bytes uploaded on the GPU in this call.
+    static void poll(uint64_t uploadBudget = DefaultUploadBudget);
+
+    /// @brief Wait the imports in progress and drop the pending loads.
+    static void deinit();
+
+    /// @brief Import an asset and write his cooked version.
+    /// @param filename Source filename.
+    /// @param cookedFilename Cooked filename.
+    /// @param options Import options.
+    /// @return True if the asset is cooked.
+    static bool cook(const std::string& filename, const std::filesystem::path& cookedFilename,
+        const AssetLoaderOptions& options = {});
+
+    /// @brief Load a cooked asset, without checking his source.
+    /// @param cookedFilename Cooked filename.
+    /// @param renderPass Render pass used to create the pipelines.
+    /// @return Loaded asset.
+    [[nodiscard]] static AssetResult loadCooked(
+        const std::filesystem::path& cookedFilename, const RenderPassRef& renderPass);
 
 private:
+    static bool importAsset(const std::string& filename, const AssetLoaderOptions& options, AssetData& assetData);
+    static bool importGltf(
+        const std::string& filename, const AssetLoaderOptions& options, bool decodeAllImages, AssetData& assetData);
+    static uint64_t cookOptionsHash(const AssetLoaderOptions& options);
+    static bool loadMapped(tinygltf::TinyGLTF& loader, tinygltf::Model& gltfModel, const std::string& filename,
+        bool binary, AssetBuffers& buffers, std::string& err, std::string& warn);
+    static std::string decodeUri(const std::string& uri);
+
     static Format getAttributeFormat(const tinygltf::Accessor& accessor);
     static IndexType getIndexType(Format format);
     static AttributeType getAttributeType(const std::string_view& attributeName);
     static uint32_t getLocationFromAttributeType(AttributeType attributeType);
+    static SamplerInfo getSamplerInfo(const tinygltf::Model& gltfModel, int samplerIndex);
+    static size_t hashImageSource(const tinygltf::Image& gltfImage, const std::filesystem::path& basePath);
+
+    static bool storeImageData(tinygltf::Image* image, const int imageIndex, std::string* err, std::string* warn,
+        int reqWidth, int reqHeight, const unsigned char* bytes, int size, void* userData);
+    static void decodeImage(
+        tinygltf::Image& gltfImage, const std::optional<TextureCookOptions>& cookOptions, DecodedImage& decodedImage);
+    static std::vector<TextureCookOptions> getImageCookOptions(const tinygltf::Model& gltfModel);
+    static int getTextureSource(const tinygltf::Texture& gltfTexture);
+    static SubmeshData convertPrimitive(const tinygltf::Model& gltfModel, const AssetBuffers& buffers,
+        const tinygltf::Mesh& gltfMesh, uint32_t primitiveIndex, const AssetLoaderOptions& options);
+    static std::span<const uint8_t> getAccessorData(
+        const tinygltf::Model& gltfModel, const AssetBuffers& buffers, int accessorIndex, uint32_t& stride);
+    static void optimizeSubmesh(SubmeshData& submeshData, const AssetLoaderOptions& options);
+    static void generateLods(
+        SubmeshData& submeshData, std::vector<uint32_t>& indices, const AssetLoaderOptions& options);
+    static void convertIndices(SubmeshData& submeshData, const AssetLoaderOptions& options);
+    static IndexType getSmallestIndexType(uint32_t verticesCount, bool allowUint8);
+    static std::vector<uint32_t> decodeIndices(const SubmeshData& submeshData);
+    static void encodeIndices(SubmeshData& submeshData, std::span<const uint32_t> indices, IndexType indexType);
+    static void quantizeVertices(SubmeshData& submeshData, bool hasTexCoord1, bool hasColor);
+    static glm::vec2 encodeOctahedral(const glm::vec3& normal);
+
+    static MaterialData getMaterialData(const tinygltf::Material& gltfMaterial);
+    static std::vector<NodeData> getNodes(const tinygltf::Model& gltfModel);
+    static glm::mat4 getNodeTransform(const tinygltf::Node& gltfNode);
+    static std::vector<glm::mat4> getMeshInstances(const std::vector<NodeData>& nodes, int meshIndex);
+
+    static ShaderInfo getShaderInfo(const SubmeshData& submeshData);
+    static void loadShaders(AssetData& assetData);
 
-    static TextureRef createTexture(const tinygltf::Model& gltfModel, uint32_t textureIndex);
-    static MaterialRef createMaterial(const tinygltf::Model& gltfModel, const tinygltf::Material& gltfMaterial);
+    static AssetResult createAsset(AssetData& assetData, const RenderPassRef& renderPass);
+    static bool uploadAsset(AssetLoadHandle& handle, uint64_t& uploadBudget);
+    static TextureRef createTexture(std::vector<TextureData>& textures, int textureIndex);
+    static MaterialRef createMaterial(const MaterialData& materialData, std::vector<TextureData>& textures);
 
-    static MeshRef createMesh(const tinygltf::Model& gltfModel, const tinygltf::Mesh& gltfMesh,
-        const std::vector<MaterialRef>& materials, const MaterialRef& defaultMaterial, const RenderPassRef& renderPass);
+    static MeshRef createMesh(const MeshData& meshData, const std::vector<glm::mat4>& instances,
+        const std::vector<MaterialRef>& materials, const MaterialRef& defaultMaterial, const RenderPassRef& renderPass,
+        PipelineBatch& pipelineBatch);
 };
 
 } // namespace chronicle
\ No newline at end of file
@@ -0,0 +1,443 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "AttributeConverter.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CHR_ATTRIBUTE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// the kernels are compiled for their instruction set, without changing the flags of the whole target
+#if defined(CHR_ATTRIBUTE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CHR_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define CHR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CHR_TARGET_SSE41
+#define CHR_TARGET_AVX2
+#endif
+
+namespace chronicle {
+
+/// @brief Type of the source components.
+enum class ComponentType { sint8, uint8, unorm8, snorm8, sint16, uint16, unorm16, snorm16, sint32, uint32, float32 };
+
+/// @brief Layout of a source element.
+struct ComponentLayout {
+    ComponentType type { ComponentType::float32 }; ///< Components type.
+    uint32_t count { 0 }; ///< Components count, 0 if the format is not supported.
+};
+
+/// @brief Signature of a conversion kernel.
+using ConvertKernel = void (*)(const uint8_t* source, size_t sourceStride, uint32_t sourceComponents, size_t count,
+    float* destination, size_t destinationStride, uint32_t destinationComponents);
+
+/// @brief Vertices converted by the scalar code at the end of the SIMD kernels.
+///        A 16 bytes load of an element reads at most 12 bytes of the next ones, that are at least 4 bytes apart.
+constexpr size_t SimdTailCount = 4;
+
+struct AttributeConverterContext {
+    static inline std::atomic<AttributeInstructionSet> instructionSet { AttributeInstructionSet::scalar };
+    static inline AttributeInstructionSet supportedInstructionSet { AttributeInstructionSet::scalar };
+    static inline std::once_flag detected {};
+};
+
+/// @brief Get the components layout of a format.
+/// @param format Element format.
+/// @return Components layout.
+static ComponentLayout getComponentLayout(Format format)
+{
+    // the formats are grouped by type, from 1 to 4 components
+    static_assert(static_cast<int>(Format::R8G8B8A8Sint) - static_cast<int>(Format::R8Sint) == 3);
+    static_assert(static_cast<int>(Format::R16Sfloat) - static_cast<int>(Format::R8Sint) == 32);
+    static_assert(static_cast<int>(Format::R32G32B32A32Sfloat) - static_cast<int>(Format::R8Sint) == 47);
+
+    constexpr std::array<std::optional<ComponentType>, 12> groups = { ComponentType::sint8, ComponentType::uint8,
+        ComponentType::unorm8, ComponentType::snorm8, ComponentType::sint16, ComponentType::uint16,
+        ComponentType::unorm16, ComponentType::snorm16, std::nullopt, ComponentType::sint32, ComponentType::uint32,
+        ComponentType::float32 };
+
+    auto index = static_cast<int>(format) - static_cast<int>(Format::R8Sint);
+    if (index < 0 || index > static_cast<int>(Format::R32G32B32A32Sfloat) - static_cast<int>(Format::R8Sint)
+        || !groups[index / 4].has_value()) {
+        return {};
+    }
+
+    return { .type = groups[index / 4].value(), .count = static_cast<uint32_t>(index % 4) + 1 };
+}
+
+/// @brief Get the size of a component.
+/// @param type Component type.
+/// @return Size in bytes.
+constexpr size_t getComponentSize(ComponentType type)
+{
+    switch (type) {
+    case ComponentType::sint8:
+    case ComponentType::uint8:
+    case ComponentType::unorm8:
+    case ComponentType::snorm8:
+        return 1;
+    case ComponentType::sint16:
+    case ComponentType::uint16:
+    case ComponentType::unorm16:
+    case ComponentType::snorm16:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+/// @brief Get the scale of the normalized components.
+/// @param type Component type.
+/// @return Scale, 1 for the components not normalized.
+constexpr float getComponentScale(ComponentType type)
+{
+    switch (type) {
+    case ComponentType::unorm8:
+        return 1.0f / 255.0f;
+    case ComponentType::snorm8:
+        return 1.0f / 127.0f;
+    case ComponentType::unorm16:
+        return 1.0f / 65535.0f;
+    case ComponentType::snorm16:
+        return 1.0f / 32767.0f;
+    default:
+        return 1.0f;
+    }
+}
+
+/// @brief Check if a component is signed normalized, the minimal value is clamped to -1.
+/// @param type Component type.
+/// @return True if signed normalized.
+constexpr bool isSignedNormalized(ComponentType type)
+{
+    return type == ComponentType::snorm8 || type == ComponentType::snorm16;
+}
+
+/// @brief Read a component.
+/// @tparam Type Component type.
+/// @param source Component data.
+/// @return Component value.
+template <ComponentType Type> static float readComponent(const uint8_t* source)
+{
+    float value = 0.0f;
+    if constexpr (Type == ComponentType::sint8 || Type == ComponentType::snorm8) {
+        value = static_cast<float>(static_cast<int8_t>(*source));
+    } else if constexpr (Type == ComponentType::uint8 || Type == ComponentType::unorm8) {
+        value = static_cast<float>(*source);
+    } else if constexpr (Type == ComponentType::sint16 || Type == ComponentType::snorm16) {
+        int16_t component = 0;
+        std::memcpy(&component, source, sizeof(int16_t));
+        value = static_cast<float>(component);
+    } else if constexpr (Type == ComponentType::uint16 || Type == ComponentType::unorm16) {
+        uint16_t component = 0;
+        std::memcpy(&component, source, sizeof(uint16_t));
+        value = static_cast<float>(component);
+    } else if constexpr (Type == ComponentType::sint32) {
+        int32_t component = 0;
+        std::memcpy(&component, source, sizeof(int32_t));
+        value = static_cast<float>(component);
+    } else if constexpr (Type == ComponentType::uint32) {
+        uint32_t component = 0;
+        std::memcpy(&component, source, sizeof(uint32_t));
+        value = static_cast<float>(component);
+    } else {
+        std::memcpy(&value, source, sizeof(float));
+    }
+
+    value *= getComponentScale(Type);
+    if constexpr (isSignedNormalized(Type)) {
+        value = std::max(value, -1.0f);
+    }
+    return value;
+}
+
+/// @brief Portable kernel, also used for the last elements of the SIMD kernels.
+template <ComponentType Type>
+static void convertScalar(const uint8_t* source, size_t sourceStride, uint32_t sourceComponents, size_t count,
+    float* destination, size_t destinationStride, uint32_t destinationComponents)
+{
+    constexpr auto componentSize = getComponentSize(Type);
+    auto* output = std::bit_cast<uint8_t*>(destination);
+    for (size_t i = 0; i < count; i++) {
+        const auto* element = source + i * sourceStride;
+        std::array<float, 4> values = { 0.0f, 0.0f, 0.0f, 1.0f };
+        for (uint32_t component = 0; component < sourceComponents; component++) {
+            values[component] = readComponent<Type>(element + component * componentSize);
+        }
+        std::memcpy(output + i * destinationStride, values.data(), destinationComponents * sizeof(float));
+    }
+}
+
+#ifdef CHR_ATTRIBUTE_X86
+
+/// @brief Store the first components of a vector.
+CHR_TARGET_SSE41 static inline void storeComponents(float* destination, __m128 values, uint32_t components)
+{
+    switch (components) {
+    case 1:
+        _mm_store_ss(destination, values);
+        break;
+    case 2:
+        _mm_storel_pi(std::bit_cast<__m64*>(destination), values);
+        break;
+    case 3:
+        _mm_storel_pi(std::bit_cast<__m64*>(destination), values);
+        _mm_store_ss(destination + 2, _mm_movehl_ps(values, values));
+        break;
+    default:
+        _mm_storeu_ps(destination, values);
+        break;
+    }
+}
+
+/// @brief Load and convert the components of an element, the missing ones are not defined.
+template <ComponentType Type> CHR_TARGET_SSE41 static inline __m128 loadSse41(const uint8_t* source)
+{
+    auto data = _mm_loadu_si128(std::bit_cast<const __m128i*>(source));
+    __m128 values = {};
+    if constexpr (Type == ComponentType::float32) {
+        return _mm_castsi128_ps(data);
+    } else if constexpr (Type == ComponentType::sint8 || Type == ComponentType::snorm8) {
+        values = _mm_cvtepi32_ps(_mm_cvtepi8_epi32(data));
+    } else if constexpr (Type == ComponentType::uint8 || Type == ComponentType::unorm8) {
+        values = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(data));
+    } else if constexpr (Type == ComponentType::sint16 || Type == ComponentType::snorm16) {
+        values = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(data));
+    } else if constexpr (Type == ComponentType::uint16 || Type == ComponentType::unorm16) {
+        values = _mm_cvtepi32_ps(_mm_cvtepu16_epi32(data));
+    } else {
+        values = _mm_cvtepi32_ps(data);
+    }
+
+    if constexpr (getComponentScale(Type) != 1.0f) {
+        values = _mm_mul_ps(values, _mm_set1_ps(getComponentScale(Type)));
+    }
+    if constexpr (isSignedNormalized(Type)) {
+        values = _mm_max_ps(values, _mm_set1_ps(-1.0f));
+    }
+    return values;
+}
+
+/// @brief SSE 4.1 kernel, one element for every iteration.
+template <ComponentType Type>
+CHR_TARGET_SSE41 static void convertSse41(const uint8_t* source, size_t sourceStride, uint32_t sourceComponents,
+    size_t count, float* destination, size_t destinationStride, uint32_t destinationComponents)
+{
+    // the components missing in the source are replaced by the defaults
+    const auto mask = _mm_castsi128_ps(_mm_cmplt_epi32(
+        _mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(static_cast<int32_t>(sourceComponents))));
+    const auto defaults = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+    auto* output = std::bit_cast<uint8_t*>(destination);
+    auto simdCount = count > SimdTailCount ? count - SimdTailCount : 0;
+    size_t i = 0;
+    for (; i < simdCount; i++) {
+        auto values = _mm_blendv_ps(defaults, loadSse41<Type>(source + i * sourceStride), mask);
+        storeComponents(std::bit_cast<float*>(output + i * destinationStride), values, destinationComponents);
+    }
+
+    convertScalar<Type>(source + i * sourceStride, sourceStride, sourceComponents, count - i,
+        std::bit_cast<float*>(output + i * destinationStride), destinationStride, destinationComponents);
+}
+
+/// @brief Load and convert the components of two elements, the missing ones are not defined.
+template <ComponentType Type> CHR_TARGET_AVX2 static inline __m256 loadAvx2(const uint8_t* first, const uint8_t* second)
+{
+    auto low = _mm_loadu_si128(std::bit_cast<const __m128i*>(first));
+    auto high = _mm_loadu_si128(std::bit_cast<const __m128i*>(second));
+    __m256 values = {};
+    if constexpr (Type == ComponentType::float32) {
+        return _mm256_castsi256_ps(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1));
+    } else if constexpr (Type == ComponentType::sint8 || Type == ComponentType::snorm8) {
+        values = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_unpacklo_epi32(low, high)));
+    } else if constexpr (Type == ComponentType::uint8 || Type == ComponentType::unorm8) {
+        values = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_unpacklo_epi32(low, high)));
+    } else if constexpr (Type == ComponentType::sint16 || Type == ComponentType::snorm16) {
+        values = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_unpacklo_epi64(low, high)));
+    } else if constexpr (Type == ComponentType::uint16 || Type == ComponentType::unorm16) {
+        values = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_unpacklo_epi64(low, high)));
+    } else {
+        values = _mm256_cvtepi32_ps(_mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1));
+    }
+
+    if constexpr (getComponentScale(Type) != 1.0f) {
+        values = _mm256_mul_ps(values, _mm256_set1_ps(getComponentScale(Type)));
+    }
+    if constexpr (isSignedNormalized(Type)) {
+        values = _mm256_max_ps(values, _mm256_set1_ps(-1.0f));
+    }
+    return values;
+}
+
+/// @brief AVX2 kernel, two elements for every iteration.
+template <ComponentType Type>
+CHR_TARGET_AVX2 static void convertAvx2(const uint8_t* source, size_t sourceStride, uint32_t sourceComponents,
+    size_t count, float* destination, size_t destinationStride, uint32_t destinationComponents)
+{
+    // the components missing in the source are replaced by the defaults
+    const auto mask = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int32_t>(sourceComponents)),
+        _mm256_setr_epi32(0, 1, 2, 3, 0, 1, 2, 3)));
+    const auto defaults = _mm256_setr_ps(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+
+    auto* output = std::bit_cast<uint8_t*>(destination);
+    auto simdCount = count > SimdTailCount + 1 ? count - SimdTailCount - 1 : 0;
+    size_t i = 0;
+    for (; i < simdCount; i += 2) {
+        const auto* element = source + i * sourceStride;
+        auto values = _mm256_blendv_ps(defaults, loadAvx2<Type>(element, element + sourceStride), mask);
+        storeComponents(std::bit_cast<float*>(output + i * destinationStride), _mm256_castps256_ps128(values),
+            destinationComponents);
+        storeComponents(std::bit_cast<float*>(output + (i + 1) * destinationStride),
+            _mm256_extractf128_ps(values, 1), destinationComponents);
+    }
+
+    convertScalar<Type>(source + i * sourceStride, sourceStride, sourceComponents, count - i,
+        std::bit_cast<float*>(output + i * destinationStride), destinationStride, destinationComponents);
+}
+
+/// @brief Detect the best instruction set supported by the CPU and the OS.
+/// @return Instruction set.
+static AttributeInstructionSet detectInstructionSet()
+{
+#ifdef _MSC_VER
+    std::array<int, 4> info = {};
+    __cpuid(info.data(), 0);
+    auto maxLeaf = info[0];
+    __cpuid(info.data(), 1);
+    auto sse41 = (info[2] & (1 << 19)) != 0;
+    auto osxsave = (info[2] & (1 << 27)) != 0;
+    auto avx = (info[2] & (1 << 28)) != 0;
+    auto avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info.data(), 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    auto sse41 = __builtin_cpu_supports("sse4.1") != 0;
+    auto avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+
+    if (avx2) {
+        return AttributeInstructionSet::avx2;
+    }
+    return sse41 ? AttributeInstructionSet::sse41 : AttributeInstructionSet::scalar;
+}
+
+#else
+
+static AttributeInstructionSet detectInstructionSet() { return AttributeInstructionSet::scalar; }
+
+#endif
+
+/// @brief Get the kernel for a component type and an instruction set.
+template <ComponentType Type> static ConvertKernel getKernel(AttributeInstructionSet instructionSet)
+{
+#ifdef CHR_ATTRIBUTE_X86
+    switch (instructionSet) {
+    case AttributeInstructionSet::avx2:
+        return convertAvx2<Type>;
+    case AttributeInstructionSet::sse41:
+        return convertSse41<Type>;
+    default:
+        break;
+    }
+#endif
+    (void)instructionSet;
+    return convertScalar<Type>;
+}
+
+/// @brief Detect the instruction set supported by the CPU, only the first time.
+static void detectOnce()
+{
+    std::call_once(AttributeConverterContext::detected, []() {
+        AttributeConverterContext::supportedInstructionSet = detectInstructionSet();
+        AttributeConverterContext::instructionSet = AttributeConverterContext::supportedInstructionSet;
+        CHRLOG_DEBUG("Attribute conversion instruction set: {}",
+            magic_enum::enum_name(AttributeConverterContext::supportedInstructionSet));
+    });
+}
+
+bool AttributeConverter::convert(const uint8_t* source, size_t sourceStride, Format sourceFormat, size_t count,
+    float* destination, size_t destinationStride, uint32_t destinationComponents)
+{
+    CHRZONE_ASSETS;
+
+    assert(destinationComponents >= 1 && destinationComponents <= 4);
+
+    auto layout = getComponentLayout(sourceFormat);
+    if (layout.count == 0) {
+        return false;
+    }
+
+    if (count == 0) {
+        return true;
+    }
+
+    auto set = instructionSet();
+
+    // the SIMD kernels read 16 bytes for every element, they need the elements 4 bytes aligned like in glTF
+    if (sourceStride < 4 || sourceStride < layout.count * getComponentSize(layout.type)) {
+        set = AttributeInstructionSet::scalar;
+    }
+
+    ConvertKernel kernel = nullptr;
+    switch (layout.type) {
+    case ComponentType::sint8:
+        kernel = getKernel<ComponentType::sint8>(set);
+        break;
+    case ComponentType::uint8:
+        kernel = getKernel<ComponentType::uint8>(set);
+        break;
+    case ComponentType::unorm8:
+        kernel = getKernel<ComponentType::unorm8>(set);
+        break;
+    case ComponentType::snorm8:
+        kernel = getKernel<ComponentType::snorm8>(set);
+        break;
+    case ComponentType::sint16:
+        kernel = getKernel<ComponentType::sint16>(set);
+        break;
+    case ComponentType::uint16:
+        kernel = getKernel<ComponentType::uint16>(set);
+        break;
+    case ComponentType::unorm16:
+        kernel = getKernel<ComponentType::unorm16>(set);
+        break;
+    case ComponentType::snorm16:
+        kernel = getKernel<ComponentType::snorm16>(set);
+        break;
+    case ComponentType::sint32:
+        kernel = getKernel<ComponentType::sint32>(set);
+        break;
+    case ComponentType::uint32:
+        // the SIMD conversion is signed, the values above 2^31 would be negative
+        kernel = convertScalar<ComponentType::uint32>;
+        break;
+    case ComponentType::float32:
+        kernel = getKernel<ComponentType::float32>(set);
+        break;
+    }
+
+    kernel(source, sourceStride, layout.count, count, destination, destinationStride, destinationComponents);
+    return true;
+}
+
+AttributeInstructionSet AttributeConverter::instructionSet()
+{
+    detectOnce();
+    return AttributeConverterContext::instructionSet.load(std::memory_order_relaxed);
+}
+
+void AttributeConverter::setInstructionSet(AttributeInstructionSet instructionSet)
+{
+    detectOnce();
+    AttributeConverterContext::instructionSet.store(
+        std::min(instructionSet, AttributeConverterContext::supportedInstructionSet), std::memory_order_relaxed);
+}
+
+} // namespace chronicle
@@ -0,0 +1,46 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "Renderer/Renderer.h"
+
+namespace chronicle {
+
+/// @brief Instruction set used by the attribute conversion kernels.
+enum class AttributeInstructionSet {
+    scalar, ///< Portable C++.
+    sse41, ///< SSE 4.1, one vertex for every iteration.
+    avx2 ///< AVX2, two vertices for every iteration.
+};
+
+/// @brief Convert the vertex attributes of an accessor to floats, interleaved in the target vertex layout.
+///        The kernel is selected at runtime for the best instruction set supported by the CPU.
+class AttributeConverter {
+public:
+    /// @brief Convert the attributes of a strided buffer.
+    ///        The integer formats are converted to their value, the normalized ones to [0, 1] or [-1, 1].
+    ///        The destination components missing in the source are 0, the fourth is 1.
+    /// @param source First element of the source.
+    /// @param sourceStride Distance between two source elements, in bytes.
+    /// @param sourceFormat Format of a source element, an 8, 16 or 32 bit format with up to 4 components.
+    /// @param count Elements count.
+    /// @param destination First destination element.
+    /// @param destinationStride Distance between two destination elements, in bytes.
+    /// @param destinationComponents Floats written for every element, between 1 and 4.
+    /// @return True if the source format is supported.
+    [[nodiscard]] static bool convert(const uint8_t* source, size_t sourceStride, Format sourceFormat, size_t count,
+        float* destination, size_t destinationStride, uint32_t destinationComponents);
+
+    /// @brief Get the instruction set used by the kernels.
+    /// @return Instruction set.
+    [[nodiscard]] static AttributeInstructionSet instructionSet();
+
+    /// @brief Force the instruction set used by the kernels, it's capped to the one supported by the CPU.
+    /// @param instructionSet Instruction set.
+    static void setInstructionSet(AttributeInstructionSet instructionSet);
+};
+
+} // namespace chronicle
@@ -0,0 +1,666 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "CookedAsset.h"
+
+namespace chronicle {
+
+constexpr uint32_t CookedAssetMagic = 0x4D524843; ///< "CHRM"
+constexpr uint32_t CookedAssetVersion = 7;
+constexpr uint64_t CookedAssetAlignment = 16; ///< Alignment for the data blobs.
+constexpr uint32_t CookedAssetMaxAttributes = 8;
+constexpr uint32_t CookedAssetMaxMipLevels = 16;
+
+/// @brief String stored in the strings blob.
+struct CookedString {
+    uint32_t offset; ///< Offset in the strings blob.
+    uint32_t length; ///< String length.
+};
+
+/// @brief Cooked asset header, at the beginning of the file.
+struct CookedHeader {
+    uint32_t magic; ///< Magic number.
+    uint32_t version; ///< Format version.
+    uint64_t fileSize; ///< Total file size.
+    uint64_t sourceSize; ///< Source file size.
+    int64_t sourceWriteTime; ///< Source file last write time.
+    uint64_t sourceOptionsHash; ///< Hash of the import options.
+    uint32_t texturesCount; ///< Textures count.
+    uint32_t materialsCount; ///< Materials count.
+    uint32_t meshesCount; ///< Meshes count.
+    uint32_t submeshesCount; ///< Submeshes count.
+    uint32_t nodesCount; ///< Nodes count.
+    uint64_t texturesOffset; ///< Textures table offset.
+    uint64_t materialsOffset; ///< Materials table offset.
+    uint64_t meshesOffset; ///< Meshes table offset.
+    uint64_t submeshesOffset; ///< Submeshes table offset.
+    uint64_t nodesOffset; ///< Nodes table offset.
+    uint64_t stringsOffset; ///< Strings blob offset.
+    uint64_t stringsSize; ///< Strings blob size.
+};
+
+/// @brief Cooked mip level.
+struct CookedMipLevel {
+    uint64_t offset; ///< Offset in the pixels.
+    uint64_t size; ///< Level size.
+};
+
+/// @brief Cooked texture.
+struct CookedTexture {
+    CookedString name; ///< Texture name.
+    uint64_t hash; ///< Texture loader hash.
+    uint64_t sourceSize; ///< Size of the encoded image, checked with the hash.
+    uint32_t magFilter; ///< Magnification filter.
+    uint32_t minFilter; ///< Minification filter.
+    uint32_t mipmapMode; ///< Mipmap mode.
+    uint32_t mipmaps; ///< Sample the mip levels.
+    uint32_t addressModeU; ///< Address mode for U coordinate.
+    uint32_t addressModeV; ///< Address mode for V coordinate.
+    uint32_t width; ///< Image width.
+    uint32_t height; ///< Image height.
+    uint32_t format; ///< Image format.
+    uint32_t mipLevelsCount; ///< Mip levels count, 0 if they are generated at load.
+    CookedMipLevel mipLevels[CookedAssetMaxMipLevels]; ///< Mip levels.
+    uint64_t pixelsOffset; ///< Pixels offset.
+    uint64_t pixelsSize; ///< Pixels size.
+};
+
+/// @brief Cooked material.
+struct CookedMaterial {
+    CookedString name; ///< Material name.
+    float baseColorFactor[4]; ///< The base color of the material.
+    float metallicFactor; ///< The metalness of the material.
+    float roughnessFactor; ///< The roughness of the material.
+    float emissiveFactor[3]; ///< The factors for the emissive color of the material.
+    uint32_t alphaMode; ///< The alpha rendering mode of the material.
+    float alphaCutoff; ///< The alpha cutoff value of the material.
+    uint32_t doubleSided; ///< Specifies whether the material is double sided.
+    int32_t baseColorTexture; ///< Base color texture index.
+    int32_t metallicRoughnessTexture; ///< Metallic-roughness texture index.
+    int32_t normalTexture; ///< Normal texture index.
+    int32_t occlusionTexture; ///< Occlusion texture index.
+    int32_t emissiveTexture; ///< Emissive texture index.
+};
+
+/// @brief Cooked mesh.
+struct CookedMesh {
+    CookedString name; ///< Mesh name.
+    uint32_t firstSubmesh; ///< First submesh in the submeshes table.
+    uint32_t submeshesCount; ///< Submeshes count.
+};
+
+/// @brief Cooked vertex attribute.
+struct CookedAttribute {
+    uint32_t format; ///< Data format.
+    uint32_t offset; ///< Offset into the vertex.
+    uint32_t location; ///< Attribute location.
+};
+
+/// @brief Cooked level of detail.
+struct CookedLod {
+    uint32_t firstIndex; ///< First index.
+    uint32_t indicesCount; ///< Indices count.
+    float error; ///< Simplification error.
+};
+
+/// @brief Cooked submesh.
+struct CookedSubmesh {
+    CookedString name; ///< Submesh name.
+    uint32_t verticesCount; ///< Vertices count.
+    uint32_t vertexStride; ///< Vertex stride.
+    uint32_t attributesCount; ///< Vertex attributes count.
+    CookedAttribute attributes[CookedAssetMaxAttributes]; ///< Vertex attributes.
+    uint64_t verticesOffset; ///< Vertices data offset.
+    uint64_t verticesSize; ///< Vertices data size.
+    uint32_t indicesCount; ///< Indices count.
+    uint32_t indexType; ///< Index type.
+    uint64_t indicesOffset; ///< Indices data offset.
+    uint64_t indicesSize; ///< Indices data size.
+    int32_t materialIndex; ///< Material index, negative for the default material.
+    uint32_t quantized; ///< Positions quantized in the bounding box.
+    float boundingBoxMin[3]; ///< Bounding box minimal value.
+    float boundingBoxMax[3]; ///< Bounding box maximum value.
+    uint32_t lodsCount; ///< Levels of detail count, 0 if the indices are a single level.
+    CookedLod lods[MaxSubmeshLods]; ///< Levels of detail.
+};
+
+/// @brief Cooked node, the parents come before their children.
+struct CookedNode {
+    CookedString name; ///< Node name.
+    int32_t parent; ///< Parent node index, negative for the root nodes.
+    int32_t mesh; ///< Mesh index, negative if the node doesn't place a mesh.
+    float localTransform[16]; ///< Transform relative to the parent, column major.
+};
+
+static_assert(std::is_trivially_copyable_v<CookedHeader>);
+static_assert(std::is_trivially_copyable_v<CookedTexture>);
+static_assert(std::is_trivially_copyable_v<CookedMaterial>);
+static_assert(std::is_trivially_copyable_v<CookedMesh>);
+static_assert(std::is_trivially_copyable_v<CookedSubmesh>);
+static_assert(std::is_trivially_copyable_v<CookedNode>);
+
+/// @brief Align a value to the next multiple of the alignment.
+constexpr uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/// @brief Check if a range is inside the data.
+static bool isInRange(std::span<const uint8_t> data, uint64_t offset, uint64_t size)
+{
+    return offset <= data.size() && size <= data.size() - offset;
+}
+
+/// @brief Get the size of an index, 0 if the index type is not valid.
+static uint64_t getIndexSize(uint32_t indexType)
+{
+    switch (static_cast<IndexType>(indexType)) {
+    case IndexType::uint8:
+        return 1;
+    case IndexType::uint16:
+        return 2;
+    case IndexType::uint32:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+/// @brief Get the size of a vertex attribute, 0 if the format is not a vertex format.
+static uint64_t getAttributeSize(uint32_t format)
+{
+    // the formats are grouped by component size, four component counts for every type
+    auto componentsOffset = [format](Format first) { return format - static_cast<uint32_t>(first); };
+    if (format >= static_cast<uint32_t>(Format::R8Sint) && format <= static_cast<uint32_t>(Format::R8G8B8A8Snorm)) {
+        return componentsOffset(Format::R8Sint) % 4 + 1;
+    }
+    if (format >= static_cast<uint32_t>(Format::R16Sint)
+        && format <= static_cast<uint32_t>(Format::R16G16B16A16Sfloat)) {
+        return (componentsOffset(Format::R16Sint) % 4 + 1) * 2;
+    }
+    if (format >= static_cast<uint32_t>(Format::R32Sint)
+        && format <= static_cast<uint32_t>(Format::R32G32B32A32Sfloat)) {
+        return (componentsOffset(Format::R32Sint) % 4 + 1) * 4;
+    }
+    return 0;
+}
+
+/// @brief Copy a table from the mapped data, checking the bounds.
+template <typename T>
+static bool readTable(std::span<const uint8_t> data, uint64_t offset, uint32_t count, std::vector<T>& table)
+{
+    if (!isInRange(data, offset, static_cast<uint64_t>(count) * sizeof(T))) {
+        return false;
+    }
+
+    table.resize(count);
+    std::memcpy(table.data(), data.data() + offset, static_cast<size_t>(count) * sizeof(T));
+    return true;
+}
+
+/// @brief Write a table in the file.
+template <typename T> static void writeTable(std::ofstream& file, const std::vector<T>& table)
+{
+    file.write(std::bit_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(T)));
+}
+
+/// @brief Write zeros up to an offset.
+static void writePadding(std::ofstream& file, uint64_t offset)
+{
+    static const std::array<char, CookedAssetAlignment> zeros = {};
+    auto position = static_cast<uint64_t>(file.tellp());
+    assert(position <= offset);
+    while (position < offset) {
+        auto size = std::min(offset - position, static_cast<uint64_t>(zeros.size()));
+        file.write(zeros.data(), static_cast<std::streamsize>(size));
+        position += size;
+    }
+}
+
+CookedAssetSource CookedAssetSource::fromFile(const std::filesystem::path& filename, uint64_t optionsHash)
+{
+    std::error_code errorCode = {};
+    CookedAssetSource source = {};
+    source.size = std::filesystem::file_size(filename, errorCode);
+    source.writeTime = std::filesystem::last_write_time(filename, errorCode).time_since_epoch().count();
+    source.optionsHash = optionsHash;
+    return source;
+}
+
+std::filesystem::path CookedAsset::cacheFilename(
+    const std::filesystem::path& sourceFilename, const std::filesystem::path& cacheDirectory)
+{
+    auto sourcePath = std::filesystem::absolute(sourceFilename).lexically_normal();
+    return cacheDirectory / fmt::format("{:016x}.chrmesh", std::hash<std::string>()(sourcePath.generic_string()));
+}
+
+void CookedAsset::write(
+    const std::filesystem::path& filename, const AssetData& assetData, const CookedAssetSource& source)
+{
+    CHRZONE_ASSETS;
+
+    CHRLOG_DEBUG("Write cooked asset: {}", filename.string());
+
+    std::string strings = {};
+    auto addString = [&strings](const std::string& value) {
+        CookedString cookedString = { static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size()) };
+        strings += value;
+        return cookedString;
+    };
+
+    // the blobs offsets are relative to the blobs section, fixed when the tables size is known
+    std::vector<std::pair<uint64_t, std::span<const uint8_t>>> blobs = {};
+    uint64_t blobsSize = 0;
+    auto addBlob = [&blobs, &blobsSize](std::span<const uint8_t> data) {
+        auto offset = alignUp(blobsSize, CookedAssetAlignment);
+        blobs.emplace_back(offset, data);
+        blobsSize = offset + data.size();
+        return offset;
+    };
+
+    // textures, the images shared by multiple textures are stored once
+    std::unordered_map<const uint8_t*, uint64_t> imageOffsets = {};
+    std::vector<CookedTexture> textures(assetData.textures.size());
+    for (size_t textureIndex = 0; textureIndex < assetData.textures.size(); textureIndex++) {
+        const auto& textureData = assetData.textures[textureIndex];
+        auto& texture = textures[textureIndex];
+        texture.name = addString(textureData.name);
+        texture.hash = textureData.hash;
+        texture.sourceSize = textureData.sourceSize;
+        texture.magFilter = static_cast<uint32_t>(textureData.sampler.magFilter);
+        texture.minFilter = static_cast<uint32_t>(textureData.sampler.minFilter);
+        texture.mipmapMode = static_cast<uint32_t>(textureData.sampler.mipmapMode);
+        texture.mipmaps = textureData.sampler.mipmaps ? 1 : 0;
+        texture.addressModeU = static_cast<uint32_t>(textureData.sampler.addressModeU);
+        texture.addressModeV = static_cast<uint32_t>(textureData.sampler.addressModeV);
+        texture.width = textureData.width;
+        texture.height = textureData.height;
+        texture.format = static_cast<uint32_t>(textureData.format);
+        texture.mipLevelsCount
+            = static_cast<uint32_t>(std::min<size_t>(textureData.mipLevels.size(), CookedAssetMaxMipLevels));
+        for (uint32_t i = 0; i < texture.mipLevelsCount; i++) {
+            texture.mipLevels[i] = { .offset = textureData.mipLevels[i].offset, .size = textureData.mipLevels[i].size };
+        }
+        texture.pixelsSize = textureData.pixels.size();
+        if (auto it = imageOffsets.find(textureData.pixels.data()); it != imageOffsets.end()) {
+            texture.pixelsOffset = it->second;
+        } else {
+            texture.pixelsOffset = addBlob(textureData.pixels);
+            imageOffsets[textureData.pixels.data()] = texture.pixelsOffset;
+        }
+    }
+
+    // materials
+    std::vector<CookedMaterial> materials(assetData.materials.size());
+    for (size_t materialIndex = 0; materialIndex < assetData.materials.size(); materialIndex++) {
+        const auto& materialData = assetData.materials[materialIndex];
+        auto& material = materials[materialIndex];
+        material.name = addString(materialData.name);
+        std::memcpy(material.baseColorFactor, glm::value_ptr(materialData.baseColorFactor), sizeof(float) * 4);
+        material.metallicFactor = materialData.metallicFactor;
+        material.roughnessFactor = materialData.roughnessFactor;
+        std::memcpy(material.emissiveFactor, glm::value_ptr(materialData.emissiveFactor), sizeof(float) * 3);
+        material.alphaMode = static_cast<uint32_t>(materialData.alphaMode);
+        material.alphaCutoff = materialData.alphaCutoff;
+        material.doubleSided = materialData.doubleSided ? 1 : 0;
+        material.baseColorTexture = materialData.baseColorTexture;
+        material.metallicRoughnessTexture = materialData.metallicRoughnessTexture;
+        material.normalTexture = materialData.normalTexture;
+        material.occlusionTexture = materialData.occlusionTexture;
+        material.emissiveTexture = materialData.emissiveTexture;
+    }
+
+    // meshes and submeshes, the invalid submeshes are not stored
+    std::vector<CookedMesh> meshes(assetData.meshes.size());
+    std::vector<CookedSubmesh> submeshes = {};
+    for (size_t meshIndex = 0; meshIndex < assetData.meshes.size(); meshIndex++) {
+        const auto& meshData = assetData.meshes[meshIndex];
+        auto& mesh = meshes[meshIndex];
+        mesh.name = addString(meshData.name);
+        mesh.firstSubmesh = static_cast<uint32_t>(submeshes.size());
+
+        for (const auto& submeshData : meshData.submeshes) {
+            if (!submeshData.valid) {
+                continue;
+            }
+
+            if (submeshData.vertexBufferInfo.attributeDescriptions.size() > CookedAssetMaxAttributes) {
+                throw StorageError(fmt::format("Too many vertex attributes in {}", submeshData.name));
+            }
+
+            CookedSubmesh submesh = {};
+            submesh.name = addString(submeshData.name);
+            submesh.verticesCount = submeshData.verticesCount;
+            submesh.vertexStride = submeshData.vertexBufferInfo.stride;
+            submesh.attributesCount = static_cast<uint32_t>(submeshData.vertexBufferInfo.attributeDescriptions.size());
+            for (uint32_t i = 0; i < submesh.attributesCount; i++) {
+                const auto& attribute = submeshData.vertexBufferInfo.attributeDescriptions[i];
+                submesh.attributes[i] = { .format = static_cast<uint32_t>(attribute.format),
+                    .offset = attribute.offset,
+                    .location = attribute.location };
+            }
+            submesh.verticesSize = submeshData.vertices().size();
+            submesh.verticesOffset = addBlob(submeshData.vertices());
+            submesh.indicesCount = submeshData.indicesCount;
+            submesh.indexType = static_cast<uint32_t>(submeshData.indexType);
+            submesh.indicesSize = submeshData.indices().size();
+            submesh.indicesOffset = addBlob(submeshData.indices());
+            submesh.materialIndex = submeshData.materialIndex;
+            submesh.quantized = submeshData.quantized ? 1 : 0;
+            std::memcpy(submesh.boundingBoxMin, glm::value_ptr(submeshData.boundingBox.min), sizeof(float) * 3);
+            std::memcpy(submesh.boundingBoxMax, glm::value_ptr(submeshData.boundingBox.max), sizeof(float) * 3);
+            submesh.lodsCount = static_cast<uint32_t>(std::min<size_t>(submeshData.lods.size(), MaxSubmeshLods));
+            for (uint32_t i = 0; i < submesh.lodsCount; i++) {
+                const auto& lod = submeshData.lods[i];
+                submesh.lods[i]
+                    = { .firstIndex = lod.firstIndex, .indicesCount = lod.indicesCount, .error = lod.error };
+            }
+            submeshes.push_back(submesh);
+        }
+
+        mesh.submeshesCount = static_cast<uint32_t>(submeshes.size()) - mesh.firstSubmesh;
+    }
+
+    // nodes, the world transforms are calculated on read
+    std::vector<CookedNode> nodes(assetData.nodes.size());
+    for (size_t nodeIndex = 0; nodeIndex < assetData.nodes.size(); nodeIndex++) {
+        const auto& nodeData = assetData.nodes[nodeIndex];
+        auto& node = nodes[nodeIndex];
+        node.name = addString(nodeData.name);
+        node.parent = nodeData.parent;
+        node.mesh = nodeData.mesh;
+        std::memcpy(node.localTransform, glm::value_ptr(nodeData.localTransform), sizeof(float) * 16);
+    }
+
+    // calculate the layout
+    CookedHeader header = {};
+    header.magic = CookedAssetMagic;
+    header.version = CookedAssetVersion;
+    header.sourceSize = source.size;
+    header.sourceWriteTime = source.writeTime;
+    header.sourceOptionsHash = source.optionsHash;
+    header.texturesCount = static_cast<uint32_t>(textures.size());
+    header.materialsCount = static_cast<uint32_t>(materials.size());
+    header.meshesCount = static_cast<uint32_t>(meshes.size());
+    header.submeshesCount = static_cast<uint32_t>(submeshes.size());
+    header.nodesCount = static_cast<uint32_t>(nodes.size());
+    header.texturesOffset = alignUp(sizeof(CookedHeader), 8);
+    header.materialsOffset = alignUp(header.texturesOffset + textures.size() * sizeof(CookedTexture), 8);
+    header.meshesOffset = alignUp(header.materialsOffset + materials.size() * sizeof(CookedMaterial), 8);
+    header.submeshesOffset = alignUp(header.meshesOffset + meshes.size() * sizeof(CookedMesh), 8);
+    header.nodesOffset = alignUp(header.submeshesOffset + submeshes.size() * sizeof(CookedSubmesh), 8);
+    header.stringsOffset = alignUp(header.nodesOffset + nodes.size() * sizeof(CookedNode), 8);
+    header.stringsSize = strings.size();
+
+    auto blobsOffset = alignUp(header.stringsOffset + header.stringsSize, CookedAssetAlignment);
+    header.fileSize = blobsOffset + blobsSize;
+
+    for (auto& texture : textures) {
+        texture.pixelsOffset += blobsOffset;
+    }
+    for (auto& submesh : submeshes) {
+        submesh.verticesOffset += blobsOffset;
+        submesh.indicesOffset += blobsOffset;
+    }
+
+    // write in a temporary file, so a failed write never leave a broken cooked asset
+    std::filesystem::create_directories(filename.parent_path());
+    auto temporaryFilename = filename;
+    temporaryFilename += ".tmp";
+
+    {
+        std::ofstream file(temporaryFilename, std::ios::binary | std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+            throw StorageError(fmt::format("Failed to open file {}", temporaryFilename.string()));
+
+        file.write(std::bit_cast<const char*>(&header), sizeof(CookedHeader));
+        writePadding(file, header.texturesOffset);
+        writeTable(file, textures);
+        writePadding(file, header.materialsOffset);
+        writeTable(file, materials);
+        writePadding(file, header.meshesOffset);
+        writeTable(file, meshes);
+        writePadding(file, header.submeshesOffset);
+        writeTable(file, submeshes);
+        writePadding(file, header.nodesOffset);
+        writeTable(file, nodes);
+        writePadding(file, header.stringsOffset);
+        file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+        for (const auto& [offset, data] : blobs) {
+            writePadding(file, blobsOffset + offset);
+            file.write(std::bit_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        }
+
+        if (!file.good())
+            throw StorageError(fmt::format("Failed to write file {}", temporaryFilename.string()));
+    }
+
+    std::filesystem::rename(temporaryFilename, filename);
+}
+
+bool CookedAsset::read(
+    const std::filesystem::path& filename, AssetData& assetData, const std::optional<CookedAssetSource>& source)
+{
+    CHRZONE_ASSETS;
+
+    if (!std::filesystem::exists(filename)) {
+        return false;
+    }
+
+    CHRLOG_DEBUG("Read cooked asset: {}", filename.string());
+
+    MappedFileRef mappedFile = {};
+    try {
+        mappedFile = MappedFile::open(filename);
+    } catch (const StorageError& error) {
+        CHRLOG_WARN("{}", error.what());
+        return false;
+    }
+
+    auto data = mappedFile->span();
+
+    // check the header
+    CookedHeader header = {};
+    if (data.size() < sizeof(CookedHeader)) {
+        CHRLOG_WARN("Invalid cooked asset {}", filename.string());
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(CookedHeader));
+
+    if (header.magic != CookedAssetMagic || header.version != CookedAssetVersion || header.fileSize != data.size()) {
+        CHRLOG_WARN("Invalid cooked asset {}", filename.string());
+        return false;
+    }
+
+    if (source.has_value()
+        && (header.sourceSize != source->size || header.sourceWriteTime != source->writeTime
+            || header.sourceOptionsHash != source->optionsHash)) {
+        CHRLOG_DEBUG("Cooked asset {} is out of date", filename.string());
+        return false;
+    }
+
+    // read the tables
+    std::vector<CookedTexture> textures = {};
+    std::vector<CookedMaterial> materials = {};
+    std::vector<CookedMesh> meshes = {};
+    std::vector<CookedSubmesh> submeshes = {};
+    std::vector<CookedNode> nodes = {};
+    if (!readTable(data, header.texturesOffset, header.texturesCount, textures)
+        || !readTable(data, header.materialsOffset, header.materialsCount, materials)
+        || !readTable(data, header.meshesOffset, header.meshesCount, meshes)
+        || !readTable(data, header.submeshesOffset, header.submeshesCount, submeshes)
+        || !readTable(data, header.nodesOffset, header.nodesCount, nodes)
+        || !isInRange(data, header.stringsOffset, header.stringsSize)) {
+        CHRLOG_WARN("Invalid cooked asset {}", filename.string());
+        return false;
+    }
+
+    auto strings = data.subspan(header.stringsOffset, header.stringsSize);
+    auto getString = [&strings](const CookedString& cookedString) {
+        if (!isInRange(strings, cookedString.offset, cookedString.length)) {
+            return std::string();
+        }
+        return std::string(std::bit_cast<const char*>(strings.data()) + cookedString.offset, cookedString.length);
+    };
+
+    AssetData cookedData = {};
+
+    // textures
+    cookedData.textures.resize(textures.size());
+    for (size_t textureIndex = 0; textureIndex < textures.size(); textureIndex++) {
+        const auto& texture = textures[textureIndex];
+        auto format = magic_enum::enum_cast<Format>(texture.format);
+        auto isInvalidMipLevel = [&texture](const CookedMipLevel& mipLevel) {
+            return mipLevel.offset > texture.pixelsSize || mipLevel.size > texture.pixelsSize - mipLevel.offset;
+        };
+
+        // the uncompressed textures without levels generate their mipmaps, the others have all the levels
+        auto isGenerated = format == Format::R8G8B8A8Unorm && texture.mipLevelsCount == 0;
+        if (!isInRange(data, texture.pixelsOffset, texture.pixelsSize) || !format.has_value()
+            || texture.mipLevelsCount > CookedAssetMaxMipLevels
+            || (isGenerated && texture.pixelsSize != static_cast<uint64_t>(texture.width) * texture.height * 4)
+            || (!isGenerated && texture.mipLevelsCount == 0)
+            || std::any_of(texture.mipLevels, texture.mipLevels + texture.mipLevelsCount, isInvalidMipLevel)) {
+            CHRLOG_WARN("Invalid texture in cooked asset {}", filename.string());
+            return false;
+        }
+
+        auto& textureData = cookedData.textures[textureIndex];
+        textureData.name = getString(texture.name);
+        textureData.hash = static_cast<size_t>(texture.hash);
+        textureData.sourceSize = texture.sourceSize;
+        textureData.sampler = { .magFilter = static_cast<Filter>(texture.magFilter),
+            .minFilter = static_cast<Filter>(texture.minFilter),
+            .mipmapMode = static_cast<SamplerMipmapMode>(texture.mipmapMode),
+            .mipmaps = texture.mipmaps != 0,
+            .addressModeU = static_cast<SamplerAddressMode>(texture.addressModeU),
+            .addressModeV = static_cast<SamplerAddressMode>(texture.addressModeV) };
+        textureData.width = texture.width;
+        textureData.height = texture.height;
+        textureData.format = format.value();
+        textureData.mipLevels.resize(texture.mipLevelsCount);
+        for (uint32_t i = 0; i < texture.mipLevelsCount; i++) {
+            textureData.mipLevels[i] = { .offset = texture.mipLevels[i].offset, .size = texture.mipLevels[i].size };
+        }
+        textureData.pixels = data.subspan(texture.pixelsOffset, texture.pixelsSize);
+    }
+
+    // materials
+    cookedData.materials.resize(materials.size());
+    for (size_t materialIndex = 0; materialIndex < materials.size(); materialIndex++) {
+        const auto& material = materials[materialIndex];
+        auto& materialData = cookedData.materials[materialIndex];
+        materialData.name = getString(material.name);
+        materialData.baseColorFactor = glm::make_vec4(material.baseColorFactor);
+        materialData.metallicFactor = material.metallicFactor;
+        materialData.roughnessFactor = material.roughnessFactor;
+        materialData.emissiveFactor = glm::make_vec3(material.emissiveFactor);
+        materialData.alphaMode = static_cast<AlphaMode>(material.alphaMode);
+        materialData.alphaCutoff = material.alphaCutoff;
+        materialData.doubleSided = material.doubleSided != 0;
+        materialData.baseColorTexture = material.baseColorTexture;
+        materialData.metallicRoughnessTexture = material.metallicRoughnessTexture;
+        materialData.normalTexture = material.normalTexture;
+        materialData.occlusionTexture = material.occlusionTexture;
+        materialData.emissiveTexture = material.emissiveTexture;
+
+        for (auto textureIndex : { material.baseColorTexture, material.metallicRoughnessTexture,
+                 material.normalTexture, material.occlusionTexture, material.emissiveTexture }) {
+            if (textureIndex >= static_cast<int32_t>(textures.size())) {
+                CHRLOG_WARN("Invalid material in cooked asset {}", filename.string());
+                return false;
+            }
+        }
+    }
+
+    // meshes, the vertices and the indices reference the mapped file
+    cookedData.meshes.resize(meshes.size());
+    for (size_t meshIndex = 0; meshIndex < meshes.size(); meshIndex++) {
+        const auto& mesh = meshes[meshIndex];
+        if (static_cast<uint64_t>(mesh.firstSubmesh) + mesh.submeshesCount > submeshes.size()) {
+            CHRLOG_WARN("Invalid mesh in cooked asset {}", filename.string());
+            return false;
+        }
+
+        auto& meshData = cookedData.meshes[meshIndex];
+        meshData.name = getString(mesh.name);
+        meshData.submeshes.resize(mesh.submeshesCount);
+
+        for (uint32_t i = 0; i < mesh.submeshesCount; i++) {
+            const auto& submesh = submeshes[mesh.firstSubmesh + i];
+            auto isInvalidLod = [&submesh](const CookedLod& lod) {
+                return static_cast<uint64_t>(lod.firstIndex) + lod.indicesCount > submesh.indicesCount;
+            };
+            auto isInvalidAttribute = [&submesh](const CookedAttribute& attribute) {
+                auto attributeSize = getAttributeSize(attribute.format);
+                return attributeSize == 0 || attribute.offset + attributeSize > submesh.vertexStride;
+            };
+            // the non-indexed primitives have an undefined index type and no indices
+            auto indexSize = getIndexSize(submesh.indexType);
+            auto isNonIndexed = submesh.indexType == static_cast<uint32_t>(IndexType::undefined)
+                && submesh.indicesCount == 0 && submesh.indicesSize == 0;
+            if (submesh.attributesCount > CookedAssetMaxAttributes || submesh.lodsCount > MaxSubmeshLods
+                || std::any_of(submesh.lods, submesh.lods + submesh.lodsCount, isInvalidLod)
+                || std::any_of(submesh.attributes, submesh.attributes + submesh.attributesCount, isInvalidAttribute)
+                || submesh.verticesSize != static_cast<uint64_t>(submesh.verticesCount) * submesh.vertexStride
+                || (indexSize == 0 && !isNonIndexed) || submesh.indicesSize != submesh.indicesCount * indexSize
+                || !isInRange(data, submesh.verticesOffset, submesh.verticesSize)
+                || !isInRange(data, submesh.indicesOffset, submesh.indicesSize)
+                || submesh.materialIndex >= static_cast<int32_t>(materials.size())) {
+                CHRLOG_WARN("Invalid submesh in cooked asset {}", filename.string());
+                return false;
+            }
+
+            auto& submeshData = meshData.submeshes[i];
+            submeshData.name = getString(submesh.name);
+            submeshData.vertexView = data.subspan(submesh.verticesOffset, submesh.verticesSize);
+            submeshData.verticesCount = submesh.verticesCount;
+            submeshData.vertexBufferInfo.stride = submesh.vertexStride;
+            for (uint32_t attributeIndex = 0; attributeIndex < submesh.attributesCount; attributeIndex++) {
+                const auto& attribute = submesh.attributes[attributeIndex];
+                submeshData.vertexBufferInfo.attributeDescriptions.push_back({ .format
+                    = static_cast<Format>(attribute.format),
+                    .offset = attribute.offset,
+                    .location = attribute.location });
+            }
+            submeshData.boundingBox.min = glm::make_vec3(submesh.boundingBoxMin);
+            submeshData.boundingBox.max = glm::make_vec3(submesh.boundingBoxMax);
+            submeshData.indexView = data.subspan(submesh.indicesOffset, submesh.indicesSize);
+            submeshData.indicesCount = submesh.indicesCount;
+            submeshData.indexType = static_cast<IndexType>(submesh.indexType);
+            submeshData.materialIndex = submesh.materialIndex;
+            submeshData.quantized = submesh.quantized != 0;
+            for (uint32_t lodIndex = 0; lodIndex < submesh.lodsCount; lodIndex++) {
+                const auto& lod = submesh.lods[lodIndex];
+                submeshData.lods.push_back(
+                    { .firstIndex = lod.firstIndex, .indicesCount = lod.indicesCount, .error = lod.error });
+            }
+        }
+    }
+
+    // nodes, the parents are already read when their children are
+    cookedData.nodes.resize(nodes.size());
+    for (size_t nodeIndex = 0; nodeIndex < nodes.size(); nodeIndex++) {
+        const auto& node = nodes[nodeIndex];
+        if (node.parent >= static_cast<int32_t>(nodeIndex) || node.mesh >= static_cast<int32_t>(meshes.size())) {
+            CHRLOG_WARN("Invalid node in cooked asset {}", filename.string());
+            return false;
+        }
+
+        auto& nodeData = cookedData.nodes[nodeIndex];
+        nodeData.name = getString(node.name);
+        nodeData.parent = std::max(node.parent, -1);
+        nodeData.mesh = std::max(node.mesh, -1);
+        nodeData.localTransform = glm::make_mat4(node.localTransform);
+        nodeData.worldTransform = nodeData.parent < 0
+            ? nodeData.localTransform
+            : cookedData.nodes[nodeData.parent].worldTransform * nodeData.localTransform;
+    }
+
+    cookedData.mappedFiles.push_back(std::move(mappedFile));
+    assetData = std::move(cookedData);
+    return true;
+}
+
+} // namespace chronicle
@@ -0,0 +1,55 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "AssetData.h"
+
+namespace chronicle {
+
+/// @brief Informations about the source of a cooked asset, used to check if it's up to date.
+struct CookedAssetSource {
+    uint64_t size { 0 }; ///< Source file size.
+    int64_t writeTime { 0 }; ///< Source file last write time.
+    uint64_t optionsHash { 0 }; ///< Hash of the import options that change the cooked data.
+
+    /// @brief Get the informations for a source file.
+    /// @param filename Source filename.
+    /// @param optionsHash Hash of the import options that change the cooked data.
+    /// @return Source informations.
+    [[nodiscard]] static CookedAssetSource fromFile(const std::filesystem::path& filename, uint64_t optionsHash);
+
+    auto operator<=>(const CookedAssetSource&) const = default;
+};
+
+/// @brief Reader and writer for the cooked assets.
+///        A cooked asset is a memory mappable binary copy of the imported data: vertices, indices, layouts, bounds,
+///        materials and RGBA8 images are stored already converted, so loading it doesn't require any parsing.
+class CookedAsset {
+public:
+    /// @brief Get the filename used to cache the cooked version of an asset.
+    /// @param sourceFilename Source filename.
+    /// @param cacheDirectory Cache directory.
+    /// @return Cooked filename.
+    [[nodiscard]] static std::filesystem::path cacheFilename(
+        const std::filesystem::path& sourceFilename, const std::filesystem::path& cacheDirectory);
+
+    /// @brief Write the cooked asset.
+    /// @param filename Cooked filename.
+    /// @param assetData Asset data.
+    /// @param source Source informations.
+    static void write(
+        const std::filesystem::path& filename, const AssetData& assetData, const CookedAssetSource& source);
+
+    /// @brief Map a cooked asset, the asset data reference the mapped file.
+    /// @param filename Cooked filename.
+    /// @param assetData Asset data.
+    /// @param source Expected source informations, if available the asset is rejected when not up to date.
+    /// @return True if the asset is valid and loaded.
+    [[nodiscard]] static bool read(const std::filesystem::path& filename, AssetData& assetData,
+        const std::optional<CookedAssetSource>& source = {});
+};
+
+} // namespace chronicle
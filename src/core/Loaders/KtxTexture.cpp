@@ -0,0 +1,283 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "KtxTexture.h"
+
+namespace chronicle {
+
+constexpr std::array<uint8_t, 12> KtxIdentifier
+    = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A }; ///< "«KTX 20»\r\n\x1A\n"
+
+constexpr uint32_t KtxSupercompressionNone = 0;
+constexpr uint32_t KtxSupercompressionBasisLZ = 1;
+
+// data format descriptor values (Khronos Data Format Specification)
+constexpr uint32_t KtxDfdVersion = 2;
+constexpr uint32_t KtxDfdColorModelRgbsda = 1;
+constexpr uint32_t KtxDfdPrimariesBt709 = 1;
+constexpr uint32_t KtxDfdTransferLinear = 1;
+constexpr uint32_t KtxDfdTransferSrgb = 2;
+constexpr uint32_t KtxDfdChannelAlpha = 15;
+constexpr uint32_t KtxDfdChannelLinear = 0x10; ///< Qualifier of the alpha sample in the sRGB textures.
+
+/// @brief KTX2 file header, followed by the level index.
+struct KtxHeader {
+    uint8_t identifier[12]; ///< File identifier.
+    uint32_t vkFormat; ///< Vulkan format, undefined for the Basis Universal textures.
+    uint32_t typeSize; ///< Size of the data type, 1 for the block compressed formats.
+    uint32_t pixelWidth; ///< Texture width.
+    uint32_t pixelHeight; ///< Texture height, 0 for the 1D textures.
+    uint32_t pixelDepth; ///< Texture depth, 0 for the 2D textures.
+    uint32_t layerCount; ///< Array layers, 0 if it's not an array.
+    uint32_t faceCount; ///< Faces, 6 for the cubemaps.
+    uint32_t levelCount; ///< Mip levels, 0 if they must be generated.
+    uint32_t supercompressionScheme; ///< Supercompression scheme.
+    uint32_t dfdByteOffset; ///< Data format descriptor offset.
+    uint32_t dfdByteLength; ///< Data format descriptor size.
+    uint32_t kvdByteOffset; ///< Key/value data offset.
+    uint32_t kvdByteLength; ///< Key/value data size.
+    uint64_t sgdByteOffset; ///< Supercompression global data offset.
+    uint64_t sgdByteLength; ///< Supercompression global data size.
+};
+
+/// @brief KTX2 level index entry.
+struct KtxLevel {
+    uint64_t byteOffset; ///< Level data offset.
+    uint64_t byteLength; ///< Level data size.
+    uint64_t uncompressedByteLength; ///< Level data size without supercompression.
+};
+
+static_assert(sizeof(KtxHeader) == 80);
+static_assert(sizeof(KtxLevel) == 24);
+
+/// @brief Block size of a format.
+struct KtxBlockInfo {
+    uint32_t width { 1 }; ///< Block width, in texels.
+    uint32_t height { 1 }; ///< Block height, in texels.
+    uint32_t size { 0 }; ///< Block size, in bytes.
+};
+
+/// @brief Get the format of a KTX2 texture.
+///        The sRGB formats are read as UNORM, like the other textures.
+/// @param vkFormat Vulkan format.
+/// @return Texture format, undefined if not supported.
+static Format getFormat(uint32_t vkFormat)
+{
+    switch (vkFormat) {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+        return Format::R8G8B8A8Unorm;
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+        return Format::BC1RgbaUnorm;
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+        return Format::BC3Unorm;
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+        return Format::BC4Unorm;
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+        return Format::BC5Unorm;
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+        return Format::BC7Unorm;
+    case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        return Format::ETC2R8G8B8Unorm;
+    case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK:
+    case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        return Format::ETC2R8G8B8A8Unorm;
+    case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+    case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+        return Format::ASTC4x4Unorm;
+    default:
+        return Format::undefined;
+    }
+}
+
+/// @brief Get the block size of a texture format.
+/// @param format Texture format.
+/// @return Block size.
+static KtxBlockInfo getBlockInfo(Format format)
+{
+    switch (format) {
+    case Format::R8G8B8A8Unorm:
+        return { .width = 1, .height = 1, .size = 4 };
+    case Format::BC1RgbaUnorm:
+    case Format::BC4Unorm:
+    case Format::ETC2R8G8B8Unorm:
+        return { .width = 4, .height = 4, .size = 8 };
+    case Format::BC3Unorm:
+    case Format::BC5Unorm:
+    case Format::BC7Unorm:
+    case Format::ETC2R8G8B8A8Unorm:
+    case Format::ASTC4x4Unorm:
+        return { .width = 4, .height = 4, .size = 16 };
+    default:
+        return {};
+    }
+}
+
+/// @brief Get the size of a mip level.
+/// @param format Texture format.
+/// @param width Level width.
+/// @param height Level height.
+/// @return Level size, in bytes.
+static uint64_t getLevelSize(Format format, uint32_t width, uint32_t height)
+{
+    auto blockInfo = getBlockInfo(format);
+    uint64_t blocksX = (width + blockInfo.width - 1) / blockInfo.width;
+    uint64_t blocksY = (height + blockInfo.height - 1) / blockInfo.height;
+    return blocksX * blocksY * blockInfo.size;
+}
+
+bool KtxTexture::isKtx2(std::span<const uint8_t> data)
+{
+    return data.size() >= KtxIdentifier.size() && std::equal(KtxIdentifier.begin(), KtxIdentifier.end(), data.begin());
+}
+
+bool KtxTexture::read(std::span<const uint8_t> data, KtxTextureData& textureData)
+{
+    CHRZONE_ASSETS;
+
+    if (!isKtx2(data) || data.size() < sizeof(KtxHeader)) {
+        CHRLOG_ERROR("Invalid KTX2 texture");
+        return false;
+    }
+
+    KtxHeader header = {};
+    std::memcpy(&header, data.data(), sizeof(KtxHeader));
+
+    // only the 2D textures
+    if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth > 1 || header.layerCount > 1
+        || header.faceCount != 1) {
+        CHRLOG_ERROR("Unsupported KTX2 texture type: {}x{}x{}, {} layers, {} faces", header.pixelWidth,
+            header.pixelHeight, header.pixelDepth, header.layerCount, header.faceCount);
+        return false;
+    }
+
+    // the Basis Universal textures have an undefined format, there is no transcoder in the build
+    if (header.vkFormat == VK_FORMAT_UNDEFINED || header.supercompressionScheme == KtxSupercompressionBasisLZ) {
+        CHRLOG_ERROR("Unsupported KTX2 texture: Basis Universal textures can't be transcoded");
+        return false;
+    }
+
+    auto format = getFormat(header.vkFormat);
+    if (format == Format::undefined) {
+        CHRLOG_ERROR("Unsupported KTX2 format: {}", header.vkFormat);
+        return false;
+    }
+
+    if (header.supercompressionScheme != KtxSupercompressionNone) {
+        CHRLOG_ERROR("Unsupported KTX2 supercompression scheme: {}", header.supercompressionScheme);
+        return false;
+    }
+
+    // a full mip chain has floor(log2(max(width, height))) + 1 levels
+    auto levelCount = std::max(header.levelCount, 1u);
+    if (levelCount > static_cast<uint32_t>(std::bit_width(std::max(header.pixelWidth, header.pixelHeight)))) {
+        CHRLOG_ERROR("Invalid KTX2 level count: {}", header.levelCount);
+        return false;
+    }
+
+    if (data.size() < sizeof(KtxHeader) + levelCount * sizeof(KtxLevel)) {
+        CHRLOG_ERROR("Invalid KTX2 level index");
+        return false;
+    }
+
+    // the levels are stored from the smallest, they are copied from the largest
+    std::vector<KtxLevel> levels(levelCount);
+    std::memcpy(levels.data(), data.data() + sizeof(KtxHeader), levelCount * sizeof(KtxLevel));
+
+    textureData.format = format;
+    textureData.width = header.pixelWidth;
+    textureData.height = header.pixelHeight;
+    textureData.mipLevels.clear();
+    textureData.data.clear();
+
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const auto& levelIndex = levels[level];
+        auto levelSize = getLevelSize(format, std::max(header.pixelWidth >> level, 1u),
+            std::max(header.pixelHeight >> level, 1u));
+        if (levelIndex.byteLength != levelSize || levelIndex.byteOffset > data.size()
+            || levelIndex.byteLength > data.size() - levelIndex.byteOffset) {
+            CHRLOG_ERROR("Invalid KTX2 level {}", level);
+            return false;
+        }
+
+        textureData.mipLevels.push_back({ .offset = textureData.data.size(), .size = levelIndex.byteLength });
+        textureData.data.insert(textureData.data.end(), data.begin() + levelIndex.byteOffset,
+            data.begin() + levelIndex.byteOffset + levelIndex.byteLength);
+    }
+
+    // the uncompressed textures without levels can have them generated
+    if (header.levelCount == 0 && format == Format::R8G8B8A8Unorm) {
+        textureData.mipLevels.clear();
+    }
+
+    return true;
+}
+
+std::vector<uint8_t> KtxTexture::write(const KtxTextureData& textureData, bool srgb)
+{
+    CHRZONE_ASSETS;
+
+    assert(textureData.format == Format::R8G8B8A8Unorm);
+    assert(!textureData.mipLevels.empty());
+
+    auto levelCount = static_cast<uint32_t>(textureData.mipLevels.size());
+
+    // basic data format descriptor, one sample for every channel
+    std::vector<uint32_t> dfd = {};
+    dfd.push_back(0); // total size
+    dfd.push_back(0); // vendor and descriptor type
+    dfd.push_back(KtxDfdVersion | ((24 + 4 * 16) << 16));
+    dfd.push_back(KtxDfdColorModelRgbsda | (KtxDfdPrimariesBt709 << 8)
+        | ((srgb ? KtxDfdTransferSrgb : KtxDfdTransferLinear) << 16));
+    dfd.push_back(0); // texel block 1x1x1x1
+    dfd.push_back(4); // bytes of the plane 0
+    dfd.push_back(0);
+    for (uint32_t channel = 0; channel < 4; channel++) {
+        uint32_t channelType = channel < 3 ? channel : KtxDfdChannelAlpha | (srgb ? KtxDfdChannelLinear : 0);
+        dfd.push_back((channel * 8) | (7 << 16) | (channelType << 24));
+        dfd.push_back(0); // sample position
+        dfd.push_back(0); // lower
+        dfd.push_back(255); // upper
+    }
+    dfd[0] = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+
+    KtxHeader header = {};
+    std::copy(KtxIdentifier.begin(), KtxIdentifier.end(), header.identifier);
+    header.vkFormat = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    header.typeSize = 1;
+    header.pixelWidth = textureData.width;
+    header.pixelHeight = textureData.height;
+    header.faceCount = 1;
+    header.levelCount = levelCount;
+    header.supercompressionScheme = KtxSupercompressionNone;
+    header.dfdByteOffset = static_cast<uint32_t>(sizeof(KtxHeader) + levelCount * sizeof(KtxLevel));
+    header.dfdByteLength = dfd[0];
+
+    // the levels are stored from the smallest, aligned to the texel size
+    std::vector<KtxLevel> levels(levelCount);
+    uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+    for (auto level = static_cast<int32_t>(levelCount) - 1; level >= 0; level--) {
+        offset = (offset + 3) & ~uint64_t(3);
+        levels[level].byteOffset = offset;
+        levels[level].byteLength = textureData.mipLevels[level].size;
+        levels[level].uncompressedByteLength = textureData.mipLevels[level].size;
+        offset += textureData.mipLevels[level].size;
+    }
+
+    std::vector<uint8_t> data(offset, 0);
+    std::memcpy(data.data(), &header, sizeof(KtxHeader));
+    std::memcpy(data.data() + sizeof(KtxHeader), levels.data(), levelCount * sizeof(KtxLevel));
+    std::memcpy(data.data() + header.dfdByteOffset, dfd.data(), header.dfdByteLength);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const auto& mipLevel = textureData.mipLevels[level];
+        std::memcpy(data.data() + levels[level].byteOffset, textureData.data.data() + mipLevel.offset, mipLevel.size);
+    }
+
+    return data;
+}
+
+} // namespace chronicle
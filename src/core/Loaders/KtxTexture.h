@@ -0,0 +1,44 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "Renderer/Renderer.h"
+
+namespace chronicle {
+
+/// @brief Texture read from a KTX2 container.
+struct KtxTextureData {
+    Format format { Format::undefined }; ///< Texture format.
+    uint32_t width { 0 }; ///< Texture width.
+    uint32_t height { 0 }; ///< Texture height.
+    std::vector<TextureMipLevel> mipLevels {}; ///< Mip levels in the data, empty if they must be generated.
+    std::vector<uint8_t> data {}; ///< Levels data, from the largest.
+};
+
+/// @brief Reader for the KTX2 textures.
+///        The textures with a block compressed format are used as they are, with their pre-baked mip levels.
+///        The Basis Universal textures (ETC1S or UASTC) are not supported, they need a transcoder.
+class KtxTexture {
+public:
+    /// @brief Check if the data is a KTX2 container.
+    /// @param data Data to check.
+    /// @return True if the data starts with the KTX2 identifier.
+    [[nodiscard]] static bool isKtx2(std::span<const uint8_t> data);
+
+    /// @brief Read a KTX2 texture.
+    /// @param data KTX2 container.
+    /// @param textureData Filled with the texture.
+    /// @return True if the texture is read.
+    [[nodiscard]] static bool read(std::span<const uint8_t> data, KtxTextureData& textureData);
+
+    /// @brief Write an RGBA8 texture in a KTX2 container, with its mip levels.
+    /// @param textureData Texture to write, the levels are from the largest.
+    /// @param srgb The color channels are sRGB encoded.
+    /// @return KTX2 container.
+    [[nodiscard]] static std::vector<uint8_t> write(const KtxTextureData& textureData, bool srgb);
+};
+
+} // namespace chronicle
@@ -0,0 +1,552 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "MeshOptimizer.h"
+
+namespace chronicle {
+
+/// @brief Symmetric 4x4 matrix used to measure the squared distance from a set of planes, weighted by area.
+struct Quadric {
+    double a00 { 0.0 }, a01 { 0.0 }, a02 { 0.0 }, a11 { 0.0 }, a12 { 0.0 }, a22 { 0.0 }; ///< Normals products.
+    double b0 { 0.0 }, b1 { 0.0 }, b2 { 0.0 }; ///< Normals by distances.
+    double c { 0.0 }; ///< Squared distances.
+    double weight { 0.0 }; ///< Sum of the weights.
+
+    /// @brief Create the quadric for a plane.
+    static Quadric fromPlane(const glm::dvec3& normal, double distance, double weight)
+    {
+        return { .a00 = normal.x * normal.x * weight,
+            .a01 = normal.x * normal.y * weight,
+            .a02 = normal.x * normal.z * weight,
+            .a11 = normal.y * normal.y * weight,
+            .a12 = normal.y * normal.z * weight,
+            .a22 = normal.z * normal.z * weight,
+            .b0 = normal.x * distance * weight,
+            .b1 = normal.y * distance * weight,
+            .b2 = normal.z * distance * weight,
+            .c = distance * distance * weight,
+            .weight = weight };
+    }
+
+    Quadric& operator+=(const Quadric& other)
+    {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a11 += other.a11;
+        a12 += other.a12;
+        a22 += other.a22;
+        b0 += other.b0;
+        b1 += other.b1;
+        b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+        return *this;
+    }
+
+    /// @brief Get the mean squared distance of a point from the planes.
+    [[nodiscard]] double error(const glm::dvec3& p) const
+    {
+        if (weight <= 0.0) {
+            return 0.0;
+        }
+
+        auto value = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z
+            + 2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z) + 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+        return std::max(value, 0.0) / weight;
+    }
+};
+
+/// @brief Candidate edge collapse.
+struct EdgeCollapse {
+    uint32_t source { 0 }; ///< Vertex removed.
+    uint32_t target { 0 }; ///< Vertex that replaces the source.
+    double error { 0.0 }; ///< Collapse error.
+};
+
+VertexCacheStatistics MeshOptimizer::analyzeVertexCache(
+    std::span<const uint32_t> indices, uint32_t verticesCount, uint32_t cacheSize)
+{
+    CHRZONE_ASSETS;
+
+    assert(indices.size() % 3 == 0);
+
+    VertexCacheStatistics statistics = {};
+    if (indices.empty()) {
+        return statistics;
+    }
+
+    // a vertex is in the FIFO cache if less than cacheSize vertices are inserted after it
+    std::vector<uint32_t> timestamps(verticesCount, 0);
+    std::vector<bool> used(verticesCount, false);
+    uint32_t timestamp = cacheSize + 1;
+    uint32_t usedCount = 0;
+    for (auto index : indices) {
+        assert(index < verticesCount);
+
+        if (timestamp - timestamps[index] > cacheSize) {
+            timestamps[index] = timestamp++;
+            statistics.verticesTransformed++;
+        }
+
+        if (!used[index]) {
+            used[index] = true;
+            usedCount++;
+        }
+    }
+
+    statistics.trianglesCount = static_cast<uint32_t>(indices.size() / 3);
+    statistics.acmr
+        = static_cast<float>(statistics.verticesTransformed) / static_cast<float>(statistics.trianglesCount);
+    statistics.atvr = static_cast<float>(statistics.verticesTransformed) / static_cast<float>(usedCount);
+    return statistics;
+}
+
+void MeshOptimizer::optimizeVertexCache(
+    std::span<uint32_t> indices, uint32_t verticesCount, std::vector<uint32_t>& clusters, uint32_t cacheSize)
+{
+    CHRZONE_ASSETS;
+
+    assert(indices.size() % 3 == 0);
+
+    clusters.clear();
+    auto trianglesCount = static_cast<uint32_t>(indices.size() / 3);
+    if (trianglesCount == 0) {
+        return;
+    }
+
+    // triangles adjacent to every vertex
+    std::vector<uint32_t> liveTriangles(verticesCount, 0);
+    for (auto index : indices) {
+        assert(index < verticesCount);
+        liveTriangles[index]++;
+    }
+
+    std::vector<uint32_t> adjacencyOffsets(static_cast<size_t>(verticesCount) + 1, 0);
+    for (uint32_t vertex = 0; vertex < verticesCount; vertex++) {
+        adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveTriangles[vertex];
+    }
+
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        auto insertOffsets = adjacencyOffsets;
+        for (uint32_t triangle = 0; triangle < trianglesCount; triangle++) {
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                adjacency[insertOffsets[indices[triangle * 3 + corner]]++] = triangle;
+            }
+        }
+    }
+
+    std::vector<uint32_t> cacheTimestamps(verticesCount, 0);
+    std::vector<bool> emitted(trianglesCount, false);
+    std::vector<uint32_t> deadEnds = {};
+    std::vector<uint32_t> candidates = {};
+    std::vector<uint32_t> output = {};
+    output.reserve(indices.size());
+
+    uint32_t timestamp = cacheSize + 1;
+    uint32_t cursor = 0;
+    int64_t fanningVertex = 0;
+
+    // the first cluster start with the first triangle
+    clusters.push_back(0);
+
+    while (fanningVertex >= 0) {
+        candidates.clear();
+
+        // emit all the triangles around the fanning vertex
+        auto vertex = static_cast<uint32_t>(fanningVertex);
+        for (auto offset = adjacencyOffsets[vertex]; offset < adjacencyOffsets[vertex + 1]; offset++) {
+            auto triangle = adjacency[offset];
+            if (emitted[triangle]) {
+                continue;
+            }
+
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                auto index = indices[triangle * 3 + corner];
+                output.push_back(index);
+                deadEnds.push_back(index);
+                candidates.push_back(index);
+                liveTriangles[index]--;
+                if (timestamp - cacheTimestamps[index] > cacheSize) {
+                    cacheTimestamps[index] = timestamp++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        // select the candidate that will stay in cache for most of his remaining triangles
+        fanningVertex = -1;
+        int64_t bestPriority = -1;
+        for (auto candidate : candidates) {
+            if (liveTriangles[candidate] == 0) {
+                continue;
+            }
+
+            int64_t priority = 0;
+            if (timestamp - cacheTimestamps[candidate] + 2 * liveTriangles[candidate] <= cacheSize) {
+                priority = timestamp - cacheTimestamps[candidate];
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                fanningVertex = candidate;
+            }
+        }
+
+        if (fanningVertex >= 0) {
+            continue;
+        }
+
+        // dead end, the next fanning vertex is a recent one or the next one with live triangles
+        while (!deadEnds.empty() && fanningVertex < 0) {
+            auto deadEnd = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangles[deadEnd] > 0) {
+                fanningVertex = deadEnd;
+            }
+        }
+        while (cursor < verticesCount && fanningVertex < 0) {
+            if (liveTriangles[cursor] > 0) {
+                fanningVertex = cursor;
+            }
+            cursor++;
+        }
+
+        // the cache locality is lost, a new cluster starts here
+        if (fanningVertex >= 0 && clusters.back() != output.size() / 3) {
+            clusters.push_back(static_cast<uint32_t>(output.size() / 3));
+        }
+    }
+
+    assert(output.size() == indices.size());
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void MeshOptimizer::optimizeOverdraw(std::span<uint32_t> indices, std::span<const uint32_t> clusters,
+    const uint8_t* positions, size_t positionsStride, uint32_t verticesCount)
+{
+    CHRZONE_ASSETS;
+
+    assert(indices.size() % 3 == 0);
+    assert(positions != nullptr);
+
+    auto trianglesCount = static_cast<uint32_t>(indices.size() / 3);
+    if (clusters.size() < 2) {
+        return;
+    }
+
+    auto getPosition = [positions, positionsStride, verticesCount](uint32_t index) {
+        assert(index < verticesCount);
+        glm::vec3 position = {};
+        std::memcpy(&position, positions + index * positionsStride, sizeof(glm::vec3));
+        return position;
+    };
+
+    // area weighted centroid and normal of every cluster
+    struct Cluster {
+        uint32_t firstTriangle { 0 };
+        uint32_t trianglesCount { 0 };
+        glm::vec3 centroid { 0.0f };
+        glm::vec3 normal { 0.0f };
+        float area { 0.0f };
+        float sortKey { 0.0f };
+    };
+
+    std::vector<Cluster> meshClusters(clusters.size());
+    glm::vec3 meshCentroid = glm::vec3(0.0f);
+    float meshArea = 0.0f;
+    for (size_t clusterIndex = 0; clusterIndex < clusters.size(); clusterIndex++) {
+        auto& cluster = meshClusters[clusterIndex];
+        cluster.firstTriangle = clusters[clusterIndex];
+        auto lastTriangle = clusterIndex + 1 < clusters.size() ? clusters[clusterIndex + 1] : trianglesCount;
+        cluster.trianglesCount = lastTriangle - cluster.firstTriangle;
+
+        for (auto triangle = cluster.firstTriangle; triangle < lastTriangle; triangle++) {
+            auto p0 = getPosition(indices[triangle * 3 + 0]);
+            auto p1 = getPosition(indices[triangle * 3 + 1]);
+            auto p2 = getPosition(indices[triangle * 3 + 2]);
+
+            auto normal = glm::cross(p1 - p0, p2 - p0);
+            auto area = glm::length(normal);
+            cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+
+        meshCentroid += cluster.centroid;
+        meshArea += cluster.area;
+        if (cluster.area > 0.0f) {
+            cluster.centroid /= cluster.area;
+        }
+    }
+
+    if (meshArea <= 0.0f) {
+        return;
+    }
+    meshCentroid /= meshArea;
+
+    // the clusters facing away from the center are more likely to occlude the others
+    for (auto& cluster : meshClusters) {
+        auto normalLength = glm::length(cluster.normal);
+        cluster.sortKey
+            = normalLength > 0.0f ? glm::dot(cluster.centroid - meshCentroid, cluster.normal / normalLength) : 0.0f;
+    }
+
+    std::stable_sort(meshClusters.begin(), meshClusters.end(),
+        [](const Cluster& left, const Cluster& right) { return left.sortKey > right.sortKey; });
+
+    std::vector<uint32_t> output = {};
+    output.reserve(indices.size());
+    for (const auto& cluster : meshClusters) {
+        auto first = indices.begin() + static_cast<size_t>(cluster.firstTriangle) * 3;
+        output.insert(output.end(), first, first + static_cast<size_t>(cluster.trianglesCount) * 3);
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+uint32_t MeshOptimizer::optimizeVertexFetch(
+    std::span<uint32_t> indices, std::vector<uint8_t>& vertices, uint32_t stride)
+{
+    CHRZONE_ASSETS;
+
+    assert(stride > 0);
+    assert(vertices.size() % stride == 0);
+
+    auto verticesCount = static_cast<uint32_t>(vertices.size() / stride);
+
+    // the vertices get a new position when they are used for the first time
+    constexpr uint32_t unused = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(verticesCount, unused);
+    uint32_t nextVertex = 0;
+    for (auto& index : indices) {
+        assert(index < verticesCount);
+        if (remap[index] == unused) {
+            remap[index] = nextVertex++;
+        }
+        index = remap[index];
+    }
+
+    std::vector<uint8_t> remappedVertices(static_cast<size_t>(nextVertex) * stride);
+    for (uint32_t vertex = 0; vertex < verticesCount; vertex++) {
+        if (remap[vertex] != unused) {
+            std::memcpy(remappedVertices.data() + static_cast<size_t>(remap[vertex]) * stride,
+                vertices.data() + static_cast<size_t>(vertex) * stride, stride);
+        }
+    }
+
+    vertices = std::move(remappedVertices);
+    return nextVertex;
+}
+
+std::vector<uint32_t> MeshOptimizer::simplify(std::span<const uint32_t> indices, const uint8_t* positions,
+    size_t positionsStride, uint32_t verticesCount, size_t targetIndicesCount, float targetError, float& resultError)
+{
+    CHRZONE_ASSETS;
+
+    assert(indices.size() % 3 == 0);
+    assert(positions != nullptr);
+
+    resultError = 0.0f;
+    std::vector<uint32_t> result(indices.begin(), indices.end());
+    if (result.size() <= targetIndicesCount) {
+        return result;
+    }
+
+    std::vector<glm::dvec3> vertexPositions(verticesCount);
+    for (uint32_t vertex = 0; vertex < verticesCount; vertex++) {
+        glm::vec3 position = {};
+        std::memcpy(&position, positions + vertex * positionsStride, sizeof(glm::vec3));
+        vertexPositions[vertex] = position;
+    }
+
+    // the vertices sharing a position differ in other attributes, moving them would open a seam
+    std::unordered_map<glm::dvec3, uint32_t> positionVertices = {};
+    std::vector<uint32_t> canonicalVertices(verticesCount);
+    std::vector<bool> locked(verticesCount, false);
+    for (uint32_t vertex = 0; vertex < verticesCount; vertex++) {
+        auto [it, inserted] = positionVertices.try_emplace(vertexPositions[vertex], vertex);
+        canonicalVertices[vertex] = it->second;
+        if (!inserted) {
+            locked[it->second] = true;
+        }
+    }
+
+    // the edges used by a single triangle are on the border, moving them would shrink the mesh
+    std::unordered_map<uint64_t, uint32_t> edges = {};
+    auto edgeKey = [&canonicalVertices](uint32_t first, uint32_t second) {
+        auto a = canonicalVertices[first];
+        auto b = canonicalVertices[second];
+        return (static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+    };
+    for (size_t i = 0; i < result.size(); i += 3) {
+        for (uint32_t corner = 0; corner < 3; corner++) {
+            edges[edgeKey(result[i + corner], result[i + (corner + 1) % 3])]++;
+        }
+    }
+    for (const auto& [key, count] : edges) {
+        if (count == 1) {
+            locked[static_cast<uint32_t>(key >> 32)] = true;
+            locked[static_cast<uint32_t>(key & 0xFFFFFFFF)] = true;
+        }
+    }
+    for (uint32_t vertex = 0; vertex < verticesCount; vertex++) {
+        locked[vertex] = locked[canonicalVertices[vertex]];
+    }
+
+    // every vertex accumulate the planes of his triangles
+    std::vector<Quadric> quadrics(verticesCount);
+    for (size_t i = 0; i < result.size(); i += 3) {
+        const auto& p0 = vertexPositions[result[i + 0]];
+        auto normal = glm::cross(vertexPositions[result[i + 1]] - p0, vertexPositions[result[i + 2]] - p0);
+        auto area = glm::length(normal);
+        if (area <= 0.0) {
+            continue;
+        }
+
+        normal /= area;
+        auto quadric = Quadric::fromPlane(normal, -glm::dot(normal, p0), area);
+        for (uint32_t corner = 0; corner < 3; corner++) {
+            quadrics[result[i + corner]] += quadric;
+        }
+    }
+
+    auto maxError = static_cast<double>(targetError) * static_cast<double>(targetError);
+    double collapsedError = 0.0;
+
+    std::vector<uint32_t> adjacencyOffsets(static_cast<size_t>(verticesCount) + 1);
+    std::vector<uint32_t> adjacency = {};
+    std::vector<EdgeCollapse> collapses = {};
+    std::vector<uint32_t> remap(verticesCount);
+    std::vector<bool> touched(verticesCount);
+
+    while (result.size() > targetIndicesCount) {
+        auto trianglesCount = static_cast<uint32_t>(result.size() / 3);
+
+        // triangles adjacent to every vertex
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (auto index : result) {
+            adjacencyOffsets[index + 1]++;
+        }
+        for (uint32_t vertex = 0; vertex < verticesCount; vertex++) {
+            adjacencyOffsets[vertex + 1] += adjacencyOffsets[vertex];
+        }
+        adjacency.resize(result.size());
+        {
+            auto insertOffsets = adjacencyOffsets;
+            for (uint32_t triangle = 0; triangle < trianglesCount; triangle++) {
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    adjacency[insertOffsets[result[triangle * 3 + corner]]++] = triangle;
+                }
+            }
+        }
+
+        // every edge can collapse in both directions
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                auto first = result[i + corner];
+                auto second = result[i + (corner + 1) % 3];
+                for (auto [source, target] : { std::pair { first, second }, std::pair { second, first } }) {
+                    if (locked[source]) {
+                        continue;
+                    }
+
+                    auto quadric = quadrics[source];
+                    quadric += quadrics[target];
+                    collapses.push_back(
+                        { .source = source, .target = target, .error = quadric.error(vertexPositions[target]) });
+                }
+            }
+        }
+
+        std::sort(collapses.begin(), collapses.end(),
+            [](const EdgeCollapse& left, const EdgeCollapse& right) { return left.error < right.error; });
+
+        // collapse the cheapest edges, a vertex changes at most once for every pass
+        std::iota(remap.begin(), remap.end(), 0);
+        std::fill(touched.begin(), touched.end(), false);
+        auto trianglesToRemove = (result.size() - targetIndicesCount) / 3;
+        size_t trianglesRemoved = 0;
+        for (const auto& collapse : collapses) {
+            if (collapse.error > maxError || trianglesRemoved >= trianglesToRemove) {
+                break;
+            }
+
+            if (touched[collapse.source] || touched[collapse.target]) {
+                continue;
+            }
+
+            // reject the collapses that flip a triangle
+            bool flipped = false;
+            size_t degenerated = 0;
+            for (auto offset = adjacencyOffsets[collapse.source]; offset < adjacencyOffsets[collapse.source + 1];
+                 offset++) {
+                const auto* triangle = &result[static_cast<size_t>(adjacency[offset]) * 3];
+                if (triangle[0] == collapse.target || triangle[1] == collapse.target
+                    || triangle[2] == collapse.target) {
+                    degenerated++;
+                    continue;
+                }
+
+                std::array<glm::dvec3, 3> before = {};
+                std::array<glm::dvec3, 3> after = {};
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    before[corner] = vertexPositions[triangle[corner]];
+                    after[corner]
+                        = triangle[corner] == collapse.source ? vertexPositions[collapse.target] : before[corner];
+                }
+
+                auto normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                auto normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+                if (glm::dot(normalBefore, normalAfter) <= 0.0) {
+                    flipped = true;
+                    break;
+                }
+            }
+
+            if (flipped) {
+                continue;
+            }
+
+            remap[collapse.source] = collapse.target;
+            quadrics[collapse.target] += quadrics[collapse.source];
+            collapsedError = std::max(collapsedError, collapse.error);
+            trianglesRemoved += degenerated;
+
+            // the triangles around the two vertices are changed, their vertices wait the next pass
+            for (auto vertex : { collapse.source, collapse.target }) {
+                for (auto offset = adjacencyOffsets[vertex]; offset < adjacencyOffsets[vertex + 1]; offset++) {
+                    for (uint32_t corner = 0; corner < 3; corner++) {
+                        touched[result[static_cast<size_t>(adjacency[offset]) * 3 + corner]] = true;
+                    }
+                }
+            }
+        }
+
+        if (trianglesRemoved == 0) {
+            break;
+        }
+
+        // apply the collapses and remove the degenerated triangles
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            auto a = remap[result[i + 0]];
+            auto b = remap[result[i + 1]];
+            auto c = remap[result[i + 2]];
+            if (a == b || b == c || a == c) {
+                continue;
+            }
+
+            result[writeIndex++] = a;
+            result[writeIndex++] = b;
+            result[writeIndex++] = c;
+        }
+        result.resize(writeIndex);
+    }
+
+    resultError = static_cast<float>(std::sqrt(collapsedError));
+    return result;
+}
+
+} // namespace chronicle
@@ -0,0 +1,76 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+namespace chronicle {
+
+/// @brief Statistics about the post-transform vertex cache efficiency.
+struct VertexCacheStatistics {
+    uint32_t trianglesCount { 0 }; ///< Triangles count.
+    uint32_t verticesTransformed { 0 }; ///< Vertices transformed, the cache misses.
+    float acmr { 0.0f }; ///< Average cache miss ratio, transformed vertices per triangle (best 0.5).
+    float atvr { 0.0f }; ///< Average transformed vertex ratio, transformed vertices per vertex (best 1.0).
+};
+
+/// @brief Reorder and simplify indexed triangle lists for a faster rendering.
+///        The vertex cache and overdraw optimizations are based on "Fast Triangle Reordering for Vertex Locality and
+///        Reduced Overdraw" (Sander, Nehab, Barczak).
+class MeshOptimizer {
+public:
+    /// @brief Size of the simulated post-transform vertex cache.
+    static constexpr uint32_t DefaultCacheSize = 16;
+
+    /// @brief Simulate a FIFO post-transform vertex cache.
+    /// @param indices Triangle list indices.
+    /// @param verticesCount Vertices count.
+    /// @param cacheSize Cache size.
+    /// @return Cache statistics.
+    [[nodiscard]] static VertexCacheStatistics analyzeVertexCache(
+        std::span<const uint32_t> indices, uint32_t verticesCount, uint32_t cacheSize = DefaultCacheSize);
+
+    /// @brief Reorder the triangles to improve the post-transform vertex cache locality (Tipsify).
+    /// @param indices Triangle list indices, reordered in place.
+    /// @param verticesCount Vertices count.
+    /// @param clusters Filled with the first triangle of every cluster, a cluster ends where the cache is flushed.
+    /// @param cacheSize Cache size.
+    static void optimizeVertexCache(std::span<uint32_t> indices, uint32_t verticesCount,
+        std::vector<uint32_t>& clusters, uint32_t cacheSize = DefaultCacheSize);
+
+    /// @brief Reorder the clusters to reduce the overdraw, drawing first the clusters that face outwards.
+    ///        The triangles order inside the clusters doesn't change, so the vertex cache efficiency is preserved.
+    /// @param indices Triangle list indices, reordered in place.
+    /// @param clusters First triangle of every cluster, as returned by optimizeVertexCache.
+    /// @param positions Vertex positions, 3 floats for every vertex.
+    /// @param positionsStride Distance between two positions, in bytes.
+    /// @param verticesCount Vertices count.
+    static void optimizeOverdraw(std::span<uint32_t> indices, std::span<const uint32_t> clusters,
+        const uint8_t* positions, size_t positionsStride, uint32_t verticesCount);
+
+    /// @brief Reorder the vertices in the order they are used, improving the vertex fetch locality.
+    ///        The vertices not referenced by the indices are removed.
+    /// @param indices Triangle list indices, remapped in place.
+    /// @param vertices Interleaved vertices, reordered in place.
+    /// @param stride Vertex stride.
+    /// @return New vertices count.
+    static uint32_t optimizeVertexFetch(std::span<uint32_t> indices, std::vector<uint8_t>& vertices, uint32_t stride);
+
+    /// @brief Simplify a triangle list with quadric error metrics, collapsing the edges on one of their vertices.
+    ///        The simplified indices reference the same vertices, so all the levels can share one vertex buffer.
+    ///        The vertices on the borders and on the attribute seams are never moved.
+    /// @param indices Triangle list indices.
+    /// @param positions Vertex positions, 3 floats for every vertex.
+    /// @param positionsStride Distance between two positions, in bytes.
+    /// @param verticesCount Vertices count.
+    /// @param targetIndicesCount Indices count to reach.
+    /// @param targetError Maximum error, as a distance in the positions space.
+    /// @param resultError Filled with the error of the simplified triangles.
+    /// @return Simplified indices.
+    [[nodiscard]] static std::vector<uint32_t> simplify(std::span<const uint32_t> indices, const uint8_t* positions,
+        size_t positionsStride, uint32_t verticesCount, size_t targetIndicesCount, float targetError,
+        float& resultError);
+};
+
+} // namespace chronicle
@@ -4,11 +4,13 @@
 #include "PipelineLoader.h"
 
 #include "Renderer/Data/PipelineInfo.h"
+#include "Utils/ThreadPool.h"
 
 namespace chronicle {
 
 struct PipelineLoaderContext {
     static inline std::unordered_map<size_t, std::weak_ptr<Pipeline>> cache = {};
+    static inline std::unique_ptr<ThreadPool> threadPool {}; ///< Workers that create the batched pipelines.
 };
 
 PipelineRef PipelineLoader::load(const PipelineInfo& pipelineInfo, const char* debugName)
@@ -23,4 +25,80 @@ PipelineRef PipelineLoader::load(const PipelineInfo& pipelineInfo, const char* d
     return pipeline;
 }
 
-} // namespace chronicle
\ No newline at end of file
+void PipelineLoader::deinit()
+{
+    CHRZONE_ASSETS;
+
+    // the pool waits the queued jobs before joining the workers
+    PipelineLoaderContext::threadPool.reset();
+}
+
+PipelineBatch::~PipelineBatch() { wait(); }
+
+PipelineRef PipelineBatch::add(const PipelineInfo& pipelineInfo, const std::string& name)
+{
+    CHRZONE_ASSETS;
+
+    assert(!_submitted);
+
+    auto pipeline = Pipeline::createDeferred(pipelineInfo, name);
+    _pipelines.push_back(pipeline);
+    return pipeline;
+}
+
+void PipelineBatch::submit()
+{
+    CHRZONE_ASSETS;
+
+    assert(!_submitted);
+    _submitted = true;
+
+    if (_pipelines.empty()) {
+        return;
+    }
+
+    if (!PipelineLoaderContext::threadPool) {
+        PipelineLoaderContext::threadPool = std::make_unique<ThreadPool>();
+    }
+
+    // one driver call for every worker, the chunks reference the pipelines owned by the batch
+    auto chunksCount = std::min<size_t>(PipelineLoaderContext::threadPool->threadCount(), _pipelines.size());
+    auto chunkSize = (_pipelines.size() + chunksCount - 1) / chunksCount;
+    for (size_t offset = 0; offset < _pipelines.size(); offset += chunkSize) {
+        auto count = std::min(chunkSize, _pipelines.size() - offset);
+        auto chunk = std::span<const PipelineRef>(_pipelines).subspan(offset, count);
+        _jobs.push_back(PipelineLoaderContext::threadPool->submit([chunk]() {
+            // the failed pipelines are marked by build, the others of the chunk are created anyway
+            try {
+                Pipeline::build(chunk);
+            } catch (const std::exception& error) {
+                CHRLOG_ERROR("Failed to create pipelines: {}", error.what());
+            }
+        }));
+    }
+}
+
+bool PipelineBatch::done() const
+{
+    return std::ranges::all_of(
+        _jobs, [](const auto& job) { return job.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+}
+
+bool PipelineBatch::failed() const
+{
+    // a pipeline of a completed batch is either created or failed, also when its job threw
+    return _submitted && done()
+        && std::ranges::any_of(_pipelines, [](const auto& pipeline) { return !pipeline->ready(); });
+}
+
+void PipelineBatch::wait()
+{
+    CHRZONE_ASSETS;
+
+    // the jobs catch the build errors, the failed pipelines are reported by failed
+    for (auto& job : _jobs) {
+        job.wait();
+    }
+}
+
+} // namespace chronicle
@@ -9,9 +9,54 @@
 
 namespace chronicle {
 
+/// @brief Group of pipelines created together on the pipeline loader worker threads.
+///        The pipelines returned by @ref PipelineBatch#add are valid as soon as they are created, check them with
+///        @ref BasePipeline#ready before binding them. The pipelines that can't be created are marked as failed,
+///        the batch still completes.
+class PipelineBatch : private NonCopyable<PipelineBatch> {
+public:
+    /// @brief Default constructor.
+    PipelineBatch() = default;
+
+    /// @brief Destructor. Wait for the pipelines still in progress.
+    ~PipelineBatch();
+
+    /// @brief Add a pipeline to the batch. It must be called before @ref PipelineBatch#submit.
+    /// @param pipelineInfo Informations used to create the pipeline.
+    /// @param name Pipeline name.
+    /// @return The pipeline, not ready until the batch creates it.
+    [[nodiscard]] PipelineRef add(const PipelineInfo& pipelineInfo, const std::string& name);
+
+    /// @brief Start creating the pipelines, split between the worker threads.
+    void submit();
+
+    /// @brief Check if all the pipelines are created.
+    /// @return True if the batch is completed.
+    [[nodiscard]] bool done() const;
+
+    /// @brief Check if some pipelines of a completed batch can't be created.
+    /// @return True if the batch is completed and a pipeline is not ready.
+    [[nodiscard]] bool failed() const;
+
+    /// @brief Wait for all the pipelines.
+    void wait();
+
+    /// @brief Check if the batch doesn't have pipelines.
+    /// @return True if it's empty.
+    [[nodiscard]] bool empty() const { return _pipelines.empty(); }
+
+private:
+    std::vector<PipelineRef> _pipelines {}; ///< Pipelines to create, not changed after the submit.
+    std::vector<std::future<void>> _jobs {}; ///< Jobs that create the pipelines.
+    bool _submitted { false }; ///< Set when the batch is submitted.
+};
+
 class PipelineLoader {
 public:
     [[nodiscard]] static PipelineRef load(const PipelineInfo& pipelineInfo, const char* debugName);
+
+    /// @brief Wait for the batches in progress and stop the worker threads.
+    static void deinit();
 };
 
-} // namespace chronicle
\ No newline at end of file
+} // namespace chronicle
@@ -3,22 +3,195 @@
 
 #include "ShaderLoader.h"
 
+#include "Storage/StorageContext.h"
+
 namespace chronicle {
 
+/// @brief Hash of a shader source file, without its includes.
+struct ShaderSourceInfo {
+    size_t hash {}; ///< Hash of the file content.
+    std::vector<std::string> includes {}; ///< Files included by the source.
+};
+
+/// @brief Cached shader, with the files used to compute its key.
+struct ShaderCacheEntry {
+    std::weak_ptr<Shader> shader {}; ///< Shared shader, it's alive while an object use it.
+    std::shared_future<ShaderRef> pending {}; ///< Shader in creation, valid until it's created.
+    std::vector<std::string> dependencies {}; ///< Shader file and all the files it includes.
+};
+
 struct ShaderLoaderContext {
-    static inline std::unordered_map<size_t, std::weak_ptr<Shader>> cache = {};
+    static inline std::unordered_map<size_t, ShaderCacheEntry> cache = {};
+    static inline std::unordered_map<std::string, ShaderSourceInfo> sources = {};
+    static inline std::mutex mutex = {};
+    static inline bool listening = false;
 };
 
+/// @brief Read a shader source and get the hash of its content and the files it include.
+///        The include names are resolved as the shader compiler does, with the storage paths.
+/// @param filename Shader source filename.
+/// @return Source informations.
+static ShaderSourceInfo readShaderSource(const std::string& filename)
+{
+    ShaderSourceInfo sourceInfo = {};
+    if (!StorageContext::exists(filename)) {
+        return sourceInfo;
+    }
+
+    auto content = StorageContext::file(filename).readAllText();
+    sourceInfo.hash = std::hash<std::string>()(content);
+
+    const std::regex includeRegex("^\\s*#\\s*include\\s*[\"<]([^\">]+)[\">]");
+    std::stringstream stream(content);
+    std::string line;
+    std::smatch match;
+    while (std::getline(stream, line, '\n')) {
+        if (std::regex_search(line, match, includeRegex)) {
+            sourceInfo.includes.push_back(match[1].str());
+        }
+    }
+    return sourceInfo;
+}
+
+/// @brief Get the cache key of a shader, the hash of the file name, the sorted macros and the content of the
+///        shader and of all the files it includes.
+/// @param shaderInfo Shader informations.
+/// @param dependencies Filled with the shader file and all the files it includes.
+/// @return Cache key.
+static size_t getShaderKey(const ShaderInfo& shaderInfo, std::vector<std::string>& dependencies)
+{
+    // the macros order doesn't change the compiled shader
+    auto macroDefinitions = shaderInfo.macroDefinitions;
+    std::ranges::sort(macroDefinitions);
+    auto duplicates = std::ranges::unique(macroDefinitions);
+    macroDefinitions.erase(duplicates.begin(), duplicates.end());
+
+    size_t hash = 0;
+    std::hash_combine(hash, shaderInfo.filename);
+    for (const auto& macroDefinition : macroDefinitions) {
+        std::hash_combine(hash, macroDefinition);
+    }
+
+    // walk the include closure, every file is hashed once
+    std::vector<std::string> pending = { shaderInfo.filename };
+    while (!pending.empty()) {
+        auto filename = std::move(pending.back());
+        pending.pop_back();
+        if (std::ranges::find(dependencies, filename) != dependencies.end()) {
+            continue;
+        }
+
+        auto it = ShaderLoaderContext::sources.find(filename);
+        if (it == ShaderLoaderContext::sources.end()) {
+            it = ShaderLoaderContext::sources.emplace(filename, readShaderSource(filename)).first;
+        }
+
+        std::hash_combine(hash, filename, it->second.hash);
+        pending.insert(pending.end(), it->second.includes.rbegin(), it->second.includes.rend());
+        dependencies.push_back(filename);
+    }
+    return hash;
+}
+
+/// @brief Drop the cached sources and shaders that depend on a changed file.
+///        The shaders already in use are not touched, the next load will compile the new source.
+/// @param event File change event.
+static void onFileChanged(const FileChangeEvent& event)
+{
+    std::scoped_lock<std::mutex> lock(ShaderLoaderContext::mutex);
+
+    if (!ShaderLoaderContext::sources.erase(event.filename)) {
+        return;
+    }
+
+    std::erase_if(ShaderLoaderContext::cache, [&event](const auto& item) {
+        return std::ranges::find(item.second.dependencies, event.filename) != item.second.dependencies.end();
+    });
+}
+
 ShaderRef ShaderLoader::load(const ShaderInfo& shaderInfo)
 {
-    //auto hash = std::hash<ShaderCompilerOptions>()(options);
-    //if (auto shader = ShaderLoaderContext::cache[hash].lock()) {
-    //    return shader;
-    //}
+    CHRZONE_ASSETS;
+
+    // the lock is held only for the cache, the shaders are compiled outside of it
+    size_t hash = 0;
+    std::promise<ShaderRef> promise = {};
+    std::shared_future<ShaderRef> pending = {};
+    {
+        std::scoped_lock<std::mutex> lock(ShaderLoaderContext::mutex);
+
+        if (!ShaderLoaderContext::listening) {
+            StorageContext::sink<FileChangeEvent>().connect<&onFileChanged>();
+            ShaderLoaderContext::listening = true;
+        }
+
+        std::vector<std::string> dependencies = {};
+        hash = getShaderKey(shaderInfo, dependencies);
+
+        auto& entry = ShaderLoaderContext::cache[hash];
+        if (auto shader = entry.shader.lock()) {
+            return shader;
+        }
+
+        // the same shader can be already in creation on another thread
+        if (entry.pending.valid()) {
+            pending = entry.pending;
+        } else {
+            entry.pending = promise.get_future().share();
+            entry.dependencies = std::move(dependencies);
+        }
+    }
+
+    if (pending.valid()) {
+        return pending.get();
+    }
+
+    ShaderRef shader = {};
+    try {
+        shader = Shader::create(shaderInfo);
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+
+        std::scoped_lock<std::mutex> lock(ShaderLoaderContext::mutex);
+        ShaderLoaderContext::cache.erase(hash);
+        throw;
+    }
+    promise.set_value(shader);
+
+    std::scoped_lock<std::mutex> lock(ShaderLoaderContext::mutex);
+
+    // the key includes the content of the files, an entry with the same key is for the same source
+    if (auto it = ShaderLoaderContext::cache.find(hash); it != ShaderLoaderContext::cache.end()) {
+        it->second.shader = shader;
+        it->second.pending = {};
+    }
 
-    auto shader = Shader::create(shaderInfo);
-    //ShaderLoaderContext::cache[hash] = shader;
+    // drop the entries of the shaders that nobody use anymore
+    std::erase_if(ShaderLoaderContext::cache,
+        [](const auto& item) { return item.second.shader.expired() && !item.second.pending.valid(); });
     return shader;
 }
 
-} // namespace chronicle
\ No newline at end of file
+bool ShaderLoader::loadArchive(const std::filesystem::path& filename)
+{
+    CHRZONE_ASSETS;
+
+    return Shader::loadArchive(filename);
+}
+
+void ShaderLoader::clear()
+{
+    CHRZONE_ASSETS;
+
+    std::scoped_lock<std::mutex> lock(ShaderLoaderContext::mutex);
+
+    if (ShaderLoaderContext::listening) {
+        StorageContext::sink<FileChangeEvent>().disconnect<&onFileChanged>();
+        ShaderLoaderContext::listening = false;
+    }
+
+    ShaderLoaderContext::cache.clear();
+    ShaderLoaderContext::sources.clear();
+}
+
+} // namespace chronicle
@@ -9,9 +9,25 @@
 
 namespace chronicle {
 
+/// @brief Load the shaders, sharing the ones compiled with the same source and macros.
 class ShaderLoader {
 public:
-    [[nodiscard]] static ShaderRef load(const ShaderInfo& options);
+    /// @brief Load a shader, or get the one already loaded if it's still in use.
+    ///        The shaders are identified by the file name, the macros (in any order) and the content of the file
+    ///        and of all the files it includes. The entries are invalidated when one of these files changes.
+    ///        It can be called by any thread, a shader requested by more threads at once is created only once.
+    /// @param shaderInfo Shader informations.
+    /// @return The shader.
+    [[nodiscard]] static ShaderRef load(const ShaderInfo& shaderInfo);
+
+    /// @brief Load an archive with the precompiled shader variants, built by chronicle-shadercook.
+    ///        The shaders found in the archive are not compiled at runtime.
+    /// @param filename Archive filename.
+    /// @return True if the archive is valid.
+    static bool loadArchive(const std::filesystem::path& filename);
+
+    /// @brief Clear the cache and stop listening for the file changes.
+    static void clear();
 };
 
 } // namespace chronicle
\ No newline at end of file
@@ -0,0 +1,204 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "TextureCooker.h"
+
+namespace chronicle {
+
+constexpr uint32_t CoverageSearchSteps = 16; ///< Steps of the binary search for the alpha scale.
+
+/// @brief Convert an sRGB encoded value to linear.
+/// @param value Encoded value, between 0 and 1.
+/// @return Linear value.
+static float srgbToLinear(float value)
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+/// @brief Convert a linear value to sRGB encoded.
+/// @param value Linear value, between 0 and 1.
+/// @return Encoded value.
+static float linearToSrgb(float value)
+{
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+/// @brief Get the fraction of the texels that pass the alpha test (alpha greater or equal to the reference).
+/// @param level Level texels, 4 floats for every texel.
+/// @param alphaCutoff Alpha test reference.
+/// @param alphaScale Scale applied to the alpha.
+/// @return Coverage, between 0 and 1.
+static float getCoverage(std::span<const float> level, float alphaCutoff, float alphaScale)
+{
+    size_t covered = 0;
+    for (size_t i = 3; i < level.size(); i += 4) {
+        if (level[i] * alphaScale >= alphaCutoff) {
+            covered++;
+        }
+    }
+    return static_cast<float>(covered) / static_cast<float>(level.size() / 4);
+}
+
+/// @brief Find the alpha scale that makes the coverage of a level closest to the target.
+/// @param level Level texels, 4 floats for every texel.
+/// @param alphaCutoff Alpha test reference.
+/// @param targetCoverage Coverage of the first level.
+/// @return Alpha scale.
+static float getAlphaScale(std::span<const float> level, float alphaCutoff, float targetCoverage)
+{
+    // the coverage grows with the scale
+    float minScale = 0.0f;
+    float maxScale = 4.0f;
+    float bestScale = 1.0f;
+    float bestError = std::abs(getCoverage(level, alphaCutoff, 1.0f) - targetCoverage);
+    for (uint32_t step = 0; step < CoverageSearchSteps; step++) {
+        auto scale = (minScale + maxScale) * 0.5f;
+        auto coverage = getCoverage(level, alphaCutoff, scale);
+        if (auto error = std::abs(coverage - targetCoverage); error < bestError) {
+            bestError = error;
+            bestScale = scale;
+        }
+
+        if (coverage < targetCoverage) {
+            minScale = scale;
+        } else if (coverage > targetCoverage) {
+            maxScale = scale;
+        } else {
+            break;
+        }
+    }
+    return bestScale;
+}
+
+void TextureCooker::generateMipChain(std::span<const uint8_t> pixels, uint32_t width, uint32_t height,
+    const TextureCookOptions& options, KtxTextureData& textureData)
+{
+    CHRZONE_ASSETS;
+
+    assert(width > 0);
+    assert(height > 0);
+    assert(pixels.size() >= static_cast<size_t>(width) * height * 4);
+
+    auto levelsCount = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+
+    textureData.format = Format::R8G8B8A8Unorm;
+    textureData.width = width;
+    textureData.height = height;
+    textureData.mipLevels.clear();
+    textureData.mipLevels.reserve(levelsCount);
+    textureData.data.clear();
+
+    // the first level is stored as it is
+    auto levelSize = static_cast<size_t>(width) * height * 4;
+    textureData.mipLevels.push_back({ .offset = 0, .size = levelSize });
+    textureData.data.assign(pixels.begin(), pixels.begin() + static_cast<std::ptrdiff_t>(levelSize));
+
+    // filter in linear space, every level is downsampled from the previous one without quantization
+    std::array<float, 256> decodeTable = {};
+    for (uint32_t i = 0; i < 256; i++) {
+        auto value = static_cast<float>(i) / 255.0f;
+        decodeTable[i] = options.srgb ? srgbToLinear(value) : value;
+    }
+
+    std::vector<float> level(levelSize);
+    for (size_t i = 0; i < levelSize; i++) {
+        level[i] = (i % 4 == 3) ? static_cast<float>(pixels[i]) / 255.0f : decodeTable[pixels[i]];
+    }
+
+    auto preserveCoverage = options.alphaCutoff > 0.0f;
+    auto targetCoverage = preserveCoverage ? getCoverage(level, options.alphaCutoff, 1.0f) : 0.0f;
+
+    auto levelWidth = width;
+    auto levelHeight = height;
+    std::vector<float> nextLevel = {};
+    for (uint32_t levelIndex = 1; levelIndex < levelsCount; levelIndex++) {
+        auto nextWidth = std::max(levelWidth / 2, 1u);
+        auto nextHeight = std::max(levelHeight / 2, 1u);
+        nextLevel.assign(static_cast<size_t>(nextWidth) * nextHeight * 4, 0.0f);
+
+        // 2x2 box filter, the last row and column are repeated when the size is odd or 1
+        for (uint32_t y = 0; y < nextHeight; y++) {
+            auto y0 = std::min(y * 2, levelHeight - 1);
+            auto y1 = std::min(y * 2 + 1, levelHeight - 1);
+            for (uint32_t x = 0; x < nextWidth; x++) {
+                auto x0 = std::min(x * 2, levelWidth - 1);
+                auto x1 = std::min(x * 2 + 1, levelWidth - 1);
+                auto* texel = &nextLevel[(static_cast<size_t>(y) * nextWidth + x) * 4];
+                for (auto [sx, sy] : { std::pair(x0, y0), std::pair(x1, y0), std::pair(x0, y1), std::pair(x1, y1) }) {
+                    const auto* source = &level[(static_cast<size_t>(sy) * levelWidth + sx) * 4];
+                    for (uint32_t channel = 0; channel < 4; channel++) {
+                        texel[channel] += source[channel] * 0.25f;
+                    }
+                }
+            }
+        }
+
+        // the scale is applied only to the stored level, the next ones are filtered from the unscaled alpha
+        auto alphaScale = preserveCoverage ? getAlphaScale(nextLevel, options.alphaCutoff, targetCoverage) : 1.0f;
+
+        auto offset = textureData.data.size();
+        textureData.data.resize(offset + nextLevel.size());
+        for (size_t i = 0; i < nextLevel.size(); i++) {
+            auto value = (i % 4 == 3) ? nextLevel[i] * alphaScale : nextLevel[i];
+            if (options.srgb && i % 4 != 3) {
+                value = linearToSrgb(value);
+            }
+            textureData.data[offset + i] = static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+        textureData.mipLevels.push_back({ .offset = offset, .size = nextLevel.size() });
+
+        level.swap(nextLevel);
+        levelWidth = nextWidth;
+        levelHeight = nextHeight;
+    }
+}
+
+bool TextureCooker::cookFile(
+    const std::filesystem::path& source, const std::filesystem::path& destination, const TextureCookOptions& options)
+{
+    CHRZONE_ASSETS;
+
+    std::error_code errorCode = {};
+    if (std::filesystem::exists(destination, errorCode)
+        && std::filesystem::last_write_time(destination, errorCode)
+            >= std::filesystem::last_write_time(source, errorCode)) {
+        return true;
+    }
+
+    CHRLOG_DEBUG("Cook texture: {} -> {}", source.string(), destination.string());
+
+    int width = 0;
+    int height = 0;
+    int components = 0;
+    auto* pixels = stbi_load(source.string().c_str(), &width, &height, &components, STBI_rgb_alpha);
+    if (pixels == nullptr) {
+        CHRLOG_ERROR("Failed to decode image {}: {}", source.string(), stbi_failure_reason());
+        return false;
+    }
+
+    KtxTextureData textureData = {};
+    generateMipChain(std::span(pixels, static_cast<size_t>(width) * height * STBI_rgb_alpha),
+        static_cast<uint32_t>(width), static_cast<uint32_t>(height), options, textureData);
+    stbi_image_free(pixels);
+
+    auto data = KtxTexture::write(textureData, options.srgb);
+
+    // write in a temporary file, so a failed write never leave a broken texture
+    std::filesystem::create_directories(destination.parent_path(), errorCode);
+    auto temporaryFilename = destination;
+    temporaryFilename += ".tmp";
+
+    {
+        std::ofstream file(temporaryFilename, std::ios::binary | std::ios::out | std::ios::trunc);
+        file.write(std::bit_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file.good()) {
+            CHRLOG_ERROR("Failed to write file {}", temporaryFilename.string());
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporaryFilename, destination, errorCode);
+    return !errorCode;
+}
+
+} // namespace chronicle
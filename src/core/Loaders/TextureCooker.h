@@ -0,0 +1,55 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "KtxTexture.h"
+
+namespace chronicle {
+
+/// @brief Options used to cook a texture.
+struct TextureCookOptions {
+    /// @brief The color channels are sRGB encoded, they are filtered in linear space. The alpha is always linear.
+    bool srgb { false };
+
+    /// @brief Alpha test reference, the alpha of every level is scaled to keep the coverage of the first level.
+    ///        0 disables the coverage preservation.
+    float alphaCutoff { 0.0f };
+
+    auto operator<=>(const TextureCookOptions&) const = default;
+};
+
+/// @brief Cook the RGBA8 textures with the full mip chain, so the levels don't need to be generated at load.
+class TextureCooker {
+public:
+    /// @brief Generate the mip chain of an RGBA8 image with a box filter.
+    /// @param pixels RGBA8 pixels of the first level.
+    /// @param width Image width.
+    /// @param height Image height.
+    /// @param options Cook options.
+    /// @param textureData Filled with all the levels, from the largest.
+    static void generateMipChain(std::span<const uint8_t> pixels, uint32_t width, uint32_t height,
+        const TextureCookOptions& options, KtxTextureData& textureData);
+
+    /// @brief Cook an image file to a KTX2 file with the full mip chain.
+    ///        The file is cooked only if the destination is missing or older than the source.
+    /// @param source Image file, in any format supported by stb_image.
+    /// @param destination KTX2 file.
+    /// @param options Cook options.
+    /// @return True if the destination is up to date.
+    [[nodiscard]] static bool cookFile(const std::filesystem::path& source, const std::filesystem::path& destination,
+        const TextureCookOptions& options);
+};
+
+} // namespace chronicle
+
+template <> struct std::hash<chronicle::TextureCookOptions> {
+    std::size_t operator()(const chronicle::TextureCookOptions& data) const noexcept
+    {
+        std::size_t h = 0;
+        std::hash_combine(h, data.srgb, data.alphaCutoff);
+        return h;
+    }
+};
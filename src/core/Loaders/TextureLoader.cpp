@@ -0,0 +1,108 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "TextureLoader.h"
+
+namespace chronicle {
+
+/// @brief Texture in the cache.
+struct TextureCacheEntry {
+    uint64_t sourceSize { 0 }; ///< Size of the encoded image, compared on a hit.
+    std::weak_ptr<Texture> texture {}; ///< Texture, shared while it's referenced.
+    std::shared_future<TextureRef> pending {}; ///< Texture in creation, valid until it's created.
+};
+
+struct TextureLoaderContext {
+    static inline std::unordered_map<size_t, TextureCacheEntry> cache = {};
+    static inline std::mutex mutex = {}; ///< The cache is checked by the asynchronous imports.
+};
+
+TextureRef TextureLoader::get(size_t hash, uint64_t sourceSize)
+{
+    CHRZONE_ASSETS;
+
+    std::scoped_lock<std::mutex> lock(TextureLoaderContext::mutex);
+    if (auto it = TextureLoaderContext::cache.find(hash); it != TextureLoaderContext::cache.end()) {
+        if (auto texture = it->second.texture.lock()) {
+            // the same hash for another image, the texture is not shared
+            if (it->second.sourceSize != sourceSize) {
+                CHRLOG_WARN("Texture cache collision: hash={}", hash);
+                return nullptr;
+            }
+            return texture;
+        }
+
+        // the texture is not referenced anymore, the one in creation is returned by load
+        if (!it->second.pending.valid()) {
+            TextureLoaderContext::cache.erase(it);
+        }
+    }
+
+    return nullptr;
+}
+
+TextureRef TextureLoader::load(
+    size_t hash, uint64_t sourceSize, const SampledTextureInfo& textureInfo, const std::string& name)
+{
+    CHRZONE_ASSETS;
+
+    // get or create under the same lock, the texture is created and uploaded only once
+    std::promise<TextureRef> promise = {};
+    std::shared_future<TextureRef> pending = {};
+    bool collision = false;
+    {
+        std::scoped_lock<std::mutex> lock(TextureLoaderContext::mutex);
+
+        auto& entry = TextureLoaderContext::cache[hash];
+        auto texture = entry.texture.lock();
+        if ((texture || entry.pending.valid()) && entry.sourceSize != sourceSize) {
+            CHRLOG_WARN("Texture cache collision: hash={}", hash);
+            collision = true;
+        } else if (texture) {
+            CHRLOG_DEBUG("Texture {} found in cache", name);
+            return texture;
+        } else if (entry.pending.valid()) {
+            pending = entry.pending;
+        } else {
+            entry = { .sourceSize = sourceSize, .pending = promise.get_future().share() };
+        }
+    }
+
+    // the same texture is in creation on another thread
+    if (pending.valid()) {
+        return pending.get();
+    }
+
+    // the same hash for another image, the texture is not cached
+    if (collision) {
+        return Texture::createSampled(textureInfo, name);
+    }
+
+    TextureRef texture = {};
+    try {
+        texture = Texture::createSampled(textureInfo, name);
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+
+        std::scoped_lock<std::mutex> lock(TextureLoaderContext::mutex);
+        TextureLoaderContext::cache.erase(hash);
+        throw;
+    }
+    promise.set_value(texture);
+
+    std::scoped_lock<std::mutex> lock(TextureLoaderContext::mutex);
+    if (auto it = TextureLoaderContext::cache.find(hash); it != TextureLoaderContext::cache.end()) {
+        it->second.texture = texture;
+        it->second.pending = {};
+    }
+    return texture;
+}
+
+size_t TextureLoader::hash(size_t sourceHash, const SamplerInfo& samplerInfo)
+{
+    std::size_t h = sourceHash;
+    std::hash_combine(h, samplerInfo);
+    return h;
+}
+
+} // namespace chronicle
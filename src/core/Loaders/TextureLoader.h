@@ -0,0 +1,39 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "Renderer/Renderer.h"
+
+namespace chronicle {
+
+/// @brief Cache of the sampled textures, shared while they are referenced.
+class TextureLoader {
+public:
+    /// @brief Get a texture from the cache, it can be called by any thread.
+    /// @param hash Texture hash, see @ref TextureLoader#hash.
+    /// @param sourceSize Size of the encoded image, a cached texture with the same hash and another size is a
+    ///                   collision and it's not returned.
+    /// @return The cached texture, or null if not available.
+    [[nodiscard]] static TextureRef get(size_t hash, uint64_t sourceSize);
+
+    /// @brief Get a texture from the cache, or create it if not available.
+    ///        A texture requested by more threads at once is created only once, the others wait for it.
+    /// @param hash Texture hash, see @ref TextureLoader#hash.
+    /// @param sourceSize Size of the encoded image.
+    /// @param textureInfo Informations used to create the texture.
+    /// @param name Texture name.
+    /// @return The texture.
+    [[nodiscard]] static TextureRef load(
+        size_t hash, uint64_t sourceSize, const SampledTextureInfo& textureInfo, const std::string& name);
+
+    /// @brief Calculate the hash that identify a texture in the cache.
+    /// @param sourceHash Hash of the image source (path or content).
+    /// @param samplerInfo Sampler state.
+    /// @return The texture hash.
+    [[nodiscard]] static size_t hash(size_t sourceHash, const SamplerInfo& samplerInfo);
+};
+
+} // namespace chronicle
@@ -56,12 +56,26 @@ public:
     /// @brief End the render pass.
     void endRenderPass() const { CRTP_CONST_THIS->endRenderPass(); }
 
+    /// @brief Draw primitives with the vertices in order.
+    /// @param vertexCount The number of vertices to draw.
+    /// @param instanceCount The number of instances to draw.
+    /// @param firstVertex The index of the first vertex to draw.
+    /// @param firstInstance The instance ID of the first instance to draw.
+    void draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex = 0, uint32_t firstInstance = 0) const
+    {
+        CRTP_CONST_THIS->draw(vertexCount, instanceCount, firstVertex, firstInstance);
+    }
+
     /// @brief Draw primitives with indexed vertices.
     /// @param indexCount The number of vertices to draw.
     /// @param instanceCount The number of instances to draw.
-    void drawIndexed(uint32_t indexCount, uint32_t instanceCount) const
+    /// @param firstIndex The base index within the index buffer.
+    /// @param vertexOffset The value added to the vertex index before indexing into the vertex buffer.
+    /// @param firstInstance The instance ID of the first instance to draw.
+    void drawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex = 0, int32_t vertexOffset = 0,
+        uint32_t firstInstance = 0) const
     {
-        CRTP_CONST_THIS->drawIndexed(indexCount, instanceCount);
+        CRTP_CONST_THIS->drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
     }
 
     /// @brief Bind a pipeline object to the command buffer.
@@ -97,9 +111,23 @@ public:
     /// @param descriptorSetId The descriptor set to be bound.
     /// @param pipelineLayoutId The pipeline layout related to the descript set.
     /// @param index The number of the descriptor to be bound.
-    void bindDescriptorSet(DescriptorSetId descriptorSetId, PipelineLayoutId pipelineLayoutId, uint32_t index) const
+    /// @param dynamicOffsets The offsets of the dynamic uniform buffers, in binding order.
+    void bindDescriptorSet(DescriptorSetId descriptorSetId, PipelineLayoutId pipelineLayoutId, uint32_t index,
+        const std::vector<uint32_t>& dynamicOffsets = {}) const
+    {
+        CRTP_CONST_THIS->bindDescriptorSet(descriptorSetId, pipelineLayoutId, index, dynamicOffsets);
+    }
+
+    /// @brief Update the values of push constants.
+    /// @param pipelineLayoutId The pipeline layout used to program the push constant updates.
+    /// @param stages The shader stages that will use the push constants.
+    /// @param offset The start offset of the push constant range to update, in bytes.
+    /// @param size The size of the push constant range to update, in bytes.
+    /// @param data The new push constant values.
+    void pushConstants(
+        PipelineLayoutId pipelineLayoutId, ShaderStage stages, uint32_t offset, uint32_t size, const void* data) const
     {
-        CRTP_CONST_THIS->bindDescriptorSet(descriptorSetId, pipelineLayoutId, index);
+        CRTP_CONST_THIS->pushConstants(pipelineLayoutId, stages, offset, size, data);
     }
 
     /// @brief Begin a debug label.
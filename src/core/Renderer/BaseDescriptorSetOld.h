@@ -44,6 +44,12 @@ public:
         CRTP_THIS->setUniform<Tx>(id, data);
     }
 
+    /// @brief Get the dynamic offsets of the uniforms for the current frame, they must be used to bind the
+    ///        descriptor set. The values are copied in the uniform ring of the frame, so the frames in flight keep
+    ///        reading their own copy.
+    /// @return Dynamic offsets, in binding order.
+    [[nodiscard]] const std::vector<uint32_t>& dynamicOffsets() { return CRTP_THIS->dynamicOffsets(); }
+
     /// @brief Build the descriptor set. This must be called after all the structure information are added to the
     ///        descriptor set, and before bind it to the command buffer.
     ///        This MUST be called only once! If you need to change the descriptor set structure, you need to create
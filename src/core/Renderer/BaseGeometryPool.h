@@ -0,0 +1,61 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "Common/Common.h"
+
+namespace chronicle {
+
+/// @brief Kind of the geometry pool buffers.
+enum class GeometryBufferType { vertex, index };
+
+/// @brief Range of a geometry pool buffer, assigned to the vertices, the instances or the indices of a mesh.
+struct GeometryRange {
+    GeometryBufferType type { GeometryBufferType::vertex }; ///< Kind of the buffer.
+    GeometryBufferId bufferId {}; ///< Pool buffer that contains the range.
+    uint32_t page { 0 }; ///< Page of the pool that owns the buffer.
+    uint64_t offset { 0 }; ///< Offset in the buffer, in bytes.
+    uint64_t size { 0 }; ///< Size in bytes.
+    uint32_t first { 0 }; ///< First element in the buffer: base vertex, first instance or first index.
+
+    /// @brief Check if the range is valid.
+    [[nodiscard]] explicit operator bool() const { return size > 0; }
+};
+
+/// @brief Large device local buffers shared by the geometry of all the meshes.
+///        The vertices and the indices are sub-allocated from a few buffers, so a single bind serves all the draws
+///        and a mesh is addressed by its base vertex and first index.
+/// @tparam T Type with implementation.
+template <class T> class BaseGeometryPool {
+public:
+    /// @brief Copy vertices into the pool.
+    /// @param data Vertices data.
+    /// @param stride Size of a vertex, the range is aligned to it.
+    /// @return Range with the vertices, the first element is the base vertex.
+    [[nodiscard]] static GeometryRange allocateVertices(std::span<const uint8_t> data, uint32_t stride)
+    {
+        return T::allocateVertices(data, stride);
+    }
+
+    /// @brief Copy indices into the pool.
+    /// @param data Indices data.
+    /// @param indexType Index type, the range is aligned to its size.
+    /// @return Range with the indices, the first element is the first index.
+    [[nodiscard]] static GeometryRange allocateIndices(std::span<const uint8_t> data, IndexType indexType)
+    {
+        return T::allocateIndices(data, indexType);
+    }
+
+    /// @brief Give a range back to the pool, after the frames in flight that can use it.
+    /// @param range Range to free.
+    static void free(const GeometryRange& range) { T::free(range); }
+
+private:
+    BaseGeometryPool() = default;
+    friend T;
+};
+
+} // namespace chronicle
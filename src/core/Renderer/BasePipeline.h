@@ -22,6 +22,14 @@ public:
     /// @return Pipeline layout ID
     [[nodiscard]] PipelineLayoutId pipelineLayoutId() const { return CRTP_CONST_THIS->pipelineLayoutId(); }
 
+    /// @brief Check if the pipeline is created and can be bound.
+    /// @return True if the pipeline is ready.
+    [[nodiscard]] bool ready() const { return CRTP_CONST_THIS->ready(); }
+
+    /// @brief Check if the creation of the pipeline is failed, a failed pipeline is never ready.
+    /// @return True if the pipeline can't be created.
+    [[nodiscard]] bool failed() const { return CRTP_CONST_THIS->failed(); }
+
     /// @brief Factory for create a new pipeline.
     /// @param pipelineInfo Informations used to create the pipeline.
     /// @param name Pipeline name.
@@ -31,6 +39,21 @@ public:
         return T::create(pipelineInfo, name);
     }
 
+    /// @brief Factory for create a new pipeline that is not ready until it's built with @ref BasePipeline#build.
+    /// @param pipelineInfo Informations used to create the pipeline.
+    /// @param name Pipeline name.
+    /// @return The pipeline.
+    [[nodiscard]] static PipelineRef createDeferred(const PipelineInfo& pipelineInfo, const std::string& name)
+    {
+        return T::createDeferred(pipelineInfo, name);
+    }
+
+    /// @brief Build a group of deferred pipelines with a single driver call, using the shared pipeline cache.
+    ///        It can be called from any thread, as long as every pipeline is built by only one call.
+    ///        The pipelines that can't be created are marked as failed, the others are created anyway.
+    /// @param pipelines Pipelines to build.
+    static void build(std::span<const PipelineRef> pipelines) { T::build(pipelines); }
+
 private:
     BasePipeline() = default;
     friend T;
@@ -88,6 +88,24 @@ public:
     /// @return Depth format.
     [[nodiscard]] static Format findDepthFormat() { return T::findDepthFormat(); }
 
+    /// @brief Check if the GPU supports 8 bit indices.
+    /// @return True if IndexType::uint8 can be used.
+    [[nodiscard]] static bool supportsIndexTypeUint8() { return T::supportsIndexTypeUint8(); }
+
+    /// @brief Check if the GPU can sample and filter a texture format.
+    /// @param format Texture format.
+    /// @return True if the format can be used for the sampled textures.
+    [[nodiscard]] static bool supportsSampledFormat(Format format) { return T::supportsSampledFormat(format); }
+
+    /// @brief Get the directory used to cache the compiled shaders and the pipelines.
+    /// @return Cache directory, empty if the cache is disabled.
+    [[nodiscard]] static const std::filesystem::path& cacheDirectory() { return T::cacheDirectory(); }
+
+    /// @brief Set the directory used to cache the compiled shaders and the pipelines.
+    ///        This should be called before loading any shader.
+    /// @param directory Cache directory, empty to disable the cache.
+    static void setCacheDirectory(const std::filesystem::path& directory) { T::setCacheDirectory(directory); }
+
     /// @brief Get the descriptor set layout 0 (frame descriptor set)
     /// @return Descriptor set layout.
     [[nodiscard]] static DescriptorSetLayout descriptorSetLayout() { return T::descriptorSetLayout(); }
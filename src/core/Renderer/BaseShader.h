@@ -43,6 +43,11 @@ public:
         return shader;
     }
 
+    /// @brief Load an archive with the precompiled shader variants, used before compiling a shader.
+    /// @param filename Archive filename.
+    /// @return True if the archive is valid.
+    static bool loadArchive(const std::filesystem::path& filename) { return T::loadArchive(filename); }
+
 protected:
     void reload() { return CRTP_THIS->reload(); };
 
@@ -12,6 +12,7 @@ namespace chronicle {
 using CommandBufferId = vk::CommandBuffer;
 using DescriptorSetId = vk::DescriptorSet;
 using FrameBufferId = vk::Framebuffer;
+using GeometryBufferId = vk::Buffer;
 using IndexBufferId = vk::Buffer;
 using PipelineId = vk::Pipeline;
 using PipelineLayoutId = vk::PipelineLayout;
@@ -23,6 +24,7 @@ using VertexBufferId = vk::Buffer;
 template <class T> class BaseCommandBuffer;
 template <class T> class BaseDescriptorSet;
 template <class T> class BaseFrameBuffer;
+template <class T> class BaseGeometryPool;
 template <class T> class BaseIndexBuffer;
 template <class T> class BasePipeline;
 template <class T> class BaseRenderContext;
@@ -36,6 +38,7 @@ namespace internal::vulkan {
     class VulkanCommandBuffer;
     class VulkanDescriptorSet;
     class VulkanFrameBuffer;
+    class VulkanGeometryPool;
     class VulkanIndexBuffer;
     class VulkanPipeline;
     class VulkanRenderContext;
@@ -48,6 +51,7 @@ namespace internal::vulkan {
 using CommandBuffer = BaseCommandBuffer<internal::vulkan::VulkanCommandBuffer>;
 using DescriptorSet = BaseDescriptorSet<internal::vulkan::VulkanDescriptorSet>;
 using FrameBuffer = BaseFrameBuffer<internal::vulkan::VulkanFrameBuffer>;
+using GeometryPool = BaseGeometryPool<internal::vulkan::VulkanGeometryPool>;
 using IndexBuffer = BaseIndexBuffer<internal::vulkan::VulkanIndexBuffer>;
 using Pipeline = BasePipeline<internal::vulkan::VulkanPipeline>;
 using RenderContext = BaseRenderContext<internal::vulkan::VulkanRenderContext>;
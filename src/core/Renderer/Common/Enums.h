@@ -23,10 +23,17 @@ enum class ShaderStage {
 enum class IndexType {
     undefined,
 
+    uint8,
     uint16,
     uint32
 };
 
+/// @brief Rate at which the vertex attributes are pulled from a vertex buffer.
+enum class VertexInputRate {
+    vertex, ///< The attributes are addressed by the vertex index.
+    instance ///< The attributes are addressed by the instance index.
+};
+
 /// @brief Samples count for multi sampling anti aliasing
 enum class MSAA { sampleCount1, sampleCount2, sampleCount4, sampleCount8, sampleCount16, sampleCount32, sampleCount64 };
 
@@ -52,6 +59,12 @@ enum class Format {
     R8G8B8Unorm,
     R8G8B8A8Unorm,
 
+    // 8 bit signed normalized
+    R8Snorm,
+    R8G8Snorm,
+    R8G8B8Snorm,
+    R8G8B8A8Snorm,
+
     // 16 bit signed int
     R16Sint,
     R16G16Sint,
@@ -70,6 +83,18 @@ enum class Format {
     R16G16B16Unorm,
     R16G16B16A16Unorm,
 
+    // 16 bit signed normalized
+    R16Snorm,
+    R16G16Snorm,
+    R16G16B16Snorm,
+    R16G16B16A16Snorm,
+
+    // 16 bit signed float
+    R16Sfloat,
+    R16G16Sfloat,
+    R16G16B16Sfloat,
+    R16G16B16A16Sfloat,
+
     // 32 bit signed int
     R32Sint,
     R32G32Sint,
@@ -88,6 +113,16 @@ enum class Format {
     R32G32B32Sfloat,
     R32G32B32A32Sfloat,
 
+    // block compressed
+    BC1RgbaUnorm,
+    BC3Unorm,
+    BC4Unorm,
+    BC5Unorm,
+    BC7Unorm,
+    ETC2R8G8B8Unorm,
+    ETC2R8G8B8A8Unorm,
+    ASTC4x4Unorm,
+
     // TODO: other, to remove?
     B8G8R8A8Unorm,
 
@@ -186,4 +221,23 @@ enum class ImageLayout {
     presentSrc ///< Must only be used for presenting a presentable image for display.
 };
 
+/// @brief Filter used for texture lookups.
+enum class Filter {
+    nearest, ///< Specifies nearest filtering.
+    linear ///< Specifies linear filtering.
+};
+
+/// @brief Mipmap mode used for texture lookups.
+enum class SamplerMipmapMode {
+    nearest, ///< Specifies nearest filtering between the mip levels.
+    linear ///< Specifies linear filtering between the mip levels.
+};
+
+/// @brief Behavior of sampling with texture coordinates outside an image.
+enum class SamplerAddressMode {
+    repeat, ///< Specifies that the repeat wrap mode will be used.
+    mirroredRepeat, ///< Specifies that the mirrored repeat wrap mode will be used.
+    clampToEdge ///< Specifies that the clamp to edge wrap mode will be used.
+};
+
 } // namespace chronicle
\ No newline at end of file
@@ -16,6 +16,27 @@
 
 namespace chronicle {
 
+/// @brief Range of push constants accessible by the pipeline.
+struct PushConstantRange {
+    /// @brief Shader stages that will access the range.
+    ShaderStage stages = ShaderStage::none;
+
+    /// @brief Start offset of the range, in bytes.
+    uint32_t offset = 0;
+
+    /// @brief Size of the range, in bytes.
+    uint32_t size = 0;
+};
+
+/// @brief Value of a specialization constant of the pipeline shaders.
+struct SpecializationConstant {
+    /// @brief Constant ID, declared in the shader with layout(constant_id = ID).
+    uint32_t id = 0;
+
+    /// @brief Constant value, a 32 bit scalar (1 or 0 for the bool constants).
+    uint32_t value = 0;
+};
+
 /// @brief Informations used to create a new pipeline.
 struct PipelineInfo {
     /// @brief Shader to be attached to the pipeline.
@@ -29,6 +50,14 @@ struct PipelineInfo {
 
     /// @brief Informations about the descriptor sets that will be attached to the pipeline.
     std::vector<DescriptorSetLayout> descriptorSetsLayout = {};
+
+    /// @brief Push constant ranges accessible by the pipeline.
+    std::vector<PushConstantRange> pushConstants = {};
+
+    /// @brief Specialization constants used by all the shader stages.
+    ///        The features that don't change the resources layout can use them instead of the macros, so the
+    ///        pipelines share the same shader modules.
+    std::vector<SpecializationConstant> specializationConstants = {};
 };
 
 } // namespace chronicle
@@ -40,6 +69,12 @@ template <> struct std::hash<chronicle::PipelineInfo> {
         for (const auto& vertexBuffer : data.vertexBuffers) {
             std::hash_combine(h, vertexBuffer);
         }
+        for (const auto& pushConstant : data.pushConstants) {
+            std::hash_combine(h, pushConstant.stages, pushConstant.offset, pushConstant.size);
+        }
+        for (const auto& specializationConstant : data.specializationConstants) {
+            std::hash_combine(h, specializationConstant.id, specializationConstant.value);
+        }
         //for (const auto& descriptorSetLayout : data.descriptorSetsLayout) {
         //    std::hash_combine(h, descriptorSetLayout);
         //}
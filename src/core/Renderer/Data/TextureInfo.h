@@ -9,19 +9,59 @@
 
 namespace chronicle {
 
+/// @brief Informations used to create a texture sampler.
+struct SamplerInfo {
+    /// @brief Magnification filter.
+    Filter magFilter = Filter::linear;
+
+    /// @brief Minification filter.
+    Filter minFilter = Filter::linear;
+
+    /// @brief Filter between the mip levels.
+    SamplerMipmapMode mipmapMode = SamplerMipmapMode::linear;
+
+    /// @brief Sample the mip levels, if false only the first level is sampled.
+    bool mipmaps = true;
+
+    /// @brief Addressing mode for the U coordinate.
+    SamplerAddressMode addressModeU = SamplerAddressMode::repeat;
+
+    /// @brief Addressing mode for the V coordinate.
+    SamplerAddressMode addressModeV = SamplerAddressMode::repeat;
+};
+
+/// @brief Mip level stored in the data of a sampled texture.
+struct TextureMipLevel {
+    /// @brief Offset of the level in the data.
+    uint64_t offset = 0;
+
+    /// @brief Size of the level.
+    uint64_t size = 0;
+};
+
 /// @brief Informations used to create a sampled texture.
 struct SampledTextureInfo {
     /// @brief Enabled the mipmap generation for the texture.
+    ///        Ignored if the mip levels are stored in the data or if the format is block compressed.
     bool generateMipmaps = true;
 
-    /// @brief image data used to fill the texture.
-    std::vector<uint8_t> data = {};
+    /// @brief image data used to fill the texture, it must stay valid while the texture is created.
+    std::span<const uint8_t> data = {};
+
+    /// @brief Image format.
+    Format format = Format::R8G8B8A8Unorm;
+
+    /// @brief Mip levels stored in the data, from the largest. Empty if the data contains only the first level.
+    std::vector<TextureMipLevel> mipLevels = {};
 
     /// @brief Texture width.
     uint32_t width = 0;
 
     /// @brief Texture height.
     uint32_t height = 0;
+
+    /// @brief Sampler state.
+    SamplerInfo sampler = {};
 };
 
 /// @brief Informations used to create a sampled texture.
@@ -60,4 +100,14 @@ struct DepthTextureInfo {
     MSAA msaa = MSAA::sampleCount1;
 };
 
-} // namespace chronicle
\ No newline at end of file
+} // namespace chronicle
+
+template <> struct std::hash<chronicle::SamplerInfo> {
+    std::size_t operator()(const chronicle::SamplerInfo& data) const noexcept
+    {
+        std::size_t h = 0;
+        std::hash_combine(h, data.magFilter, data.minFilter, data.mipmapMode, data.mipmaps, data.addressModeU,
+            data.addressModeV);
+        return h;
+    }
+};
@@ -31,6 +31,9 @@ struct VertexBufferInfo {
 
     /// @brief Attribute descriptions.
     std::vector<AttributeDescriptionInfo> attributeDescriptions;
+
+    /// @brief Rate at which the attributes are pulled, per vertex or per instance.
+    VertexInputRate inputRate = VertexInputRate::vertex;
 };
 
 } // namespace chronicle
@@ -48,7 +51,7 @@ template <> struct std::hash<chronicle::VertexBufferInfo> {
     std::size_t operator()(const chronicle::VertexBufferInfo& data) const noexcept
     {
         std::size_t h = 0;
-        std::hash_combine(h, data.stride);
+        std::hash_combine(h, data.stride, data.inputRate);
         for (const auto& attributeDescription : data.attributeDescriptions) {
             std::hash_combine(h, attributeDescription);
         }
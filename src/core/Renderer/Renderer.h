@@ -11,6 +11,7 @@
 #include "Vulkan/VulkanDescriptorSetOld.h"
 #include "Vulkan/VulkanIndexBuffer.h"
 #include "Vulkan/VulkanFrameBuffer.h"
+#include "Vulkan/VulkanGeometryPool.h"
 #include "Vulkan/VulkanPipeline.h"
 #include "Vulkan/VulkanRenderContext.h"
 #include "Vulkan/VulkanRenderPass.h"
@@ -113,7 +113,24 @@ void VulkanCommandBuffer::endRenderPass() const
     _commandBuffer.endRenderPass();
 }
 
-void VulkanCommandBuffer::drawIndexed(uint32_t indexCount, uint32_t instanceCount) const
+void VulkanCommandBuffer::draw(
+    uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) const
+{
+    CHRZONE_RENDERER;
+
+    assert(vertexCount > 0);
+    assert(instanceCount > 0);
+    assert(_commandBuffer);
+
+    CHRLOG_TRACE("Draw: vertex count={}, instance count={}, first vertex={}, first instance={}", vertexCount,
+        instanceCount, firstVertex, firstInstance);
+
+    // draw
+    _commandBuffer.draw(vertexCount, instanceCount, firstVertex, firstInstance);
+}
+
+void VulkanCommandBuffer::drawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex,
+    int32_t vertexOffset, uint32_t firstInstance) const
 {
     CHRZONE_RENDERER;
 
@@ -121,10 +138,11 @@ void VulkanCommandBuffer::drawIndexed(uint32_t indexCount, uint32_t instanceCoun
     assert(instanceCount > 0);
     assert(_commandBuffer);
 
-    CHRLOG_TRACE("Draw indexed: index count={}, instance count={}", indexCount, instanceCount);
+    CHRLOG_TRACE("Draw indexed: index count={}, instance count={}, first index={}, vertex offset={}, first instance={}",
+        indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
 
     // draw
-    _commandBuffer.drawIndexed(indexCount, instanceCount, 0, 0, 0);
+    _commandBuffer.drawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
 }
 
 void VulkanCommandBuffer::bindPipeline(PipelineId pipelineId) const
@@ -182,8 +200,8 @@ void VulkanCommandBuffer::bindIndexBuffer(const IndexBufferId indexBufferId, Ind
     _commandBuffer.bindIndexBuffer(indexBufferId, offset, VulkanEnums::indexTypeToVulkan(indexType));
 }
 
-void VulkanCommandBuffer::bindDescriptorSet(
-    DescriptorSetId descriptorSetId, PipelineLayoutId pipelineLayoutId, uint32_t index) const
+void VulkanCommandBuffer::bindDescriptorSet(DescriptorSetId descriptorSetId, PipelineLayoutId pipelineLayoutId,
+    uint32_t index, const std::vector<uint32_t>& dynamicOffsets) const
 {
     CHRZONE_RENDERER;
 
@@ -191,11 +209,27 @@ void VulkanCommandBuffer::bindDescriptorSet(
     assert(pipelineLayoutId);
     assert(index >= 0 && index < 4); // max 4 descriptor sets
 
-    CHRLOG_TRACE("Bind descriptor set: index={}", index);
+    CHRLOG_TRACE("Bind descriptor set: index={}, dynamic offsets={}", index, dynamicOffsets.size());
 
     // bind the descriptor set
     _commandBuffer.bindDescriptorSets(
-        vk::PipelineBindPoint::eGraphics, pipelineLayoutId, index, descriptorSetId, nullptr);
+        vk::PipelineBindPoint::eGraphics, pipelineLayoutId, index, descriptorSetId, dynamicOffsets);
+}
+
+void VulkanCommandBuffer::pushConstants(
+    PipelineLayoutId pipelineLayoutId, ShaderStage stages, uint32_t offset, uint32_t size, const void* data) const
+{
+    CHRZONE_RENDERER;
+
+    assert(pipelineLayoutId);
+    assert(size > 0);
+    assert(data != nullptr);
+    assert(_commandBuffer);
+
+    CHRLOG_TRACE("Push constants: offset={}, size={}", offset, size);
+
+    // update the push constants
+    _commandBuffer.pushConstants(pipelineLayoutId, VulkanEnums::shaderStageFlagsToVulkan(stages), offset, size, data);
 }
 
 void VulkanCommandBuffer::beginDebugLabel(const std::string& name, glm::vec4 color) const
@@ -38,8 +38,12 @@ public:
     /// @brief @see BaseCommandBuffer#endRenderPass
     void endRenderPass() const;
 
+    /// @brief @see BaseCommandBuffer#draw
+    void draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) const;
+
     /// @brief @see BaseCommandBuffer#drawIndexed
-    void drawIndexed(uint32_t indexCount, uint32_t instanceCount) const;
+    void drawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset,
+        uint32_t firstInstance) const;
 
     /// @brief @see BaseCommandBuffer#bindPipeline
     void bindPipeline(PipelineId pipelineId) const;
@@ -55,7 +59,12 @@ public:
     void bindIndexBuffer(IndexBufferId indexBufferId, IndexType indexType, uint64_t offset) const;
 
     /// @brief @see BaseCommandBuffer#bindDescriptorSet
-    void bindDescriptorSet(DescriptorSetId descriptorSetId, PipelineLayoutId pipelineLayoutId, uint32_t index) const;
+    void bindDescriptorSet(DescriptorSetId descriptorSetId, PipelineLayoutId pipelineLayoutId, uint32_t index,
+        const std::vector<uint32_t>& dynamicOffsets) const;
+
+    /// @brief @see BaseCommandBuffer#pushConstants
+    void pushConstants(
+        PipelineLayoutId pipelineLayoutId, ShaderStage stages, uint32_t offset, uint32_t size, const void* data) const;
 
     /// @brief @see BaseCommandBuffer#beginDebugLabel
     void beginDebugLabel(const std::string& name, glm::vec4 color) const;
@@ -14,6 +14,7 @@ namespace chronicle::internal::vulkan {
 struct VulkanQueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily {}; ///< Graphics family index.
     std::optional<uint32_t> presentFamily {}; ///< Present family index.
+    std::optional<uint32_t> transferFamily {}; ///< Transfer only family index, not available on every device.
 
     /// @brief Check if families are setted.
     /// @return True if all families are setted, otherwise false.
@@ -32,6 +33,7 @@ struct UniformBufferObject {
     alignas(16) glm::mat4 model {}; ///< Model.
     alignas(16) glm::mat4 view {}; ///< View.
     alignas(16) glm::mat4 proj {}; ///< Projection.
+    alignas(16) glm::mat4 normalModel {}; ///< Inverse transpose of the model, for the normals.
 };
 
 /// @brief Data related to a single frame in flight.
@@ -57,6 +59,13 @@ struct VulkanImageData {
     FrameBufferRef framebuffer {}; ///< Framebuffer main render pass.
 };
 
+/// @brief Statistics of the pipeline cache, reported at the renderer deinit.
+struct VulkanPipelineCacheStats {
+    uint32_t pipelinesCount { 0 }; ///< Created pipelines.
+    uint32_t cacheHits { 0 }; ///< Pipelines found in the cache, available only with pipeline creation feedback.
+    uint64_t creationTime { 0 }; ///< Time spent creating the pipelines, in microseconds.
+};
+
 struct VulkanContext {
     // instance, debugger and surface
     static inline vk::Instance instance {}; ///< Vulkan instance.
@@ -67,13 +76,19 @@ struct VulkanContext {
     static inline vk::PhysicalDevice physicalDevice {}; ///< Physical device.
     static inline vk::Device device {}; ///< Logical device.
 
+    // optional features
+    static inline bool indexTypeUint8 { false }; ///< 8 bit indices supported (VK_EXT_index_type_uint8).
+    static inline bool pipelineCreationFeedback { false }; ///< VK_EXT_pipeline_creation_feedback supported.
+
     // queues
     static inline vk::Queue graphicsQueue {}; ///< Graphics queue.
     static inline vk::Queue presentQueue {}; ///< Presentation queue.
+    static inline vk::Queue transferQueue {}; ///< Queue for the uploads, the graphics queue without a transfer family.
 
     // families
     static inline uint32_t graphicsFamily {}; ///< Graphics family index.
     static inline uint32_t presentFamily {}; ///< Present family index.
+    static inline uint32_t transferFamily {}; ///< Transfer family index.
 
     // swapchain
     static inline vk::SwapchainKHR swapChain {}; ///< Swapchain.
@@ -89,6 +104,11 @@ struct VulkanContext {
     // draw pass
     static inline RenderPassRef renderPass {}; ///< Main render pass.
 
+    // pipeline cache
+    static inline vk::PipelineCache pipelineCache {}; ///< Pipeline cache, persisted in the cache directory.
+    static inline VulkanPipelineCacheStats pipelineCacheStats {}; ///< Pipeline cache statistics.
+    static inline std::mutex pipelineCacheStatsMutex {}; ///< Mutex for the statistics, the pipelines are threaded.
+
     // descriptor sets
     static inline vk::DescriptorPool descriptorPool {}; ///< Descriptor pool used to allocate resources.
 
@@ -105,6 +125,7 @@ struct VulkanContext {
     // options
     static inline int maxFramesInFlight { 3 }; ///< Number of max frames in flights.
     static inline bool enabledValidationLayer { true }; ///< Enabled state for debug validation layers.
+    static inline std::filesystem::path cacheDirectory {}; ///< Shaders and pipelines cache, empty to disable it.
 
     // debug
     static inline bool debugShowLines { false }; ///< Debug show lines.
@@ -3,7 +3,6 @@
 
 #include "VulkanDescriptorSetOld.h"
 
-#include "VulkanGC.h"
 #include "VulkanInstance.h"
 
 namespace chronicle::internal::vulkan {
@@ -21,14 +20,6 @@ VulkanDescriptorSet::~VulkanDescriptorSet()
 
     CHRLOG_TRACE("Destroy descriptor set");
 
-    // clean data inside the binding info
-    for (const auto& state : _descriptorSetsBindingInfo) {
-        if (state.type == vk::DescriptorType::eUniformBuffer) {
-            VulkanGC::add(state.uniform.bufferInfo.buffer);
-            VulkanGC::add(state.uniform.bufferMemory);
-        }
-    }
-
     // clean the descriptor set layout
     if (_descriptorSetLayout)
         VulkanContext::device.destroyDescriptorSetLayout(_descriptorSetLayout);
@@ -64,7 +55,7 @@ void VulkanDescriptorSet::build()
     descriptorWrites.reserve(_descriptorSetsBindingInfo.size());
     for (uint32_t i = 0; i < _descriptorSetsBindingInfo.size(); i++) {
         switch (_descriptorSetsBindingInfo[i].type) {
-        case vk::DescriptorType::eUniformBuffer:
+        case vk::DescriptorType::eUniformBufferDynamic:
             descriptorWrites.push_back(createUniformWriteDescriptorSet(i, _descriptorSetsBindingInfo[i]));
             break;
         case vk::DescriptorType::eCombinedImageSampler:
@@ -83,6 +74,23 @@ void VulkanDescriptorSet::build()
 #endif // VULKAN_ENABLE_DEBUG_MARKER
 }
 
+const std::vector<uint32_t>& VulkanDescriptorSet::dynamicOffsets()
+{
+    CHRZONE_RENDERER;
+
+    // the values not written in the current frame are copied again, the older regions can be overwritten
+    auto frameSerial = VulkanUniformRing::frameSerial();
+    for (uint32_t i = 0; i < _uniforms.size(); i++) {
+        auto& uniform = _uniforms[i];
+        if (uniform.frameSerial != frameSerial) {
+            uniform.offset = VulkanUniformRing::allocate(uniform.data);
+            uniform.frameSerial = frameSerial;
+        }
+        _dynamicOffsets[i] = uniform.offset;
+    }
+    return _dynamicOffsets;
+}
+
 DescriptorSetRef VulkanDescriptorSet::create(const std::string& _name)
 {
     // create an instance of the class
@@ -99,7 +107,7 @@ vk::WriteDescriptorSet VulkanDescriptorSet::createUniformWriteDescriptorSet(
     descriptorWrite.setDstSet(_descriptorSet);
     descriptorWrite.setDstBinding(index);
     descriptorWrite.setDstArrayElement(0);
-    descriptorWrite.setDescriptorType(vk::DescriptorType::eUniformBuffer);
+    descriptorWrite.setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
     descriptorWrite.setDescriptorCount(1);
     descriptorWrite.setBufferInfo(bindingInfo.uniform.bufferInfo);
     return descriptorWrite;
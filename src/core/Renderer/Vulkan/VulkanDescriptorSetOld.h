@@ -10,14 +10,21 @@
 #include "VulkanCommon.h"
 #include "VulkanEnums.h"
 #include "VulkanTexture.h"
+#include "VulkanUniformRing.h"
 #include "VulkanUtils.h"
 
 namespace chronicle::internal::vulkan {
 
 /// @brief Binding data for uniform buffer.
 struct UniformStateBindingData {
-    vk::DeviceMemory bufferMemory {}; ///< Device memory that contain the data.
-    vk::DescriptorBufferInfo bufferInfo {}; ///< Descriptor buffer informations.
+    vk::DescriptorBufferInfo bufferInfo {}; ///< Descriptor buffer informations, the offset is dynamic.
+};
+
+/// @brief Value of a uniform, copied in the uniform ring of the frames that bind it.
+struct VulkanDescriptorSetUniform {
+    std::vector<uint8_t> data {}; ///< Last value set.
+    uint32_t offset { 0 }; ///< Dynamic offset of the value in the uniform ring.
+    uint64_t frameSerial { 0 }; ///< Frame of the offset, zero if the value is not in the ring.
 };
 
 /// @brief Binding data for a sampler.
@@ -60,38 +67,29 @@ public:
         // create the descriptor set layout binding
         vk::DescriptorSetLayoutBinding layoutBinding = {};
         layoutBinding.setBinding(static_cast<uint32_t>(_layoutBindings.size()));
-        layoutBinding.setDescriptorType(vk::DescriptorType::eUniformBuffer);
+        layoutBinding.setDescriptorType(vk::DescriptorType::eUniformBufferDynamic);
         layoutBinding.setDescriptorCount(1);
         layoutBinding.setStageFlags(VulkanEnums::shaderStageToVulkan(stage));
         _layoutBindings.push_back(layoutBinding);
 
-        // create a buffer that is visible to the host, so it can be updated for every frame.
+        // the value is kept on the host, the dynamic offsets are in binding order
         uint32_t bufferSize = sizeof(T);
 
         assert(bufferSize > 0);
 
-        void* bufferMapped;
-        auto [bufferMemory, buffer] = VulkanUtils::createBuffer(bufferSize, vk::BufferUsageFlagBits::eUniformBuffer,
-            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
-        assert(buffer);
-        assert(bufferMemory);
-
-        bufferMapped = VulkanContext::device.mapMemory(bufferMemory, 0, bufferSize);
-
-        assert(bufferMapped);
+        _uniformsIndex[id] = static_cast<uint32_t>(_uniforms.size());
+        _uniforms.push_back({ .data = std::vector<uint8_t>(bufferSize) });
+        _dynamicOffsets.push_back(0);
 
-        _buffersMapped[id] = bufferMapped;
-
-        // create the descriptor buffer informations.
+        // create the descriptor buffer informations, the data is in the uniform ring of the frame.
         vk::DescriptorBufferInfo bufferInfo = {};
-        bufferInfo.setBuffer(buffer);
+        bufferInfo.setBuffer(VulkanUniformRing::buffer());
         bufferInfo.setOffset(0);
         bufferInfo.setRange(bufferSize);
 
         // create and add the descriptor binding informations
-        VulkanDescriptorSetBindingInfo descriptorSetBinding = { .type = vk::DescriptorType::eUniformBuffer,
-            .uniform = { .bufferMemory = bufferMemory, .bufferInfo = bufferInfo } };
+        VulkanDescriptorSetBindingInfo descriptorSetBinding
+            = { .type = vk::DescriptorType::eUniformBufferDynamic, .uniform = { .bufferInfo = bufferInfo } };
         _descriptorSetsBindingInfo.push_back(descriptorSetBinding);
     }
 
@@ -124,9 +122,18 @@ public:
     /// @brief @see BaseDescriptorSet#setUniform
     template <class T> void setUniform(entt::hashed_string::hash_type id, const T& data)
     {
-        std::memcpy(_buffersMapped[id], &data, sizeof(T));
+        assert(_uniformsIndex.contains(id));
+
+        // the frames in flight keep reading their copy, the new value is copied in the ring on the next bind
+        auto& uniform = _uniforms[_uniformsIndex.at(id)];
+        assert(uniform.data.size() == sizeof(T));
+        std::memcpy(uniform.data.data(), &data, sizeof(T));
+        uniform.frameSerial = 0;
     }
 
+    /// @brief @see BaseDescriptorSet#dynamicOffsets
+    [[nodiscard]] const std::vector<uint32_t>& dynamicOffsets();
+
     /// @brief @see BaseDescriptorSet#build
     void build();
 
@@ -143,7 +150,9 @@ private:
     std::vector<vk::DescriptorSetLayoutBinding> _layoutBindings {}; ///< Layout bindings.
     std::vector<VulkanDescriptorSetBindingInfo> _descriptorSetsBindingInfo {}; ///< Descriptor sets binding info.
 
-    std::unordered_map<entt::hashed_string::hash_type, void*> _buffersMapped {}; ///< Map for uniform buffers memory.
+    std::unordered_map<entt::hashed_string::hash_type, uint32_t> _uniformsIndex {}; ///< Map for uniforms index.
+    std::vector<VulkanDescriptorSetUniform> _uniforms {}; ///< Uniforms, in binding order.
+    std::vector<uint32_t> _dynamicOffsets {}; ///< Dynamic offsets of the uniforms for the last bind.
 
     /// @brief Create a write descriptor set for a uniform.
     /// @param index Descriptor set index.
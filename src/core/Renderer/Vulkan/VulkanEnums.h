@@ -40,6 +40,8 @@ public:
     static vk::IndexType indexTypeToVulkan(IndexType indexType)
     {
         switch (indexType) {
+        case IndexType::uint8:
+            return vk::IndexType::eUint8EXT;
         case IndexType::uint16:
             return vk::IndexType::eUint16;
         case IndexType::uint32:
@@ -49,6 +51,18 @@ public:
         }
     }
 
+    static vk::VertexInputRate vertexInputRateToVulkan(VertexInputRate inputRate)
+    {
+        switch (inputRate) {
+        case VertexInputRate::vertex:
+            return vk::VertexInputRate::eVertex;
+        case VertexInputRate::instance:
+            return vk::VertexInputRate::eInstance;
+        default:
+            throw RendererError("Unsupported vertex input rate");
+        }
+    }
+
     static vk::Format formatToVulkan(Format format)
     {
         switch (format) {
@@ -85,6 +99,16 @@ public:
         case Format::R8G8B8A8Unorm:
             return vk::Format::eR8G8B8A8Unorm;
 
+            // 8 bit signed normalized
+        case Format::R8Snorm:
+            return vk::Format::eR8Snorm;
+        case Format::R8G8Snorm:
+            return vk::Format::eR8G8Snorm;
+        case Format::R8G8B8Snorm:
+            return vk::Format::eR8G8B8Snorm;
+        case Format::R8G8B8A8Snorm:
+            return vk::Format::eR8G8B8A8Snorm;
+
             // 16 bit signed int
         case Format::R16Sint:
             return vk::Format::eR16Sint;
@@ -115,6 +139,26 @@ public:
         case Format::R16G16B16A16Unorm:
             return vk::Format::eR16G16B16A16Unorm;
 
+            // 16 bit signed normalized
+        case Format::R16Snorm:
+            return vk::Format::eR16Snorm;
+        case Format::R16G16Snorm:
+            return vk::Format::eR16G16Snorm;
+        case Format::R16G16B16Snorm:
+            return vk::Format::eR16G16B16Snorm;
+        case Format::R16G16B16A16Snorm:
+            return vk::Format::eR16G16B16A16Snorm;
+
+            // 16 bit signed float
+        case Format::R16Sfloat:
+            return vk::Format::eR16Sfloat;
+        case Format::R16G16Sfloat:
+            return vk::Format::eR16G16Sfloat;
+        case Format::R16G16B16Sfloat:
+            return vk::Format::eR16G16B16Sfloat;
+        case Format::R16G16B16A16Sfloat:
+            return vk::Format::eR16G16B16A16Sfloat;
+
             // 32 bit signed int
         case Format::R32Sint:
             return vk::Format::eR32Sint;
@@ -145,6 +189,24 @@ public:
         case Format::R32G32B32A32Sfloat:
             return vk::Format::eR32G32B32A32Sfloat;
 
+            // block compressed
+        case Format::BC1RgbaUnorm:
+            return vk::Format::eBc1RgbaUnormBlock;
+        case Format::BC3Unorm:
+            return vk::Format::eBc3UnormBlock;
+        case Format::BC4Unorm:
+            return vk::Format::eBc4UnormBlock;
+        case Format::BC5Unorm:
+            return vk::Format::eBc5UnormBlock;
+        case Format::BC7Unorm:
+            return vk::Format::eBc7UnormBlock;
+        case Format::ETC2R8G8B8Unorm:
+            return vk::Format::eEtc2R8G8B8UnormBlock;
+        case Format::ETC2R8G8B8A8Unorm:
+            return vk::Format::eEtc2R8G8B8A8UnormBlock;
+        case Format::ASTC4x4Unorm:
+            return vk::Format::eAstc4x4UnormBlock;
+
         case Format::B8G8R8A8Unorm:
             return vk::Format::eB8G8R8A8Unorm;
         case Format::D32Sfloat:
@@ -194,6 +256,16 @@ public:
         case vk::Format::eR8G8B8A8Unorm:
             return Format::R8G8B8A8Unorm;
 
+            // 8 bit signed normalized
+        case vk::Format::eR8Snorm:
+            return Format::R8Snorm;
+        case vk::Format::eR8G8Snorm:
+            return Format::R8G8Snorm;
+        case vk::Format::eR8G8B8Snorm:
+            return Format::R8G8B8Snorm;
+        case vk::Format::eR8G8B8A8Snorm:
+            return Format::R8G8B8A8Snorm;
+
             // 16 bit signed int
         case vk::Format::eR16Sint:
             return Format::R16Sint;
@@ -224,6 +296,26 @@ public:
         case vk::Format::eR16G16B16A16Unorm:
             return Format::R16G16B16A16Unorm;
 
+            // 16 bit signed normalized
+        case vk::Format::eR16Snorm:
+            return Format::R16Snorm;
+        case vk::Format::eR16G16Snorm:
+            return Format::R16G16Snorm;
+        case vk::Format::eR16G16B16Snorm:
+            return Format::R16G16B16Snorm;
+        case vk::Format::eR16G16B16A16Snorm:
+            return Format::R16G16B16A16Snorm;
+
+            // 16 bit signed float
+        case vk::Format::eR16Sfloat:
+            return Format::R16Sfloat;
+        case vk::Format::eR16G16Sfloat:
+            return Format::R16G16Sfloat;
+        case vk::Format::eR16G16B16Sfloat:
+            return Format::R16G16B16Sfloat;
+        case vk::Format::eR16G16B16A16Sfloat:
+            return Format::R16G16B16A16Sfloat;
+
             // 32 bit signed int
         case vk::Format::eR32Sint:
             return Format::R32Sint;
@@ -254,6 +346,24 @@ public:
         case vk::Format::eR32G32B32A32Sfloat:
             return Format::R32G32B32A32Sfloat;
 
+            // block compressed
+        case vk::Format::eBc1RgbaUnormBlock:
+            return Format::BC1RgbaUnorm;
+        case vk::Format::eBc3UnormBlock:
+            return Format::BC3Unorm;
+        case vk::Format::eBc4UnormBlock:
+            return Format::BC4Unorm;
+        case vk::Format::eBc5UnormBlock:
+            return Format::BC5Unorm;
+        case vk::Format::eBc7UnormBlock:
+            return Format::BC7Unorm;
+        case vk::Format::eEtc2R8G8B8UnormBlock:
+            return Format::ETC2R8G8B8Unorm;
+        case vk::Format::eEtc2R8G8B8A8UnormBlock:
+            return Format::ETC2R8G8B8A8Unorm;
+        case vk::Format::eAstc4x4UnormBlock:
+            return Format::ASTC4x4Unorm;
+
         case vk::Format::eB8G8R8A8Unorm:
             return Format::B8G8R8A8Unorm;
         case vk::Format::eD32Sfloat:
@@ -386,6 +496,44 @@ public:
             throw RendererError("Unsupported image layout");
         }
     }
+
+    static vk::Filter filterToVulkan(Filter filter)
+    {
+        switch (filter) {
+        case Filter::nearest:
+            return vk::Filter::eNearest;
+        case Filter::linear:
+            return vk::Filter::eLinear;
+        default:
+            throw RendererError("Unsupported filter");
+        }
+    }
+
+    static vk::SamplerMipmapMode samplerMipmapModeToVulkan(SamplerMipmapMode samplerMipmapMode)
+    {
+        switch (samplerMipmapMode) {
+        case SamplerMipmapMode::nearest:
+            return vk::SamplerMipmapMode::eNearest;
+        case SamplerMipmapMode::linear:
+            return vk::SamplerMipmapMode::eLinear;
+        default:
+            throw RendererError("Unsupported sampler mipmap mode");
+        }
+    }
+
+    static vk::SamplerAddressMode samplerAddressModeToVulkan(SamplerAddressMode samplerAddressMode)
+    {
+        switch (samplerAddressMode) {
+        case SamplerAddressMode::repeat:
+            return vk::SamplerAddressMode::eRepeat;
+        case SamplerAddressMode::mirroredRepeat:
+            return vk::SamplerAddressMode::eMirroredRepeat;
+        case SamplerAddressMode::clampToEdge:
+            return vk::SamplerAddressMode::eClampToEdge;
+        default:
+            throw RendererError("Unsupported sampler address mode");
+        }
+    }
 };
 
 } // namespace chronicle
\ No newline at end of file
@@ -6,11 +6,12 @@
 #include "pch.h"
 
 #include "Renderer/Renderer.h"
+#include "VulkanMemoryAllocator.h"
 
 namespace chronicle::internal::vulkan {
 
 /// @brief Entry types for garbage collector.
-enum class GCType { pipeline, pipelineLayout, buffer, deviceMemory, descriptorSetLayout };
+enum class GCType { pipeline, pipelineLayout, buffer, allocation, geometryRange, descriptorSetLayout };
 
 /// @brief Garbage collector data.
 struct GCData {
@@ -19,7 +20,8 @@ struct GCData {
         vk::Pipeline pipeline; ///< Pipeline
         vk::PipelineLayout pipelineLayout; ///< Pipeline layout
         vk::Buffer buffer; ///< Buffer
-        vk::DeviceMemory deviceMemory; ///< Device memory
+        VulkanAllocation allocation; ///< Device memory allocation
+        GeometryRange geometryRange; ///< Geometry pool range
         vk::DescriptorSetLayout descriptorSetLayout; ///< Descriptor set layout
     };
 
@@ -41,9 +43,15 @@ struct GCData {
     {
     }
 
-    explicit GCData(vk::DeviceMemory deviceMemory)
-        : type(GCType::deviceMemory)
-        , deviceMemory(deviceMemory)
+    explicit GCData(const VulkanAllocation& allocation)
+        : type(GCType::allocation)
+        , allocation(allocation)
+    {
+    }
+
+    explicit GCData(const GeometryRange& geometryRange)
+        : type(GCType::geometryRange)
+        , geometryRange(geometryRange)
     {
     }
 
@@ -104,8 +112,11 @@ private:
             case GCType::buffer:
                 VulkanContext::device.destroyBuffer(item.buffer);
                 break;
-            case GCType::deviceMemory:
-                VulkanContext::device.freeMemory(item.deviceMemory);
+            case GCType::allocation:
+                VulkanMemoryAllocator::free(item.allocation);
+                break;
+            case GCType::geometryRange:
+                VulkanGeometryPool::release(item.geometryRange);
                 break;
             case GCType::descriptorSetLayout:
                 VulkanContext::device.destroyDescriptorSetLayout(item.descriptorSetLayout);
@@ -0,0 +1,256 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "VulkanGeometryPool.h"
+
+#include "VulkanGC.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanUploadManager.h"
+#include "VulkanUtils.h"
+
+namespace chronicle::internal::vulkan {
+
+constexpr vk::DeviceSize VertexPageSize = 64 * 1024 * 1024; ///< Size of the vertex pages.
+constexpr vk::DeviceSize IndexPageSize = 32 * 1024 * 1024; ///< Size of the index pages.
+
+/// @brief Buffer of the pool.
+struct VulkanGeometryPage {
+    GeometryBufferType type { GeometryBufferType::vertex }; ///< Kind of the buffer.
+    vk::Buffer buffer {}; ///< Buffer, null if the slot is free.
+    VulkanAllocation allocation {}; ///< Device memory for the buffer.
+    vk::DeviceSize size { 0 }; ///< Buffer size.
+    std::map<vk::DeviceSize, vk::DeviceSize> freeRanges {}; ///< Free ranges, offset to size.
+};
+
+struct VulkanGeometryPoolContext {
+    static inline std::vector<VulkanGeometryPage> pages {}; ///< Pages of all the kinds.
+    static inline std::mutex mutex {}; ///< Mutex for the pages.
+};
+
+void VulkanGeometryPool::init()
+{
+    CHRZONE_RENDERER;
+
+    CHRLOG_TRACE("Geometry pool init");
+
+    // the pages are created on the first allocations
+    VulkanGeometryPoolContext::pages.clear();
+}
+
+void VulkanGeometryPool::deinit()
+{
+    CHRZONE_RENDERER;
+
+    CHRLOG_TRACE("Geometry pool deinit");
+
+    std::scoped_lock<std::mutex> lock(VulkanGeometryPoolContext::mutex);
+
+    for (auto& page : VulkanGeometryPoolContext::pages) {
+        if (page.buffer) {
+            destroyPage(page);
+        }
+    }
+    VulkanGeometryPoolContext::pages.clear();
+}
+
+GeometryRange VulkanGeometryPool::allocateVertices(std::span<const uint8_t> data, uint32_t stride)
+{
+    CHRZONE_RENDERER;
+
+    assert(stride > 0);
+
+    return allocate(GeometryBufferType::vertex, data, stride);
+}
+
+GeometryRange VulkanGeometryPool::allocateIndices(std::span<const uint8_t> data, IndexType indexType)
+{
+    CHRZONE_RENDERER;
+
+    assert(indexType != IndexType::undefined);
+
+    // the first index is counted in elements of the bound index type
+    vk::DeviceSize indexSize = 4;
+    if (indexType == IndexType::uint8) {
+        indexSize = 1;
+    } else if (indexType == IndexType::uint16) {
+        indexSize = 2;
+    }
+
+    return allocate(GeometryBufferType::index, data, indexSize);
+}
+
+void VulkanGeometryPool::free(const GeometryRange& range)
+{
+    CHRZONE_RENDERER;
+
+    // the range can be still used by the frames in flight
+    if (range) {
+        VulkanGC::add(range);
+    }
+}
+
+void VulkanGeometryPool::release(const GeometryRange& range)
+{
+    CHRZONE_RENDERER;
+
+    assert(range);
+
+    std::scoped_lock<std::mutex> lock(VulkanGeometryPoolContext::mutex);
+
+    auto& pages = VulkanGeometryPoolContext::pages;
+    assert(range.page < pages.size());
+    auto& page = pages[range.page];
+    assert(page.buffer == range.bufferId);
+
+    // merge the range with the free neighbours
+    auto offset = range.offset;
+    auto size = range.size;
+    auto& freeRanges = page.freeRanges;
+    if (auto next = freeRanges.find(offset + size); next != freeRanges.end()) {
+        size += next->second;
+        freeRanges.erase(next);
+    }
+    if (auto next = freeRanges.lower_bound(offset); next != freeRanges.begin()) {
+        if (auto prev = std::prev(next); prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            freeRanges.erase(prev);
+        }
+    }
+    freeRanges.emplace(offset, size);
+
+    // an empty page is kept only if it's the last one of its kind
+    if (size == page.size) {
+        auto livePages = std::ranges::count_if(
+            pages, [&page](const VulkanGeometryPage& other) { return other.buffer && other.type == page.type; });
+        if (livePages > 1) {
+            destroyPage(page);
+        }
+    }
+}
+
+GeometryRange VulkanGeometryPool::allocate(
+    GeometryBufferType type, std::span<const uint8_t> data, vk::DeviceSize alignment)
+{
+    CHRZONE_RENDERER;
+
+    assert(!data.empty());
+    assert(alignment > 0);
+
+    GeometryRange range = {};
+    range.type = type;
+    range.size = data.size();
+
+    {
+        std::scoped_lock<std::mutex> lock(VulkanGeometryPoolContext::mutex);
+
+        auto& pages = VulkanGeometryPoolContext::pages;
+
+        // first fit in the pages of the same kind
+        std::optional<vk::DeviceSize> offset = {};
+        for (uint32_t i = 0; i < pages.size() && !offset; i++) {
+            if (pages[i].buffer && pages[i].type == type) {
+                offset = takeRange(pages[i], range.size, alignment);
+                range.page = i;
+            }
+        }
+
+        // a new page, the data bigger than a page gets its own
+        if (!offset) {
+            auto pageSize = type == GeometryBufferType::vertex ? VertexPageSize : IndexPageSize;
+            range.page = createPage(type, std::max(pageSize, range.size));
+            offset = takeRange(pages[range.page], range.size, alignment);
+            assert(offset);
+        }
+
+        range.bufferId = pages[range.page].buffer;
+        range.offset = *offset;
+        range.first = static_cast<uint32_t>(range.offset / alignment);
+    }
+
+    CHRLOG_TRACE("Geometry pool allocation: page={}, offset={}, size={}", range.page, range.offset, range.size);
+
+    // the range is reserved, the copy doesn't need the pool lock
+    VulkanUploadManager::uploadBuffer(range.bufferId, data, range.offset);
+
+    return range;
+}
+
+std::optional<vk::DeviceSize> VulkanGeometryPool::takeRange(
+    VulkanGeometryPage& page, vk::DeviceSize size, vk::DeviceSize alignment)
+{
+    auto& freeRanges = page.freeRanges;
+    for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+        auto [freeOffset, freeSize] = *it;
+
+        // the alignment is the element size, so it's not always a power of two
+        auto offset = (freeOffset + alignment - 1) / alignment * alignment;
+        if (offset + size > freeOffset + freeSize) {
+            continue;
+        }
+
+        // the padding before and the space after the range stay free
+        freeRanges.erase(it);
+        if (offset > freeOffset) {
+            freeRanges.emplace(freeOffset, offset - freeOffset);
+        }
+        if (offset + size < freeOffset + freeSize) {
+            freeRanges.emplace(offset + size, freeOffset + freeSize - offset - size);
+        }
+        return offset;
+    }
+    return {};
+}
+
+uint32_t VulkanGeometryPool::createPage(GeometryBufferType type, vk::DeviceSize size)
+{
+    CHRZONE_RENDERER;
+
+    CHRLOG_DEBUG("Create geometry pool page: type={}, size={}",
+        type == GeometryBufferType::vertex ? "vertex" : "index", size);
+
+    auto& pages = VulkanGeometryPoolContext::pages;
+
+    // reuse the slot of a destroyed page, the index of the others must not change
+    auto it = std::ranges::find_if(pages, [](const VulkanGeometryPage& page) { return !page.buffer; });
+    if (it == pages.end()) {
+        it = pages.emplace(pages.end());
+    }
+    auto pageIndex = static_cast<uint32_t>(std::distance(pages.begin(), it));
+
+    auto usage = vk::BufferUsageFlagBits::eTransferDst
+        | (type == GeometryBufferType::vertex ? vk::BufferUsageFlagBits::eVertexBuffer
+                                              : vk::BufferUsageFlagBits::eIndexBuffer);
+    auto [allocation, buffer] = VulkanUtils::createBuffer(size, usage, vk::MemoryPropertyFlagBits::eDeviceLocal);
+
+    it->type = type;
+    it->buffer = buffer;
+    it->allocation = allocation;
+    it->size = size;
+    it->freeRanges.clear();
+    it->freeRanges.emplace(0, size);
+
+#ifdef VULKAN_ENABLE_DEBUG_MARKER
+    VulkanUtils::setDebugObjectName(buffer,
+        fmt::format("Geometry pool {} page {}", type == GeometryBufferType::vertex ? "vertex" : "index", pageIndex));
+#endif // VULKAN_ENABLE_DEBUG_MARKER
+
+    return pageIndex;
+}
+
+void VulkanGeometryPool::destroyPage(VulkanGeometryPage& page)
+{
+    CHRZONE_RENDERER;
+
+    CHRLOG_DEBUG("Destroy geometry pool page: size={}", page.size);
+
+    VulkanContext::device.destroyBuffer(page.buffer);
+    VulkanMemoryAllocator::free(page.allocation);
+
+    page.buffer = nullptr;
+    page.allocation = {};
+    page.size = 0;
+    page.freeRanges.clear();
+}
+
+} // namespace chronicle::internal::vulkan
@@ -0,0 +1,68 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "Renderer/BaseGeometryPool.h"
+#include "VulkanCommon.h"
+
+namespace chronicle::internal::vulkan {
+
+struct VulkanGeometryPage;
+
+/// @brief Vulkan implementation for @ref BaseGeometryPool
+///        Every kind of geometry has a list of pages, device local buffers sub-allocated with a free list sorted by
+///        offset, so the freed ranges are merged with their neighbours. The data is copied with
+///        @ref VulkanUploadManager, so the new ranges are ready for the next frame.
+class VulkanGeometryPool : public BaseGeometryPool<VulkanGeometryPool>, private NonCopyable<VulkanGeometryPool> {
+public:
+    /// @brief Initialize the pool, after the upload manager.
+    static void init();
+
+    /// @brief Destroy the pages, when the GPU doesn't use them anymore.
+    static void deinit();
+
+    /// @brief @see BaseGeometryPool#allocateVertices
+    [[nodiscard]] static GeometryRange allocateVertices(std::span<const uint8_t> data, uint32_t stride);
+
+    /// @brief @see BaseGeometryPool#allocateIndices
+    [[nodiscard]] static GeometryRange allocateIndices(std::span<const uint8_t> data, IndexType indexType);
+
+    /// @brief @see BaseGeometryPool#free
+    static void free(const GeometryRange& range);
+
+    /// @brief Give a range back to its page immediately, called by the garbage collector.
+    /// @param range Range to release.
+    static void release(const GeometryRange& range);
+
+private:
+    /// @brief Sub-allocate a range and copy the data into it.
+    /// @param type Kind of the buffer.
+    /// @param data Data to copy.
+    /// @param alignment Alignment of the range, the size of an element (not necessarily a power of two).
+    /// @return The range.
+    [[nodiscard]] static GeometryRange allocate(
+        GeometryBufferType type, std::span<const uint8_t> data, vk::DeviceSize alignment);
+
+    /// @brief Take a range from the free list of a page.
+    /// @param page Page.
+    /// @param size Range size.
+    /// @param alignment Range alignment.
+    /// @return Offset of the range, or an empty value if the page has no space.
+    [[nodiscard]] static std::optional<vk::DeviceSize> takeRange(
+        VulkanGeometryPage& page, vk::DeviceSize size, vk::DeviceSize alignment);
+
+    /// @brief Create a page, reusing the slot of a released one.
+    /// @param type Kind of the buffer.
+    /// @param size Page size.
+    /// @return Index of the page.
+    [[nodiscard]] static uint32_t createPage(GeometryBufferType type, vk::DeviceSize size);
+
+    /// @brief Destroy the buffer of a page, the slot can be reused.
+    /// @param page Page.
+    static void destroyPage(VulkanGeometryPage& page);
+};
+
+} // namespace chronicle::internal::vulkan
@@ -6,6 +6,7 @@
 #include "pch.h"
 
 #include "Renderer/BaseIndexBuffer.h"
+#include "VulkanMemoryAllocator.h"
 
 namespace chronicle::internal::vulkan {
 
@@ -31,7 +32,7 @@ public:
 private:
     std::string _name {}; ///< Name.
     vk::Buffer _buffer {}; ///< Buffer.
-    vk::DeviceMemory _bufferMemory {}; ///< Device memory for the buffer.
+    VulkanAllocation _bufferAllocation {}; ///< Device memory for the buffer.
 };
 
 } // namespace chronicle
\ No newline at end of file
@@ -7,8 +7,12 @@
 #include "VulkanExtensions.h"
 #include "VulkanFrameBuffer.h"
 #include "VulkanGC.h"
+#include "VulkanGeometryPool.h"
 #include "VulkanInstance.h"
+#include "VulkanMemoryAllocator.h"
 #include "VulkanRenderPass.h"
+#include "VulkanUniformRing.h"
+#include "VulkanUploadManager.h"
 #include "VulkanUtils.h"
 
 #ifdef GLFW_PLATFORM
@@ -23,6 +27,22 @@ const std::vector<const char*> VALIDATION_LAYERS = { "VK_LAYER_KHRONOS_validatio
 
 const std::vector<const char*> DEVICE_EXTENSIONS = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 
+constexpr uint32_t PipelineCacheMagic = 0x50524843; ///< "CHRP"
+constexpr uint32_t PipelineCacheVersion = 1;
+constexpr const char* PipelineCacheFilename = "PipelineCache.bin";
+
+/// @brief Header of the pipeline cache file, the cache data follows it.
+///        The data is used only by the same device with the same driver.
+struct PipelineCacheFileHeader {
+    uint32_t magic; ///< Magic number.
+    uint32_t version; ///< File version.
+    uint32_t vendorID; ///< Device vendor.
+    uint32_t deviceID; ///< Device identifier.
+    uint32_t driverVersion; ///< Driver version.
+    std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUUID; ///< Device pipeline cache UUID.
+    uint64_t dataSize; ///< Cache data size.
+};
+
 CHR_CONCRETE(VulkanInstance);
 
 /// @brief Debug messages callback.
@@ -62,8 +82,13 @@ void VulkanInstance::init()
     createSurface();
     pickPhysicalDevice();
     createLogicalDevice();
+    VulkanMemoryAllocator::init();
+    createPipelineCache();
     createSwapChain();
     createCommandPool();
+    VulkanUploadManager::init();
+    VulkanGeometryPool::init();
+    VulkanUniformRing::init();
     createRenderPass();
     createFramebuffers();
     createSyncObjects();
@@ -90,6 +115,15 @@ void VulkanInstance::deinit()
     // wait for garbage collector destruction
     VulkanContext::device.waitIdle();
 
+    // destroy the staging ring
+    VulkanUploadManager::deinit();
+
+    // destroy the geometry pool pages
+    VulkanGeometryPool::deinit();
+
+    // destroy the uniform ring
+    VulkanUniformRing::deinit();
+
     // destroy destriptor pool
     VulkanContext::device.destroyDescriptorPool(VulkanContext::descriptorPool);
 
@@ -112,6 +146,12 @@ void VulkanInstance::deinit()
     // destroy command pool
     VulkanContext::device.destroyCommandPool(VulkanContext::commandPool);
 
+    // save and destroy the pipeline cache
+    destroyPipelineCache();
+
+    // free the device memory blocks
+    VulkanMemoryAllocator::deinit();
+
     // destroy device
     VulkanContext::device.destroy();
 
@@ -190,7 +230,7 @@ void VulkanInstance::createInstance()
     appInfo.setApplicationVersion(VK_MAKE_VERSION(1, 0, 0));
     appInfo.setPEngineName("Chronicle");
     appInfo.setEngineVersion(VK_MAKE_VERSION(1, 0, 0));
-    appInfo.setApiVersion(VK_API_VERSION_1_0);
+    appInfo.setApiVersion(VK_API_VERSION_1_1);
 
     // prepare create instance info
     vk::InstanceCreateInfo createInfo = {};
@@ -293,6 +333,9 @@ void VulkanInstance::createLogicalDevice()
     // prepare the device create info for every family
     std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos;
     std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value() };
+    if (indices.transferFamily) {
+        uniqueQueueFamilies.insert(indices.transferFamily.value());
+    }
     std::array<float, 1> queuePriorities = { 1.0f };
     for (auto queueFamily : uniqueQueueFamilies) {
         vk::DeviceQueueCreateInfo queueCreateInfo = {};
@@ -307,11 +350,43 @@ void VulkanInstance::createLogicalDevice()
     deviceFeatures.setSamplerAnisotropy(true);
     deviceFeatures.setFillModeNonSolid(true);
 
+    // block compressed textures, when available
+    auto supportedFeatures = VulkanContext::physicalDevice.getFeatures();
+    deviceFeatures.setTextureCompressionBC(supportedFeatures.textureCompressionBC);
+    deviceFeatures.setTextureCompressionETC2(supportedFeatures.textureCompressionETC2);
+    deviceFeatures.setTextureCompressionASTC_LDR(supportedFeatures.textureCompressionASTC_LDR);
+
     // create the logical device
     vk::DeviceCreateInfo createInfo = {};
     createInfo.setQueueCreateInfos(queueCreateInfos);
     createInfo.setPEnabledFeatures(&deviceFeatures);
-    createInfo.setPEnabledExtensionNames(DEVICE_EXTENSIONS);
+
+    // enable the optional extensions when supported
+    std::vector<const char*> extensions = DEVICE_EXTENSIONS;
+    auto indexTypeUint8Features = vk::PhysicalDeviceIndexTypeUint8FeaturesEXT();
+    VulkanContext::indexTypeUint8 = false;
+    if (VulkanUtils::checkDeviceExtensionSupport(
+            VulkanContext::physicalDevice, { VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME })) {
+        auto features = VulkanContext::physicalDevice
+                            .getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceIndexTypeUint8FeaturesEXT>();
+        if (features.get<vk::PhysicalDeviceIndexTypeUint8FeaturesEXT>().indexTypeUint8) {
+            extensions.push_back(VK_EXT_INDEX_TYPE_UINT8_EXTENSION_NAME);
+            indexTypeUint8Features.setIndexTypeUint8(true);
+            createInfo.setPNext(&indexTypeUint8Features);
+            VulkanContext::indexTypeUint8 = true;
+        }
+    }
+    CHRLOG_DEBUG("8 bit indices support: {}", VulkanContext::indexTypeUint8);
+
+    // pipeline creation feedback is used only to report the cache hits
+    VulkanContext::pipelineCreationFeedback = VulkanUtils::checkDeviceExtensionSupport(
+        VulkanContext::physicalDevice, { VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME });
+    if (VulkanContext::pipelineCreationFeedback) {
+        extensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+    }
+    CHRLOG_DEBUG("Pipeline creation feedback support: {}", VulkanContext::pipelineCreationFeedback);
+
+    createInfo.setPEnabledExtensionNames(extensions);
     if (VulkanContext::enabledValidationLayer)
         createInfo.setPEnabledLayerNames(VALIDATION_LAYERS);
     VulkanContext::device = VulkanContext::physicalDevice.createDevice(createInfo);
@@ -321,6 +396,11 @@ void VulkanInstance::createLogicalDevice()
     VulkanContext::presentQueue = VulkanContext::device.getQueue(indices.presentFamily.value(), 0);
     VulkanContext::graphicsFamily = indices.graphicsFamily.value();
     VulkanContext::presentFamily = indices.presentFamily.value();
+
+    // without a transfer family the uploads go on the graphics queue
+    VulkanContext::transferFamily = indices.transferFamily.value_or(VulkanContext::graphicsFamily);
+    VulkanContext::transferQueue = VulkanContext::device.getQueue(VulkanContext::transferFamily, 0);
+    CHRLOG_DEBUG("Dedicated transfer queue: {}", indices.transferFamily.has_value());
 }
 
 void VulkanInstance::createSwapChain()
@@ -481,7 +561,7 @@ void VulkanInstance::createDescriptorPool()
 
     // some default sizes for the pool
     std::vector<vk::DescriptorPoolSize> sizes
-        = { { vk::DescriptorType::eUniformBuffer, 1000 }, { vk::DescriptorType::eCombinedImageSampler, 1000 } };
+        = { { vk::DescriptorType::eUniformBufferDynamic, 1000 }, { vk::DescriptorType::eCombinedImageSampler, 1000 } };
 
     // create the pool
     vk::DescriptorPoolCreateInfo poolInfo = {};
@@ -490,4 +570,104 @@ void VulkanInstance::createDescriptorPool()
     VulkanContext::descriptorPool = VulkanContext::device.createDescriptorPool(poolInfo, nullptr);
 }
 
+void VulkanInstance::createPipelineCache()
+{
+    CHRZONE_RENDERER;
+
+    CHRLOG_TRACE("Create pipeline cache");
+
+    VulkanContext::pipelineCacheStats = {};
+
+    // load the data saved by the previous run, if it was created by the same device and driver
+    std::vector<uint8_t> initialData = {};
+    if (!VulkanContext::cacheDirectory.empty()) {
+        auto filename = VulkanContext::cacheDirectory / PipelineCacheFilename;
+        std::ifstream file(filename, std::ios::binary);
+        PipelineCacheFileHeader header = {};
+        if (file.is_open() && file.read(std::bit_cast<char*>(&header), sizeof(PipelineCacheFileHeader))) {
+            auto properties = VulkanContext::physicalDevice.getProperties();
+            auto validFile = header.magic == PipelineCacheMagic && header.version == PipelineCacheVersion
+                && header.dataSize == std::filesystem::file_size(filename) - sizeof(PipelineCacheFileHeader);
+            auto sameDevice = header.vendorID == properties.vendorID && header.deviceID == properties.deviceID
+                && header.driverVersion == properties.driverVersion
+                && std::memcmp(header.pipelineCacheUUID.data(), properties.pipelineCacheUUID.data(), VK_UUID_SIZE)
+                    == 0;
+            if (validFile && sameDevice) {
+                initialData.resize(header.dataSize);
+                auto dataSize = static_cast<std::streamsize>(header.dataSize);
+                if (!file.read(std::bit_cast<char*>(initialData.data()), dataSize)) {
+                    initialData.clear();
+                }
+            } else {
+                CHRLOG_INFO("Pipeline cache {} is invalid or created by another device", filename.string());
+            }
+        }
+    }
+
+    vk::PipelineCacheCreateInfo createInfo = {};
+    createInfo.setInitialDataSize(initialData.size());
+    createInfo.setPInitialData(initialData.data());
+
+    try {
+        VulkanContext::pipelineCache = VulkanContext::device.createPipelineCache(createInfo);
+    } catch (const vk::SystemError& error) {
+        // the driver can reject the data, start from an empty cache
+        CHRLOG_WARN("Invalid pipeline cache data: {}", error.what());
+        VulkanContext::pipelineCache = VulkanContext::device.createPipelineCache({});
+    }
+
+    CHRLOG_DEBUG("Pipeline cache loaded: {} bytes", initialData.size());
+}
+
+void VulkanInstance::destroyPipelineCache()
+{
+    CHRZONE_RENDERER;
+
+    CHRLOG_TRACE("Destroy pipeline cache");
+
+    const auto& stats = VulkanContext::pipelineCacheStats;
+    if (VulkanContext::pipelineCreationFeedback) {
+        CHRLOG_INFO("Pipeline cache: {} pipelines created in {} ms, {} cache hits", stats.pipelinesCount,
+            stats.creationTime / 1000.0f, stats.cacheHits);
+    } else {
+        CHRLOG_INFO(
+            "Pipeline cache: {} pipelines created in {} ms", stats.pipelinesCount, stats.creationTime / 1000.0f);
+    }
+
+    if (!VulkanContext::cacheDirectory.empty()) {
+        auto data = VulkanContext::device.getPipelineCacheData(VulkanContext::pipelineCache);
+        auto properties = VulkanContext::physicalDevice.getProperties();
+
+        PipelineCacheFileHeader header = {};
+        header.magic = PipelineCacheMagic;
+        header.version = PipelineCacheVersion;
+        header.vendorID = properties.vendorID;
+        header.deviceID = properties.deviceID;
+        header.driverVersion = properties.driverVersion;
+        std::memcpy(header.pipelineCacheUUID.data(), properties.pipelineCacheUUID.data(), VK_UUID_SIZE);
+        header.dataSize = data.size();
+
+        // write in a temporary file, so a failed write never leave a broken cache
+        std::error_code errorCode = {};
+        std::filesystem::create_directories(VulkanContext::cacheDirectory, errorCode);
+        auto filename = VulkanContext::cacheDirectory / PipelineCacheFilename;
+        auto temporaryFilename = filename;
+        temporaryFilename += ".tmp";
+
+        std::ofstream file(temporaryFilename, std::ios::binary | std::ios::out | std::ios::trunc);
+        file.write(std::bit_cast<const char*>(&header), sizeof(PipelineCacheFileHeader));
+        file.write(std::bit_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        file.close();
+        if (file.good()) {
+            std::filesystem::rename(temporaryFilename, filename, errorCode);
+            CHRLOG_DEBUG("Pipeline cache saved: {} bytes", data.size());
+        } else {
+            CHRLOG_WARN("Failed to write file {}", temporaryFilename.string());
+        }
+    }
+
+    VulkanContext::device.destroyPipelineCache(VulkanContext::pipelineCache);
+    VulkanContext::pipelineCache = nullptr;
+}
+
 } // namespace chronicle
\ No newline at end of file
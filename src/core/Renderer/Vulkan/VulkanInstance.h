@@ -68,6 +68,12 @@ private:
     /// @brief Create the descriptor pool.
     static void createDescriptorPool();
 
+    /// @brief Create the pipeline cache, with the data saved by the previous run if it's valid for the device.
+    static void createPipelineCache();
+
+    /// @brief Save the pipeline cache in the cache directory and destroy it.
+    static void destroyPipelineCache();
+
     friend class VulkanRenderContext;
 };
 
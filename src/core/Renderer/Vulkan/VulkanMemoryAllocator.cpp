@@ -0,0 +1,468 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "VulkanMemoryAllocator.h"
+
+#include "VulkanUtils.h"
+
+namespace chronicle::internal::vulkan {
+
+constexpr vk::DeviceSize DefaultBlockSize = 64 * 1024 * 1024; ///< Block size for the large heaps.
+constexpr vk::DeviceSize MinChunkSize = 256; ///< Granularity of the offsets and sizes in a block.
+constexpr uint32_t SecondLevelBits = 4; ///< Every power of two is split in 16 size classes.
+constexpr uint32_t SecondLevelCount = 1 << SecondLevelBits;
+constexpr uint32_t FirstLevelCount = 64;
+constexpr uint32_t InvalidChunk = std::numeric_limits<uint32_t>::max();
+
+/// @brief Block of device memory, sub-allocated with a two-level segregated fit allocator.
+///        The first level splits the free chunks by power of two, the second level in linear size classes. A
+///        bitmap for every level finds the smallest class that fits a request with two bit scans.
+class VulkanMemoryBlock : private NonCopyable<VulkanMemoryBlock> {
+public:
+    /// @brief Constructor.
+    /// @param memory Device memory of the block.
+    /// @param size Block size, multiple of the chunk granularity.
+    /// @param mapped Host address of the block, null if the memory is not host visible.
+    /// @param memoryType Memory type index.
+    /// @param linear True if the block contains the linear resources.
+    VulkanMemoryBlock(vk::DeviceMemory memory, vk::DeviceSize size, void* mapped, uint32_t memoryType, bool linear)
+        : _memory(memory)
+        , _size(size)
+        , _mapped(static_cast<uint8_t*>(mapped))
+        , _memoryType(memoryType)
+        , _linear(linear)
+    {
+        for (auto& freeLists : _freeLists) {
+            freeLists.fill(InvalidChunk);
+        }
+
+        _chunks.push_back({ .offset = 0, .size = size, .free = true });
+        insertFree(0);
+    }
+
+    /// @brief Allocate a range of the block.
+    /// @param size Requested size.
+    /// @param alignment Requested alignment, power of two.
+    /// @param offset Filled with the offset of the range.
+    /// @return Chunk index, invalid if the block has no room.
+    uint32_t allocate(vk::DeviceSize size, vk::DeviceSize alignment, vk::DeviceSize& offset)
+    {
+        size = alignUp(size, MinChunkSize);
+        alignment = std::max(alignment, MinChunkSize);
+
+        // the chunk must fit the padding for the alignment too
+        auto index = findFree(size + alignment - MinChunkSize);
+        if (index == InvalidChunk) {
+            return InvalidChunk;
+        }
+        removeFree(index);
+
+        // the padding before the aligned offset goes back to the free lists
+        auto padding = alignUp(_chunks[index].offset, alignment) - _chunks[index].offset;
+        if (padding > 0) {
+            auto front = createChunk(_chunks[index].offset, padding);
+            linkBefore(front, index);
+            _chunks[index].offset += padding;
+            _chunks[index].size -= padding;
+            insertFree(front);
+        }
+
+        // and the remaining space after the allocation
+        if (_chunks[index].size - size >= MinChunkSize) {
+            auto back = createChunk(_chunks[index].offset + size, _chunks[index].size - size);
+            linkAfter(back, index);
+            _chunks[index].size = size;
+            insertFree(back);
+        }
+
+        _chunks[index].free = false;
+        _usedSize += _chunks[index].size;
+        _allocationsCount++;
+        offset = _chunks[index].offset;
+        return index;
+    }
+
+    /// @brief Free a range of the block, it's merged with the free neighbours.
+    /// @param index Chunk index.
+    /// @return Size released.
+    vk::DeviceSize free(uint32_t index)
+    {
+        assert(index < _chunks.size() && !_chunks[index].free);
+
+        auto size = _chunks[index].size;
+        _usedSize -= size;
+        _allocationsCount--;
+        _chunks[index].free = true;
+
+        if (auto previous = _chunks[index].previousPhysical; previous != InvalidChunk && _chunks[previous].free) {
+            removeFree(previous);
+            _chunks[previous].size += _chunks[index].size;
+            unlink(index);
+            index = previous;
+        }
+        if (auto next = _chunks[index].nextPhysical; next != InvalidChunk && _chunks[next].free) {
+            removeFree(next);
+            _chunks[index].size += _chunks[next].size;
+            unlink(next);
+        }
+
+        insertFree(index);
+        return size;
+    }
+
+    /// @brief Get the device memory.
+    [[nodiscard]] vk::DeviceMemory memory() const { return _memory; }
+
+    /// @brief Get the block size.
+    [[nodiscard]] vk::DeviceSize size() const { return _size; }
+
+    /// @brief Get the size used by the allocations.
+    [[nodiscard]] vk::DeviceSize usedSize() const { return _usedSize; }
+
+    /// @brief Get the allocations count.
+    [[nodiscard]] uint32_t allocationsCount() const { return _allocationsCount; }
+
+    /// @brief Get the host address of a range, null if the memory is not host visible.
+    [[nodiscard]] void* mapped(vk::DeviceSize offset) const { return _mapped ? _mapped + offset : nullptr; }
+
+    /// @brief Get the memory type index.
+    [[nodiscard]] uint32_t memoryType() const { return _memoryType; }
+
+    /// @brief Check if the block contains the linear resources.
+    [[nodiscard]] bool linear() const { return _linear; }
+
+private:
+    /// @brief Range of the block, free or allocated.
+    struct Chunk {
+        vk::DeviceSize offset { 0 }; ///< Offset in the block.
+        vk::DeviceSize size { 0 }; ///< Size.
+        bool free { false }; ///< True if the chunk is in the free lists.
+        uint32_t previousPhysical { InvalidChunk }; ///< Chunk before in the block.
+        uint32_t nextPhysical { InvalidChunk }; ///< Chunk after in the block.
+        uint32_t previousFree { InvalidChunk }; ///< Previous chunk in the same free list.
+        uint32_t nextFree { InvalidChunk }; ///< Next chunk in the same free list.
+    };
+
+    vk::DeviceMemory _memory {}; ///< Device memory.
+    vk::DeviceSize _size { 0 }; ///< Block size.
+    vk::DeviceSize _usedSize { 0 }; ///< Size used by the allocations.
+    uint32_t _allocationsCount { 0 }; ///< Allocations count.
+    uint8_t* _mapped { nullptr }; ///< Host address of the block.
+    uint32_t _memoryType { 0 }; ///< Memory type index.
+    bool _linear { true }; ///< True if the block contains the linear resources.
+
+    std::vector<Chunk> _chunks {}; ///< Chunks, referenced by index.
+    std::vector<uint32_t> _unusedChunks {}; ///< Chunks released by the merges, reused by the splits.
+    uint64_t _firstLevelMap { 0 }; ///< Bit set for every first level with free chunks.
+    std::array<uint32_t, FirstLevelCount> _secondLevelMaps {}; ///< Bit set for every size class with free chunks.
+    std::array<std::array<uint32_t, SecondLevelCount>, FirstLevelCount> _freeLists {}; ///< Heads of the free lists.
+
+    [[nodiscard]] static vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    /// @brief Get the size class of a size.
+    static void mapping(vk::DeviceSize size, uint32_t& firstLevel, uint32_t& secondLevel)
+    {
+        firstLevel = static_cast<uint32_t>(std::bit_width(size)) - 1;
+        secondLevel = static_cast<uint32_t>(size >> (firstLevel - SecondLevelBits)) & (SecondLevelCount - 1);
+    }
+
+    /// @brief Find a free chunk that fits a size, the search starts from the next size class so every chunk found
+    ///        is big enough.
+    [[nodiscard]] uint32_t findFree(vk::DeviceSize size) const
+    {
+        uint32_t firstLevel = 0;
+        uint32_t secondLevel = 0;
+        mapping(size + (vk::DeviceSize { 1 } << (std::bit_width(size) - 1 - SecondLevelBits)) - 1, firstLevel,
+            secondLevel);
+        if (firstLevel >= FirstLevelCount) {
+            return InvalidChunk;
+        }
+
+        auto secondLevelMap = _secondLevelMaps[firstLevel] & (~0u << secondLevel);
+        if (secondLevelMap == 0) {
+            auto firstLevelMap = firstLevel + 1 < FirstLevelCount ? _firstLevelMap & (~0ull << (firstLevel + 1)) : 0;
+            if (firstLevelMap == 0) {
+                return InvalidChunk;
+            }
+            firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+            secondLevelMap = _secondLevelMaps[firstLevel];
+        }
+        secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+        return _freeLists[firstLevel][secondLevel];
+    }
+
+    void insertFree(uint32_t index)
+    {
+        uint32_t firstLevel = 0;
+        uint32_t secondLevel = 0;
+        mapping(_chunks[index].size, firstLevel, secondLevel);
+
+        auto& head = _freeLists[firstLevel][secondLevel];
+        _chunks[index].previousFree = InvalidChunk;
+        _chunks[index].nextFree = head;
+        if (head != InvalidChunk) {
+            _chunks[head].previousFree = index;
+        }
+        head = index;
+
+        _firstLevelMap |= uint64_t { 1 } << firstLevel;
+        _secondLevelMaps[firstLevel] |= 1u << secondLevel;
+    }
+
+    void removeFree(uint32_t index)
+    {
+        uint32_t firstLevel = 0;
+        uint32_t secondLevel = 0;
+        mapping(_chunks[index].size, firstLevel, secondLevel);
+
+        auto& chunk = _chunks[index];
+        if (chunk.previousFree != InvalidChunk) {
+            _chunks[chunk.previousFree].nextFree = chunk.nextFree;
+        } else {
+            _freeLists[firstLevel][secondLevel] = chunk.nextFree;
+        }
+        if (chunk.nextFree != InvalidChunk) {
+            _chunks[chunk.nextFree].previousFree = chunk.previousFree;
+        }
+        chunk.previousFree = InvalidChunk;
+        chunk.nextFree = InvalidChunk;
+
+        if (_freeLists[firstLevel][secondLevel] == InvalidChunk) {
+            _secondLevelMaps[firstLevel] &= ~(1u << secondLevel);
+            if (_secondLevelMaps[firstLevel] == 0) {
+                _firstLevelMap &= ~(uint64_t { 1 } << firstLevel);
+            }
+        }
+    }
+
+    [[nodiscard]] uint32_t createChunk(vk::DeviceSize offset, vk::DeviceSize size)
+    {
+        Chunk chunk = { .offset = offset, .size = size, .free = true };
+        if (!_unusedChunks.empty()) {
+            auto index = _unusedChunks.back();
+            _unusedChunks.pop_back();
+            _chunks[index] = chunk;
+            return index;
+        }
+        _chunks.push_back(chunk);
+        return static_cast<uint32_t>(_chunks.size() - 1);
+    }
+
+    void linkBefore(uint32_t index, uint32_t next)
+    {
+        auto previous = _chunks[next].previousPhysical;
+        _chunks[index].previousPhysical = previous;
+        _chunks[index].nextPhysical = next;
+        _chunks[next].previousPhysical = index;
+        if (previous != InvalidChunk) {
+            _chunks[previous].nextPhysical = index;
+        }
+    }
+
+    void linkAfter(uint32_t index, uint32_t previous)
+    {
+        auto next = _chunks[previous].nextPhysical;
+        _chunks[index].previousPhysical = previous;
+        _chunks[index].nextPhysical = next;
+        _chunks[previous].nextPhysical = index;
+        if (next != InvalidChunk) {
+            _chunks[next].previousPhysical = index;
+        }
+    }
+
+    void unlink(uint32_t index)
+    {
+        auto previous = _chunks[index].previousPhysical;
+        auto next = _chunks[index].nextPhysical;
+        if (previous != InvalidChunk) {
+            _chunks[previous].nextPhysical = next;
+        }
+        if (next != InvalidChunk) {
+            _chunks[next].previousPhysical = previous;
+        }
+        _chunks[index] = {};
+        _unusedChunks.push_back(index);
+    }
+};
+
+struct VulkanMemoryAllocatorContext {
+    /// @brief Blocks for every memory type, the second index is 1 for the linear resources.
+    static inline std::array<std::array<std::vector<std::unique_ptr<VulkanMemoryBlock>>, 2>, VK_MAX_MEMORY_TYPES>
+        blocks = {};
+    static inline std::array<vk::DeviceSize, VK_MAX_MEMORY_TYPES> blockSizes = {}; ///< Block size for the types.
+    static inline vk::PhysicalDeviceMemoryProperties memoryProperties = {};
+    static inline VulkanMemoryStats stats = {};
+    static inline std::mutex mutex = {}; ///< The resources are created by the asynchronous imports.
+};
+
+/// @brief Allocate device memory, mapped if it's host visible.
+/// @param size Memory size.
+/// @param memoryType Memory type index.
+/// @param mapped Filled with the host address.
+/// @return Device memory.
+static vk::DeviceMemory allocateDeviceMemory(vk::DeviceSize size, uint32_t memoryType, void*& mapped)
+{
+    vk::MemoryAllocateInfo allocInfo = {};
+    allocInfo.setAllocationSize(size);
+    allocInfo.setMemoryTypeIndex(memoryType);
+    auto memory = VulkanContext::device.allocateMemory(allocInfo);
+
+    mapped = nullptr;
+    const auto& memoryTypeInfo = VulkanMemoryAllocatorContext::memoryProperties.memoryTypes[memoryType];
+    if (memoryTypeInfo.propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible) {
+        mapped = VulkanContext::device.mapMemory(memory, 0, VK_WHOLE_SIZE);
+    }
+    return memory;
+}
+
+void VulkanMemoryAllocator::init()
+{
+    CHRZONE_RENDERER;
+
+    auto& memoryProperties = VulkanMemoryAllocatorContext::memoryProperties;
+    memoryProperties = VulkanContext::physicalDevice.getMemoryProperties();
+
+    // the small heaps (like the host visible device memory) get smaller blocks
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        auto heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[i].heapIndex].size;
+        auto blockSize = std::min(DefaultBlockSize, heapSize / 8);
+        VulkanMemoryAllocatorContext::blockSizes[i] = std::max(blockSize & ~(MinChunkSize - 1), MinChunkSize);
+    }
+}
+
+void VulkanMemoryAllocator::deinit()
+{
+    CHRZONE_RENDERER;
+
+    std::scoped_lock<std::mutex> lock(VulkanMemoryAllocatorContext::mutex);
+
+    const auto& stats = VulkanMemoryAllocatorContext::stats;
+    CHRLOG_INFO("Device memory: {} blocks ({} KiB), {} allocations ({} KiB), {} dedicated ({} KiB)",
+        stats.blocksCount, stats.blocksSize / 1024, stats.allocationsCount, stats.usedSize / 1024,
+        stats.dedicatedCount, stats.dedicatedSize / 1024);
+    if (stats.allocationsCount > 0 || stats.dedicatedCount > 0) {
+        CHRLOG_WARN("Device memory leak: {} allocations still alive", stats.allocationsCount + stats.dedicatedCount);
+    }
+
+    for (auto& typeBlocks : VulkanMemoryAllocatorContext::blocks) {
+        for (auto& blocks : typeBlocks) {
+            for (const auto& block : blocks) {
+                VulkanContext::device.freeMemory(block->memory());
+            }
+            blocks.clear();
+        }
+    }
+    VulkanMemoryAllocatorContext::stats = {};
+}
+
+VulkanAllocation VulkanMemoryAllocator::allocate(
+    const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, bool linear)
+{
+    CHRZONE_RENDERER;
+
+    assert(requirements.size > 0);
+
+    auto memoryType = VulkanUtils::findMemoryType(requirements.memoryTypeBits, properties);
+    auto blockSize = VulkanMemoryAllocatorContext::blockSizes[memoryType];
+    auto& stats = VulkanMemoryAllocatorContext::stats;
+
+    // the big resources would waste most of a block
+    if (requirements.size > blockSize / 2) {
+        VulkanAllocation allocation = { .size = requirements.size };
+        allocation.memory = allocateDeviceMemory(requirements.size, memoryType, allocation.mapped);
+
+        std::scoped_lock<std::mutex> lock(VulkanMemoryAllocatorContext::mutex);
+        stats.dedicatedCount++;
+        stats.dedicatedSize += requirements.size;
+        return allocation;
+    }
+
+    std::scoped_lock<std::mutex> lock(VulkanMemoryAllocatorContext::mutex);
+
+    auto& blocks = VulkanMemoryAllocatorContext::blocks[memoryType][linear ? 1 : 0];
+    auto allocateFromBlock = [&requirements, &stats](VulkanMemoryBlock& block) -> VulkanAllocation {
+        vk::DeviceSize offset = 0;
+        auto usedSize = block.usedSize();
+        auto chunk = block.allocate(requirements.size, requirements.alignment, offset);
+        if (chunk == InvalidChunk) {
+            return {};
+        }
+
+        stats.allocationsCount++;
+        stats.usedSize += block.usedSize() - usedSize;
+        return { .memory = block.memory(),
+            .offset = offset,
+            .size = requirements.size,
+            .mapped = block.mapped(offset),
+            .block = &block,
+            .chunk = chunk };
+    };
+
+    for (const auto& block : blocks) {
+        if (auto allocation = allocateFromBlock(*block)) {
+            return allocation;
+        }
+    }
+
+    // no room in the existing blocks
+    void* mapped = nullptr;
+    auto memory = allocateDeviceMemory(blockSize, memoryType, mapped);
+    blocks.push_back(std::make_unique<VulkanMemoryBlock>(memory, blockSize, mapped, memoryType, linear));
+    stats.blocksCount++;
+    stats.blocksSize += blockSize;
+
+    CHRLOG_DEBUG("Device memory block allocated: type={}, size={} KiB, linear={}", memoryType, blockSize / 1024,
+        linear);
+
+    auto allocation = allocateFromBlock(*blocks.back());
+    assert(allocation);
+    return allocation;
+}
+
+void VulkanMemoryAllocator::free(const VulkanAllocation& allocation)
+{
+    CHRZONE_RENDERER;
+
+    if (!allocation) {
+        return;
+    }
+
+    auto& stats = VulkanMemoryAllocatorContext::stats;
+
+    // the dedicated memory is unmapped by the driver
+    if (allocation.block == nullptr) {
+        VulkanContext::device.freeMemory(allocation.memory);
+
+        std::scoped_lock<std::mutex> lock(VulkanMemoryAllocatorContext::mutex);
+        stats.dedicatedCount--;
+        stats.dedicatedSize -= allocation.size;
+        return;
+    }
+
+    std::scoped_lock<std::mutex> lock(VulkanMemoryAllocatorContext::mutex);
+
+    auto* block = allocation.block;
+    stats.allocationsCount--;
+    stats.usedSize -= block->free(allocation.chunk);
+
+    // keep one empty block for every type, so a resource recreated every frame doesn't allocate device memory
+    auto& blocks = VulkanMemoryAllocatorContext::blocks[block->memoryType()][block->linear() ? 1 : 0];
+    if (block->allocationsCount() == 0
+        && std::ranges::count_if(blocks, [](const auto& item) { return item->allocationsCount() == 0; }) > 1) {
+        stats.blocksCount--;
+        stats.blocksSize -= block->size();
+        VulkanContext::device.freeMemory(block->memory());
+        std::erase_if(blocks, [block](const auto& item) { return item.get() == block; });
+    }
+}
+
+VulkanMemoryStats VulkanMemoryAllocator::stats()
+{
+    std::scoped_lock<std::mutex> lock(VulkanMemoryAllocatorContext::mutex);
+    return VulkanMemoryAllocatorContext::stats;
+}
+
+} // namespace chronicle::internal::vulkan
@@ -0,0 +1,68 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "VulkanCommon.h"
+
+namespace chronicle::internal::vulkan {
+
+class VulkanMemoryBlock;
+
+/// @brief Range of device memory assigned to a buffer or an image.
+struct VulkanAllocation {
+    vk::DeviceMemory memory {}; ///< Device memory, shared with the other allocations of the block.
+    vk::DeviceSize offset { 0 }; ///< Offset in the device memory.
+    vk::DeviceSize size { 0 }; ///< Allocation size.
+    void* mapped { nullptr }; ///< Host address of the allocation, only for the host visible memory.
+    VulkanMemoryBlock* block { nullptr }; ///< Block that owns the range, null for the dedicated allocations.
+    uint32_t chunk { 0 }; ///< Chunk of the block.
+
+    /// @brief Check if the allocation is valid.
+    [[nodiscard]] explicit operator bool() const { return static_cast<bool>(memory); }
+};
+
+/// @brief Statistics of the device memory allocator.
+struct VulkanMemoryStats {
+    uint32_t blocksCount { 0 }; ///< Device memory blocks shared by the allocations.
+    uint32_t allocationsCount { 0 }; ///< Allocations in the blocks.
+    uint32_t dedicatedCount { 0 }; ///< Allocations with their own device memory.
+    vk::DeviceSize blocksSize { 0 }; ///< Device memory allocated for the blocks.
+    vk::DeviceSize usedSize { 0 }; ///< Device memory used by the allocations in the blocks.
+    vk::DeviceSize dedicatedSize { 0 }; ///< Device memory used by the dedicated allocations.
+};
+
+/// @brief Sub-allocator for the device memory.
+///        The allocations are placed in large blocks, one list of blocks for every memory type, and every block
+///        is managed with a two-level segregated fit (TLSF) allocator, so both allocation and free run in constant
+///        time. The linear resources (buffers) and the optimal images are kept in different blocks, so the
+///        bufferImageGranularity never applies between neighbours. The allocations bigger than half block get their
+///        own device memory. The host visible blocks are persistently mapped.
+class VulkanMemoryAllocator {
+public:
+    /// @brief Initialize the allocator, after the logical device creation.
+    static void init();
+
+    /// @brief Free all the blocks, before the logical device destruction.
+    static void deinit();
+
+    /// @brief Allocate device memory.
+    /// @param requirements Memory requirements of the resource.
+    /// @param properties Memory properties.
+    /// @param linear True for the buffers and the linear images, false for the optimal images.
+    /// @return The allocation.
+    [[nodiscard]] static VulkanAllocation allocate(
+        const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties, bool linear);
+
+    /// @brief Free an allocation, the GPU must not use it anymore.
+    /// @param allocation Allocation to free.
+    static void free(const VulkanAllocation& allocation);
+
+    /// @brief Get the allocator statistics.
+    /// @return Statistics.
+    [[nodiscard]] static VulkanMemoryStats stats();
+};
+
+} // namespace chronicle::internal::vulkan
@@ -16,11 +16,13 @@ namespace chronicle::internal::vulkan {
 
 CHR_CONCRETE(VulkanPipeline);
 
-VulkanPipeline::VulkanPipeline(const PipelineInfo& pipelineInfo, const std::string& name)
+VulkanPipeline::VulkanPipeline(const PipelineInfo& pipelineInfo, const std::string& name, bool deferred)
     : _name(name)
     , _shader(pipelineInfo.shader)
     , _renderPass(pipelineInfo.renderPass)
     , _vertexBuffers(pipelineInfo.vertexBuffers)
+    , _pushConstants(pipelineInfo.pushConstants)
+    , _specializationConstants(pipelineInfo.specializationConstants)
 {
     CHRZONE_RENDERER;
 
@@ -30,8 +32,10 @@ VulkanPipeline::VulkanPipeline(const PipelineInfo& pipelineInfo, const std::stri
     // descriptor sets layout
     _descriptorSetsLayout = getVulkanDescriptorSetsLayout(pipelineInfo.descriptorSetsLayout);
 
-    // create the pipeline
-    create();
+    // create the pipeline, unless it's created later with the others of a batch
+    if (!deferred) {
+        create();
+    }
 
     // register the debug show lines event
     VulkanContext::dispatcher.sink<DebugShowLinesEvent>().connect<&VulkanPipeline::debugShowLines>(this);
@@ -54,25 +58,147 @@ VulkanPipeline::~VulkanPipeline()
 PipelineRef VulkanPipeline::create(const PipelineInfo& pipelineInfo, const std::string& name)
 {
     // create an instance of the class
-    return std::make_shared<ConcreteVulkanPipeline>(pipelineInfo, name);
+    return std::make_shared<ConcreteVulkanPipeline>(pipelineInfo, name, false);
+}
+
+PipelineRef VulkanPipeline::createDeferred(const PipelineInfo& pipelineInfo, const std::string& name)
+{
+    // create an instance of the class, the vulkan pipeline is created by build
+    return std::make_shared<ConcreteVulkanPipeline>(pipelineInfo, name, true);
+}
+
+void VulkanPipeline::build(std::span<const PipelineRef> pipelines)
+{
+    CHRZONE_RENDERER;
+
+    std::vector<VulkanPipeline*> vulkanPipelines = {};
+    vulkanPipelines.reserve(pipelines.size());
+    for (const auto& pipeline : pipelines) {
+        auto vulkanPipeline = static_cast<VulkanPipeline*>(pipeline.get());
+        assert(!vulkanPipeline->ready());
+        vulkanPipelines.push_back(vulkanPipeline);
+    }
+
+    createPipelines(vulkanPipelines);
 }
 
 void VulkanPipeline::create()
 {
     CHRZONE_RENDERER;
 
+    std::array<VulkanPipeline*, 1> pipelines = { this };
+    createPipelines(pipelines);
+
+    if (_failed.load(std::memory_order_acquire)) {
+        throw RendererError("Failed to create graphics pipeline");
+    }
+}
+
+void VulkanPipeline::createPipelines(std::span<VulkanPipeline* const> pipelines)
+{
+    CHRZONE_RENDERER;
+
+    if (pipelines.empty()) {
+        return;
+    }
+
+    // the states are referenced by the create infos, they can't be moved after prepare
+    std::vector<VulkanPipelineCreateState> states(pipelines.size());
+    std::vector<size_t> preparedIndices = {};
+    std::vector<vk::GraphicsPipelineCreateInfo> createInfos = {};
+    preparedIndices.reserve(pipelines.size());
+    createInfos.reserve(pipelines.size());
+    for (size_t i = 0; i < pipelines.size(); i++) {
+        auto pipeline = pipelines[i];
+        pipeline->_failed.store(false, std::memory_order_release);
+
+        // a pipeline that can't be prepared doesn't stop the others
+        try {
+            pipeline->prepare(states[i]);
+        } catch (const std::exception& error) {
+            CHRLOG_ERROR("Failed to prepare pipeline {}: {}", pipeline->_name, error.what());
+            pipeline->_failed.store(true, std::memory_order_release);
+            continue;
+        }
+        preparedIndices.push_back(i);
+        createInfos.push_back(states[i].graphicsPipelineInfo);
+    }
+
+    if (preparedIndices.empty()) {
+        return;
+    }
+
+    // create all the graphics pipelines with a single call, the failed ones are left null
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::vector<vk::Pipeline> graphicsPipelines(createInfos.size());
+    auto result = VulkanContext::device.createGraphicsPipelines(VulkanContext::pipelineCache,
+        static_cast<uint32_t>(createInfos.size()), createInfos.data(), nullptr, graphicsPipelines.data());
+    if (result != vk::Result::eSuccess) {
+        CHRLOG_ERROR("Failed to create graphics pipelines: {}", vk::to_string(result));
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    uint32_t createdCount = 0;
+    uint32_t cacheHits = 0;
+    for (size_t i = 0; i < preparedIndices.size(); i++) {
+        auto pipeline = pipelines[preparedIndices[i]];
+        if (!graphicsPipelines[i]) {
+            pipeline->_failed.store(true, std::memory_order_release);
+            continue;
+        }
+
+        pipeline->_graphicsPipeline = graphicsPipelines[i];
+        if (states[preparedIndices[i]].creationFeedback.flags
+            & vk::PipelineCreationFeedbackFlagBitsEXT::eApplicationPipelineCacheHit) {
+            cacheHits++;
+        }
+        createdCount++;
+
+#ifdef VULKAN_ENABLE_DEBUG_MARKER
+        VulkanUtils::setDebugObjectName(pipeline->_graphicsPipeline, pipeline->_name);
+#endif // VULKAN_ENABLE_DEBUG_MARKER
+
+        pipeline->_ready.store(true, std::memory_order_release);
+    }
+
+    std::scoped_lock<std::mutex> lock(VulkanContext::pipelineCacheStatsMutex);
+    auto& stats = VulkanContext::pipelineCacheStats;
+    stats.pipelinesCount += createdCount;
+    stats.cacheHits += cacheHits;
+    stats.creationTime += std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+}
+
+void VulkanPipeline::prepare(VulkanPipelineCreateState& state)
+{
+    CHRZONE_RENDERER;
+
     const auto vulkanShader = static_cast<VulkanShader*>(_shader.get());
 
+    // specialization constants, the stages ignore the IDs they don't declare
+    state.specializationEntries.reserve(_specializationConstants.size());
+    state.specializationData.reserve(_specializationConstants.size());
+    for (const auto& specializationConstant : _specializationConstants) {
+        state.specializationEntries.emplace_back(specializationConstant.id,
+            static_cast<uint32_t>(state.specializationData.size() * sizeof(uint32_t)), sizeof(uint32_t));
+        state.specializationData.push_back(specializationConstant.value);
+    }
+    state.specializationInfo.setMapEntries(state.specializationEntries);
+    state.specializationInfo.setData<uint32_t>(state.specializationData);
+
     // prepare the shaders
     const auto& stages = _shader->stages();
-    std::vector<vk::PipelineShaderStageCreateInfo> shaderStages = {};
-    shaderStages.reserve(stages.size());
+    state.shaderStages.reserve(stages.size());
     for (auto const& shaderStage : stages) {
         vk::PipelineShaderStageCreateInfo shaderStageCreateInfo = {};
         shaderStageCreateInfo.setStage(VulkanEnums::shaderStageToVulkan(shaderStage));
         shaderStageCreateInfo.setModule(vulkanShader->shaderModule(shaderStage));
         shaderStageCreateInfo.setPName(vulkanShader->entryPoint(shaderStage).c_str());
-        shaderStages.push_back(shaderStageCreateInfo);
+        if (!_specializationConstants.empty()) {
+            shaderStageCreateInfo.setPSpecializationInfo(&state.specializationInfo);
+        }
+        state.shaderStages.push_back(shaderStageCreateInfo);
     }
 
     // create binding and attribute descriptions for vertex input state
@@ -81,20 +207,18 @@ void VulkanPipeline::create()
         attributeDescriptionsCount += vertexBufferInfo.attributeDescriptions.size();
 
     // reserve memory for the binding descripion vector
-    std::vector<vk::VertexInputBindingDescription> bindingDescriptions = {};
-    bindingDescriptions.reserve(_vertexBuffers.size());
+    state.bindingDescriptions.reserve(_vertexBuffers.size());
 
     // reserve memory for the input attribute descripion vector
-    std::vector<vk::VertexInputAttributeDescription> attributeDescriptions = {};
-    attributeDescriptions.reserve(attributeDescriptionsCount);
+    state.attributeDescriptions.reserve(attributeDescriptionsCount);
 
     // fill the binding and attribute descriptions
     for (auto i = 0; i < _vertexBuffers.size(); i++) {
         vk::VertexInputBindingDescription bindingDescription = {};
         bindingDescription.binding = i;
         bindingDescription.stride = _vertexBuffers[i].stride;
-        bindingDescription.inputRate = vk::VertexInputRate::eVertex;
-        bindingDescriptions.push_back(bindingDescription);
+        bindingDescription.inputRate = VulkanEnums::vertexInputRateToVulkan(_vertexBuffers[i].inputRate);
+        state.bindingDescriptions.push_back(bindingDescription);
 
         // fill the attribute descriptions
         for (const auto& sourceAttributeDescription : _vertexBuffers[i].attributeDescriptions) {
@@ -103,95 +227,93 @@ void VulkanPipeline::create()
             attributeDescription.location = sourceAttributeDescription.location;
             attributeDescription.format = VulkanEnums::formatToVulkan(sourceAttributeDescription.format);
             attributeDescription.offset = sourceAttributeDescription.offset;
-            attributeDescriptions.push_back(attributeDescription);
+            state.attributeDescriptions.push_back(attributeDescription);
         }
     }
 
     // vertex input state
-    vk::PipelineVertexInputStateCreateInfo vertexInputInfo = {};
-    vertexInputInfo.setVertexBindingDescriptions(bindingDescriptions);
-    vertexInputInfo.setVertexAttributeDescriptions(attributeDescriptions);
+    state.vertexInputInfo.setVertexBindingDescriptions(state.bindingDescriptions);
+    state.vertexInputInfo.setVertexAttributeDescriptions(state.attributeDescriptions);
 
     // input assembly state
-    vk::PipelineInputAssemblyStateCreateInfo inputAssembly = {};
-    inputAssembly.setTopology(vk::PrimitiveTopology::eTriangleList);
-    inputAssembly.setPrimitiveRestartEnable(false);
+    state.inputAssembly.setTopology(vk::PrimitiveTopology::eTriangleList);
+    state.inputAssembly.setPrimitiveRestartEnable(false);
 
     // view port state
-    vk::PipelineViewportStateCreateInfo viewportState = {};
-    viewportState.setViewportCount(1);
-    viewportState.setScissorCount(1);
+    state.viewportState.setViewportCount(1);
+    state.viewportState.setScissorCount(1);
 
     // rasterizer state
-    vk::PipelineRasterizationStateCreateInfo rasterizer = {};
-    rasterizer.setDepthClampEnable(false);
-    rasterizer.setRasterizerDiscardEnable(false);
-    rasterizer.setPolygonMode(VulkanContext::debugShowLines ? vk::PolygonMode::eLine : vk::PolygonMode::eFill);
-    rasterizer.setLineWidth(1.0f);
-    rasterizer.setCullMode(vk::CullModeFlagBits::eBack);
-    rasterizer.setFrontFace(vk::FrontFace::eCounterClockwise);
-    rasterizer.setDepthBiasEnable(false);
+    state.rasterizer.setDepthClampEnable(false);
+    state.rasterizer.setRasterizerDiscardEnable(false);
+    state.rasterizer.setPolygonMode(VulkanContext::debugShowLines ? vk::PolygonMode::eLine : vk::PolygonMode::eFill);
+    state.rasterizer.setLineWidth(1.0f);
+    state.rasterizer.setCullMode(vk::CullModeFlagBits::eBack);
+    state.rasterizer.setFrontFace(vk::FrontFace::eCounterClockwise);
+    state.rasterizer.setDepthBiasEnable(false);
 
     // multisample state
-    vk::PipelineMultisampleStateCreateInfo multisampling = {};
-    multisampling.setSampleShadingEnable(false);
-    multisampling.setRasterizationSamples(VulkanEnums::msaaToVulkan(_renderPass->msaa()));
+    state.multisampling.setSampleShadingEnable(false);
+    state.multisampling.setRasterizationSamples(VulkanEnums::msaaToVulkan(_renderPass->msaa()));
 
     // depth stencil
-    vk::PipelineDepthStencilStateCreateInfo depthStencil = {};
-    depthStencil.setDepthTestEnable(true);
-    depthStencil.setDepthWriteEnable(true);
-    depthStencil.setDepthCompareOp(vk::CompareOp::eLess);
-    depthStencil.setDepthBoundsTestEnable(false);
-    depthStencil.setStencilTestEnable(false);
+    state.depthStencil.setDepthTestEnable(true);
+    state.depthStencil.setDepthWriteEnable(true);
+    state.depthStencil.setDepthCompareOp(vk::CompareOp::eLess);
+    state.depthStencil.setDepthBoundsTestEnable(false);
+    state.depthStencil.setStencilTestEnable(false);
 
     // color blend attachment state
-    vk::PipelineColorBlendAttachmentState colorBlendAttachment = {};
-    colorBlendAttachment.setColorWriteMask(vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG
+    state.colorBlendAttachment.setColorWriteMask(vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG
         | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
-    colorBlendAttachment.setBlendEnable(false);
+    state.colorBlendAttachment.setBlendEnable(false);
 
     // color blend state
-    vk::PipelineColorBlendStateCreateInfo colorBlending = {};
-    colorBlending.setLogicOpEnable(false);
-    colorBlending.setLogicOp(vk::LogicOp::eCopy);
-    colorBlending.setAttachments(colorBlendAttachment);
-    colorBlending.setBlendConstants({ 0.0f, 0.0f, 0.0f, 0.0f });
+    state.colorBlending.setLogicOpEnable(false);
+    state.colorBlending.setLogicOp(vk::LogicOp::eCopy);
+    state.colorBlending.setAttachments(state.colorBlendAttachment);
+    state.colorBlending.setBlendConstants({ 0.0f, 0.0f, 0.0f, 0.0f });
 
     // dynamic state
-    std::array<vk::DynamicState, 2> dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
-    vk::PipelineDynamicStateCreateInfo dynamicState = {};
-    dynamicState.setDynamicStates(dynamicStates);
+    state.dynamicStates = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+    state.dynamicState.setDynamicStates(state.dynamicStates);
+
+    // push constant ranges
+    std::vector<vk::PushConstantRange> pushConstantRanges = {};
+    pushConstantRanges.reserve(_pushConstants.size());
+    for (const auto& pushConstant : _pushConstants) {
+        pushConstantRanges.emplace_back(
+            VulkanEnums::shaderStageFlagsToVulkan(pushConstant.stages), pushConstant.offset, pushConstant.size);
+    }
 
     // create the pipeline layout
     vk::PipelineLayoutCreateInfo pipelineLayoutInfo = {};
     pipelineLayoutInfo.setSetLayouts(_descriptorSetsLayout);
+    pipelineLayoutInfo.setPushConstantRanges(pushConstantRanges);
     _pipelineLayout = VulkanContext::device.createPipelineLayout(pipelineLayoutInfo);
 
     // graphics pipeline
-    vk::GraphicsPipelineCreateInfo graphicsPipelineInfo = {};
-    graphicsPipelineInfo.setStages(shaderStages);
-    graphicsPipelineInfo.setPVertexInputState(&vertexInputInfo);
-    graphicsPipelineInfo.setPInputAssemblyState(&inputAssembly);
-    graphicsPipelineInfo.setPViewportState(&viewportState);
-    graphicsPipelineInfo.setPRasterizationState(&rasterizer);
-    graphicsPipelineInfo.setPMultisampleState(&multisampling);
-    graphicsPipelineInfo.setPDepthStencilState(&depthStencil);
-    graphicsPipelineInfo.setPColorBlendState(&colorBlending);
-    graphicsPipelineInfo.setPDynamicState(&dynamicState);
+    auto& graphicsPipelineInfo = state.graphicsPipelineInfo;
+    graphicsPipelineInfo.setStages(state.shaderStages);
+    graphicsPipelineInfo.setPVertexInputState(&state.vertexInputInfo);
+    graphicsPipelineInfo.setPInputAssemblyState(&state.inputAssembly);
+    graphicsPipelineInfo.setPViewportState(&state.viewportState);
+    graphicsPipelineInfo.setPRasterizationState(&state.rasterizer);
+    graphicsPipelineInfo.setPMultisampleState(&state.multisampling);
+    graphicsPipelineInfo.setPDepthStencilState(&state.depthStencil);
+    graphicsPipelineInfo.setPColorBlendState(&state.colorBlending);
+    graphicsPipelineInfo.setPDynamicState(&state.dynamicState);
     graphicsPipelineInfo.setLayout(_pipelineLayout);
     graphicsPipelineInfo.setRenderPass(_renderPass->renderPassId());
     graphicsPipelineInfo.setSubpass(0);
 
-    // create the graphics pipeline
-    vk::Result result;
-    std::tie(result, _graphicsPipeline) = VulkanContext::device.createGraphicsPipeline(nullptr, graphicsPipelineInfo);
-    if (result != vk::Result::eSuccess)
-        throw RendererError("Failed to create graphics pipeline");
-
-#ifdef VULKAN_ENABLE_DEBUG_MARKER
-    VulkanUtils::setDebugObjectName(_graphicsPipeline, _name);
-#endif // VULKAN_ENABLE_DEBUG_MARKER
+    // creation feedback, used to count the cache hits
+    if (VulkanContext::pipelineCreationFeedback) {
+        state.stagesCreationFeedback.resize(state.shaderStages.size());
+        state.creationFeedbackInfo.setPPipelineCreationFeedback(&state.creationFeedback);
+        state.creationFeedbackInfo.setPipelineStageCreationFeedbacks(state.stagesCreationFeedback);
+        graphicsPipelineInfo.setPNext(&state.creationFeedbackInfo);
+    }
 }
 
 void VulkanPipeline::cleanup()
@@ -208,6 +330,11 @@ void VulkanPipeline::cleanup()
 
 void VulkanPipeline::debugShowLines([[maybe_unused]] const DebugShowLinesEvent& evn)
 {
+    // the pipelines of a batch still in progress are created with the new mode by the batch
+    if (!ready()) {
+        return;
+    }
+
     // after a debug show line event, cleanup and recreate the pipeline
     cleanup();
     create();
@@ -17,13 +17,39 @@ struct DescriptorSetLayoutData {
     std::vector<vk::DescriptorSetLayoutBinding> bindings = {}; ///< Descriptor set layout bindings
 };
 
+/// @brief Create infos of a graphics pipeline, with all the states they point to.
+///        The create infos reference the other members, so it can't be moved after it's filled.
+struct VulkanPipelineCreateState {
+    std::vector<vk::PipelineShaderStageCreateInfo> shaderStages {}; ///< Shader stages.
+    std::vector<vk::SpecializationMapEntry> specializationEntries {}; ///< Specialization constants entries.
+    std::vector<uint32_t> specializationData {}; ///< Specialization constants values.
+    vk::SpecializationInfo specializationInfo {}; ///< Specialization info shared by the stages.
+    std::vector<vk::VertexInputBindingDescription> bindingDescriptions {}; ///< Vertex bindings.
+    std::vector<vk::VertexInputAttributeDescription> attributeDescriptions {}; ///< Vertex attributes.
+    vk::PipelineVertexInputStateCreateInfo vertexInputInfo {}; ///< Vertex input state.
+    vk::PipelineInputAssemblyStateCreateInfo inputAssembly {}; ///< Input assembly state.
+    vk::PipelineViewportStateCreateInfo viewportState {}; ///< Viewport state.
+    vk::PipelineRasterizationStateCreateInfo rasterizer {}; ///< Rasterizer state.
+    vk::PipelineMultisampleStateCreateInfo multisampling {}; ///< Multisample state.
+    vk::PipelineDepthStencilStateCreateInfo depthStencil {}; ///< Depth stencil state.
+    vk::PipelineColorBlendAttachmentState colorBlendAttachment {}; ///< Color blend attachment state.
+    vk::PipelineColorBlendStateCreateInfo colorBlending {}; ///< Color blend state.
+    std::array<vk::DynamicState, 2> dynamicStates {}; ///< Dynamic states.
+    vk::PipelineDynamicStateCreateInfo dynamicState {}; ///< Dynamic state.
+    vk::PipelineCreationFeedbackEXT creationFeedback {}; ///< Pipeline creation feedback.
+    std::vector<vk::PipelineCreationFeedbackEXT> stagesCreationFeedback {}; ///< Stages creation feedback.
+    vk::PipelineCreationFeedbackCreateInfoEXT creationFeedbackInfo {}; ///< Creation feedback info.
+    vk::GraphicsPipelineCreateInfo graphicsPipelineInfo {}; ///< Graphics pipeline create info.
+};
+
 /// @brief Vulkan implementation for @ref BasePipeline
 class VulkanPipeline : public BasePipeline<VulkanPipeline>, private NonCopyable<VulkanPipeline> {
 protected:
     /// @brief Default constructor.
     /// @param pipelineInfo Informations used to create a new pipeline.
     /// @param name Pipeline name.
-    explicit VulkanPipeline(const PipelineInfo& pipelineInfo, const std::string& name);
+    /// @param deferred If true the vulkan pipeline is created later by @ref VulkanPipeline#build.
+    explicit VulkanPipeline(const PipelineInfo& pipelineInfo, const std::string& name, bool deferred);
 
 public:
     /// @brief Destructor.
@@ -35,9 +61,21 @@ public:
     /// @brief @see BasePipeline#pipelineLayoutId
     [[nodiscard]] PipelineLayoutId pipelineLayoutId() const { return _pipelineLayout; }
 
+    /// @brief @see BasePipeline#ready
+    [[nodiscard]] bool ready() const { return _ready.load(std::memory_order_acquire); }
+
+    /// @brief @see BasePipeline#failed
+    [[nodiscard]] bool failed() const { return _failed.load(std::memory_order_acquire); }
+
     /// @brief @see BasePipeline#create
     [[nodiscard]] static PipelineRef create(const PipelineInfo& pipelineInfo, const std::string& name);
 
+    /// @brief @see BasePipeline#createDeferred
+    [[nodiscard]] static PipelineRef createDeferred(const PipelineInfo& pipelineInfo, const std::string& name);
+
+    /// @brief @see BasePipeline#build
+    static void build(std::span<const PipelineRef> pipelines);
+
 private:
     std::string _name {}; ///< Name.
     ShaderRef _shader {}; ///< Shader.
@@ -46,15 +84,27 @@ private:
     std::vector<vk::DescriptorSetLayout> _descriptorSetsLayout {}; ///< Descriptor sets layout.
     vk::PipelineLayout _pipelineLayout {}; ///< Pipeline layout.
     vk::Pipeline _graphicsPipeline {}; ///< Graphics pipeline.
+    std::atomic<bool> _ready { false }; ///< Set when the graphics pipeline is created.
+    std::atomic<bool> _failed { false }; ///< Set when the graphics pipeline can't be created.
 
     vk::DescriptorPool _descriptorPool {}; ///< Descriptor pool.
     std::vector<vk::DescriptorSet> _descriptorSets {}; ///< Descriptor sets.
 
     std::vector<VertexBufferInfo> _vertexBuffers {}; ///< Vertex buffers.
+    std::vector<PushConstantRange> _pushConstants {}; ///< Push constant ranges.
+    std::vector<SpecializationConstant> _specializationConstants {}; ///< Specialization constants.
 
     /// @brief Create the pipeline.
     void create();
 
+    /// @brief Create the vulkan pipelines with a single call, the ones that can't be created are marked as failed.
+    /// @param pipelines Pipelines to create.
+    static void createPipelines(std::span<VulkanPipeline* const> pipelines);
+
+    /// @brief Create the pipeline layout and fill the create infos.
+    /// @param state Filled with the create infos.
+    void prepare(VulkanPipelineCreateState& state);
+
     /// @brief Cleanup the pipeline.
     void cleanup();
 
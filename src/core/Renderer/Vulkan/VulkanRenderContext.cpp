@@ -10,6 +10,8 @@
 #include "VulkanImGui.h"
 #include "VulkanInstance.h"
 #include "VulkanRenderPass.h"
+#include "VulkanUniformRing.h"
+#include "VulkanUploadManager.h"
 #include "VulkanUtils.h"
 
 namespace chronicle::internal::vulkan {
@@ -66,6 +68,9 @@ bool VulkanRenderContext::beginFrame()
     // clean the frame garbage collector
     VulkanGC::cleanupCurrentQueue();
 
+    // the uniforms of the frame are written again
+    VulkanUniformRing::beginFrame();
+
     // acquire the image
     try {
         auto result = VulkanContext::device.acquireNextImageKHR(
@@ -101,6 +106,9 @@ void VulkanRenderContext::endFrame()
 
     commandBuffer()->end();
 
+    // submit the uploads of the resources used by the frame
+    VulkanUploadManager::flush();
+
     // submit command buffers
     vk::SubmitInfo submitInfo = {};
     std::array<vk::PipelineStageFlags, 1> waitStages = { vk::PipelineStageFlagBits::eColorAttachmentOutput };
@@ -184,6 +192,21 @@ void VulkanRenderContext::setDebugShowLines(bool enabled)
     }
 }
 
+bool VulkanRenderContext::supportsSampledFormat(Format format)
+{
+    CHRZONE_RENDERER;
+
+    if (!VulkanContext::physicalDevice) {
+        return false;
+    }
+
+    // the block compressed formats are reported only if their feature is available
+    constexpr auto requiredFeatures
+        = vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+    auto properties = VulkanContext::physicalDevice.getFormatProperties(VulkanEnums::formatToVulkan(format));
+    return (properties.optimalTilingFeatures & requiredFeatures) == requiredFeatures;
+}
+
 DescriptorSetLayout VulkanRenderContext::descriptorSetLayout()
 {
     DescriptorSetLayout descriptorSetLayout = {};
@@ -197,7 +220,7 @@ DescriptorSetLayout VulkanRenderContext::descriptorSetLayout()
             {
                 .binding = 0,
                 .descriptorSet = 0,
-                .descriptorType = DescriptorType::uniformBuffer,
+                .descriptorType = DescriptorType::uniformBufferDynamic,
                 .name = "UniformBufferObject",
                 .stages = ShaderStage::vertex,
             } } } };
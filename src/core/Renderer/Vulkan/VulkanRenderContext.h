@@ -90,6 +90,18 @@ public:
         return VulkanEnums::formatFromVulkan(VulkanUtils::findDepthFormat());
     }
 
+    /// @brief @see BaseRenderContext#supportsIndexTypeUint8
+    [[nodiscard]] static bool supportsIndexTypeUint8() { return VulkanContext::indexTypeUint8; }
+
+    /// @brief @see BaseRenderContext#supportsSampledFormat
+    [[nodiscard]] static bool supportsSampledFormat(Format format);
+
+    /// @brief @see BaseRenderContext#cacheDirectory
+    [[nodiscard]] static const std::filesystem::path& cacheDirectory() { return VulkanContext::cacheDirectory; }
+
+    /// @brief @see BaseRenderContext#setCacheDirectory
+    static void setCacheDirectory(const std::filesystem::path& directory) { VulkanContext::cacheDirectory = directory; }
+
     /// @brief @see BaseRenderContext#descriptorSetLayout
     [[nodiscard]] static DescriptorSetLayout descriptorSetLayout();
 };
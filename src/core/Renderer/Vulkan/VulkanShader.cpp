@@ -4,6 +4,7 @@
 #include "VulkanShader.h"
 
 #include "VulkanCommon.h"
+#include "VulkanShaderArchive.h"
 #include "VulkanShaderCompiler.h"
 
 #include "Storage/StorageContext.h"
@@ -28,6 +29,8 @@ ShaderRef VulkanShader::create(const ShaderInfo& shaderInfo)
     return std::make_shared<ConcreteVulkanShader>(shaderInfo);
 }
 
+bool VulkanShader::loadArchive(const std::filesystem::path& filename) { return VulkanShaderArchive::open(filename); }
+
 void vulkan::VulkanShader::reload()
 {
     CHRLOG_DEBUG("Shader load: {} ({})", _shaderInfo.filename, join(_shaderInfo.macroDefinitions));
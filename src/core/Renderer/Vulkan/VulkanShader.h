@@ -48,6 +48,9 @@ public:
     /// @return The shader.
     [[nodiscard]] static ShaderRef create(const ShaderInfo& shaderInfo);
 
+    /// @brief @see BaseShader#loadArchive
+    static bool loadArchive(const std::filesystem::path& filename);
+
 private:
     std::unordered_map<ShaderStage, vk::ShaderModule> _shaderModules {}; ///< Shader modules mapped for stages.
     std::unordered_map<ShaderStage, std::string> _entryPoints {}; ///< Shader entry points.
@@ -0,0 +1,158 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "VulkanShaderArchive.h"
+
+#include "VulkanShaderCache.h"
+
+#include "Storage/MappedFile.h"
+
+namespace chronicle::internal::vulkan {
+
+constexpr uint32_t ShaderArchiveMagic = 0x56524843; ///< "CHRV"
+constexpr uint32_t ShaderArchiveVersion = 1;
+
+/// @brief Header of the archive, followed by the index sorted by key and by the modules.
+struct ShaderArchiveHeader {
+    uint32_t magic { ShaderArchiveMagic }; ///< Magic number.
+    uint32_t version { ShaderArchiveVersion }; ///< Archive version.
+    uint64_t count { 0 }; ///< Modules count.
+};
+
+/// @brief Position of a module in the archive.
+struct ShaderArchiveIndexEntry {
+    uint64_t key { 0 }; ///< Module key.
+    uint64_t offset { 0 }; ///< Module offset from the start of the file.
+    uint64_t size { 0 }; ///< Module size.
+};
+
+struct VulkanShaderArchiveContext {
+    static inline MappedFileRef file = {};
+    static inline std::vector<ShaderArchiveIndexEntry> index = {};
+    static inline std::mutex mutex = {};
+};
+
+bool VulkanShaderArchive::open(const std::filesystem::path& filename)
+{
+    CHRZONE_RENDERER;
+
+    close();
+
+    MappedFileRef file = {};
+    try {
+        file = MappedFile::open(filename);
+    } catch (const StorageError& error) {
+        CHRLOG_WARN("Can't open shader archive {}: {}", filename.string(), error.what());
+        return false;
+    }
+
+    auto data = file->span();
+    ShaderArchiveHeader header = {};
+    if (data.size() < sizeof(ShaderArchiveHeader)) {
+        CHRLOG_WARN("Invalid shader archive {}", filename.string());
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(ShaderArchiveHeader));
+    if (header.magic != ShaderArchiveMagic || header.version != ShaderArchiveVersion
+        || header.count > (data.size() - sizeof(ShaderArchiveHeader)) / sizeof(ShaderArchiveIndexEntry)) {
+        CHRLOG_WARN("Invalid shader archive {}", filename.string());
+        return false;
+    }
+
+    // the index is copied, the mapped data could be unaligned
+    std::vector<ShaderArchiveIndexEntry> index(header.count);
+    std::memcpy(
+        index.data(), data.data() + sizeof(ShaderArchiveHeader), index.size() * sizeof(ShaderArchiveIndexEntry));
+    if (std::ranges::any_of(index, [&data](const auto& entry) {
+            return entry.offset > data.size() || entry.size > data.size() - entry.offset;
+        })
+        || !std::ranges::is_sorted(index, {}, &ShaderArchiveIndexEntry::key)) {
+        CHRLOG_WARN("Invalid shader archive {}", filename.string());
+        return false;
+    }
+
+    std::scoped_lock<std::mutex> lock(VulkanShaderArchiveContext::mutex);
+    VulkanShaderArchiveContext::file = std::move(file);
+    VulkanShaderArchiveContext::index = std::move(index);
+
+    CHRLOG_INFO("Shader archive {} loaded with {} modules", filename.string(), header.count);
+    return true;
+}
+
+void VulkanShaderArchive::close()
+{
+    std::scoped_lock<std::mutex> lock(VulkanShaderArchiveContext::mutex);
+    VulkanShaderArchiveContext::file.reset();
+    VulkanShaderArchiveContext::index.clear();
+}
+
+bool VulkanShaderArchive::read(size_t key, ShaderCacheEntry& entry)
+{
+    CHRZONE_RENDERER;
+
+    std::scoped_lock<std::mutex> lock(VulkanShaderArchiveContext::mutex);
+
+    const auto& index = VulkanShaderArchiveContext::index;
+    auto it = std::ranges::lower_bound(index, static_cast<uint64_t>(key), {}, &ShaderArchiveIndexEntry::key);
+    if (it == index.end() || it->key != key) {
+        return false;
+    }
+
+    auto data = VulkanShaderArchiveContext::file->span().subspan(it->offset, it->size);
+    return VulkanShaderCache::deserialize(data, key, entry);
+}
+
+void VulkanShaderArchive::write(
+    const std::filesystem::path& filename, std::span<const std::pair<size_t, ShaderCacheEntry>> entries)
+{
+    CHRZONE_RENDERER;
+
+    std::vector<std::pair<uint64_t, std::vector<uint8_t>>> modules = {};
+    modules.reserve(entries.size());
+    for (const auto& [key, entry] : entries) {
+        modules.emplace_back(key, VulkanShaderCache::serialize(key, entry));
+    }
+
+    // sorted for the binary search, the duplicated keys are the same module
+    std::ranges::sort(modules, {}, &std::pair<uint64_t, std::vector<uint8_t>>::first);
+    auto duplicates = std::ranges::unique(modules, {}, &std::pair<uint64_t, std::vector<uint8_t>>::first);
+    modules.erase(duplicates.begin(), duplicates.end());
+
+    ShaderArchiveHeader header = { .count = modules.size() };
+    std::vector<ShaderArchiveIndexEntry> index = {};
+    index.reserve(modules.size());
+    auto offset = sizeof(ShaderArchiveHeader) + modules.size() * sizeof(ShaderArchiveIndexEntry);
+    for (const auto& [key, data] : modules) {
+        index.push_back({ .key = key, .offset = offset, .size = data.size() });
+        offset += data.size();
+    }
+
+    // write in a temporary file, so a failed write never leave a broken archive
+    std::error_code errorCode = {};
+    if (filename.has_parent_path()) {
+        std::filesystem::create_directories(filename.parent_path(), errorCode);
+    }
+    auto temporaryFilename = filename;
+    temporaryFilename += ".tmp";
+
+    {
+        std::ofstream file(temporaryFilename, std::ios::binary | std::ios::out | std::ios::trunc);
+        file.write(std::bit_cast<const char*>(&header), sizeof(ShaderArchiveHeader));
+        file.write(std::bit_cast<const char*>(index.data()),
+            static_cast<std::streamsize>(index.size() * sizeof(ShaderArchiveIndexEntry)));
+        for (const auto& [_, data] : modules) {
+            file.write(std::bit_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        }
+        if (!file.good()) {
+            throw RendererError(fmt::format("Failed to write shader archive {}", temporaryFilename.string()));
+        }
+    }
+
+    std::filesystem::rename(temporaryFilename, filename, errorCode);
+    if (errorCode) {
+        throw RendererError(
+            fmt::format("Failed to write shader archive {}: {}", filename.string(), errorCode.message()));
+    }
+}
+
+} // namespace chronicle::internal::vulkan
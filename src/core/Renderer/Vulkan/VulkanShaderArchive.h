@@ -0,0 +1,38 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "VulkanShaderCompiler.h"
+
+namespace chronicle::internal::vulkan {
+
+/// @brief Archive with the precompiled shader variants.
+///        The modules are stored with the same key and format of the disk cache, the archive is memory mapped and
+///        only the requested modules are deserialized.
+class VulkanShaderArchive : private NonCopyable<VulkanShaderArchive> {
+public:
+    /// @brief Open an archive, it replaces the one already open.
+    /// @param filename Archive filename.
+    /// @return True if the archive is valid.
+    static bool open(const std::filesystem::path& filename);
+
+    /// @brief Close the archive.
+    static void close();
+
+    /// @brief Read a module from the archive.
+    /// @param key Module key.
+    /// @param entry Filled with the module.
+    /// @return True if the module is in the archive.
+    [[nodiscard]] static bool read(size_t key, ShaderCacheEntry& entry);
+
+    /// @brief Write an archive.
+    /// @param filename Archive filename.
+    /// @param entries Modules to store, with their keys.
+    static void write(
+        const std::filesystem::path& filename, std::span<const std::pair<size_t, ShaderCacheEntry>> entries);
+};
+
+} // namespace chronicle::internal::vulkan
@@ -0,0 +1,262 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "VulkanShaderCache.h"
+
+#include "VulkanCommon.h"
+
+namespace chronicle::internal::vulkan {
+
+constexpr uint32_t ShaderCacheMagic = 0x53524843; ///< "CHRS"
+constexpr uint32_t ShaderCacheVersion = 1;
+
+/// @brief Sequential writer for the cache files.
+class ShaderCacheWriter {
+public:
+    template <typename T> void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto* bytes = std::bit_cast<const uint8_t*>(&value);
+        _data.insert(_data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void write(const std::string& value)
+    {
+        write(static_cast<uint32_t>(value.size()));
+        _data.insert(_data.end(), value.begin(), value.end());
+    }
+
+    [[nodiscard]] const std::vector<uint8_t>& data() const { return _data; }
+
+private:
+    std::vector<uint8_t> _data {};
+};
+
+/// @brief Sequential reader for the cache files, every read is bounds checked.
+class ShaderCacheReader {
+public:
+    explicit ShaderCacheReader(std::span<const uint8_t> data)
+        : _data(data)
+    {
+    }
+
+    template <typename T> [[nodiscard]] bool read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (_data.size() - _offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, _data.data() + _offset, sizeof(T));
+        _offset += sizeof(T);
+        return true;
+    }
+
+    [[nodiscard]] bool read(std::string& value)
+    {
+        uint32_t length = 0;
+        if (!read(length) || _data.size() - _offset < length) {
+            return false;
+        }
+        value.assign(std::bit_cast<const char*>(_data.data() + _offset), length);
+        _offset += length;
+        return true;
+    }
+
+    template <typename T> [[nodiscard]] bool readEnum(T& value)
+    {
+        uint32_t rawValue = 0;
+        if (!read(rawValue)) {
+            return false;
+        }
+        value = static_cast<T>(rawValue);
+        return true;
+    }
+
+    [[nodiscard]] bool finished() const { return _offset == _data.size(); }
+
+private:
+    std::span<const uint8_t> _data {};
+    size_t _offset { 0 };
+};
+
+bool VulkanShaderCache::read(size_t key, ShaderCacheEntry& entry)
+{
+    CHRZONE_RENDERER;
+
+    auto filename = cacheFilename(key);
+    std::error_code errorCode = {};
+    if (filename.empty() || !std::filesystem::exists(filename, errorCode)) {
+        return false;
+    }
+
+    std::vector<uint8_t> data = {};
+    {
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file.is_open()) {
+            return false;
+        }
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(std::bit_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file.good()) {
+            return false;
+        }
+    }
+
+    if (!deserialize(data, key, entry)) {
+        CHRLOG_WARN("Invalid shader cache file {}", filename.string());
+        return false;
+    }
+    return true;
+}
+
+bool VulkanShaderCache::deserialize(std::span<const uint8_t> data, size_t key, ShaderCacheEntry& entry)
+{
+    CHRZONE_RENDERER;
+
+    ShaderCacheReader reader(data);
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t fileKey = 0;
+    if (!reader.read(magic) || !reader.read(version) || !reader.read(fileKey) || magic != ShaderCacheMagic
+        || version != ShaderCacheVersion || fileKey != key) {
+        return false;
+    }
+
+    entry = {};
+
+    // dependencies
+    uint32_t dependenciesCount = 0;
+    if (!reader.read(dependenciesCount)) {
+        return false;
+    }
+    entry.dependencies.resize(dependenciesCount);
+    for (auto& dependency : entry.dependencies) {
+        uint64_t hash = 0;
+        if (!reader.read(dependency.filename) || !reader.read(hash)) {
+            return false;
+        }
+        dependency.hash = static_cast<size_t>(hash);
+    }
+
+    // module
+    uint32_t wordsCount = 0;
+    if (!reader.read(entry.module.entryPoint) || !reader.read(wordsCount)) {
+        return false;
+    }
+    entry.module.spirvBinary.resize(wordsCount);
+    for (auto& word : entry.module.spirvBinary) {
+        if (!reader.read(word)) {
+            return false;
+        }
+    }
+
+    // reflected bindings
+    uint32_t bindingsCount = 0;
+    if (!reader.read(bindingsCount)) {
+        return false;
+    }
+    entry.module.bindings.resize(bindingsCount);
+    for (auto& binding : entry.module.bindings) {
+        uint64_t uniformSize = 0;
+        uint32_t membersCount = 0;
+        if (!reader.read(binding.binding) || !reader.read(binding.descriptorSet)
+            || !reader.readEnum(binding.descriptorType) || !reader.read(binding.name) || !reader.read(uniformSize)
+            || !reader.read(binding.arraySize) || !reader.readEnum(binding.stages) || !reader.read(membersCount)) {
+            return false;
+        }
+        binding.uniformSize = static_cast<size_t>(uniformSize);
+        binding.uniformMembers.resize(membersCount);
+        for (auto& member : binding.uniformMembers) {
+            if (!reader.read(member.name) || !reader.readEnum(member.type) || !reader.read(member.arraySize)) {
+                return false;
+            }
+        }
+    }
+
+    return reader.finished();
+}
+
+void VulkanShaderCache::write(size_t key, const ShaderCacheEntry& entry)
+{
+    CHRZONE_RENDERER;
+
+    auto filename = cacheFilename(key);
+    if (filename.empty()) {
+        return;
+    }
+
+    auto data = serialize(key, entry);
+
+    // write in a temporary file, so a failed write never leave a broken module
+    std::error_code errorCode = {};
+    std::filesystem::create_directories(filename.parent_path(), errorCode);
+    auto temporaryFilename = filename;
+    temporaryFilename += ".tmp";
+
+    {
+        std::ofstream file(temporaryFilename, std::ios::binary | std::ios::out | std::ios::trunc);
+        file.write(std::bit_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file.good()) {
+            CHRLOG_WARN("Failed to write shader cache file {}", temporaryFilename.string());
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporaryFilename, filename, errorCode);
+}
+
+std::vector<uint8_t> VulkanShaderCache::serialize(size_t key, const ShaderCacheEntry& entry)
+{
+    CHRZONE_RENDERER;
+
+    ShaderCacheWriter writer = {};
+    writer.write(ShaderCacheMagic);
+    writer.write(ShaderCacheVersion);
+    writer.write(static_cast<uint64_t>(key));
+
+    // dependencies
+    writer.write(static_cast<uint32_t>(entry.dependencies.size()));
+    for (const auto& dependency : entry.dependencies) {
+        writer.write(dependency.filename);
+        writer.write(static_cast<uint64_t>(dependency.hash));
+    }
+
+    // module
+    writer.write(entry.module.entryPoint);
+    writer.write(static_cast<uint32_t>(entry.module.spirvBinary.size()));
+    for (const auto word : entry.module.spirvBinary) {
+        writer.write(word);
+    }
+
+    // reflected bindings
+    writer.write(static_cast<uint32_t>(entry.module.bindings.size()));
+    for (const auto& binding : entry.module.bindings) {
+        writer.write(binding.binding);
+        writer.write(binding.descriptorSet);
+        writer.write(static_cast<uint32_t>(binding.descriptorType));
+        writer.write(binding.name);
+        writer.write(static_cast<uint64_t>(binding.uniformSize));
+        writer.write(binding.arraySize);
+        writer.write(static_cast<uint32_t>(binding.stages));
+        writer.write(static_cast<uint32_t>(binding.uniformMembers.size()));
+        for (const auto& member : binding.uniformMembers) {
+            writer.write(member.name);
+            writer.write(static_cast<uint32_t>(member.type));
+            writer.write(member.arraySize);
+        }
+    }
+
+    return writer.data();
+}
+
+std::filesystem::path VulkanShaderCache::cacheFilename(size_t key)
+{
+    if (VulkanContext::cacheDirectory.empty()) {
+        return {};
+    }
+    return VulkanContext::cacheDirectory / "Shaders" / fmt::format("{:016x}.spv", key);
+}
+
+} // namespace chronicle::internal::vulkan
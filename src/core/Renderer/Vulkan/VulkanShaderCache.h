@@ -0,0 +1,48 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "VulkanShaderCompiler.h"
+
+namespace chronicle::internal::vulkan {
+
+/// @brief Disk cache for the compiled shader modules.
+///        Every stage of a shader is stored in its own file, named from a key that identifies the source, the macros,
+///        the stage and the compiler options. The cache is disabled if the render context cache directory is empty.
+class VulkanShaderCache : private NonCopyable<VulkanShaderCache> {
+public:
+    /// @brief Read a cached module.
+    /// @param key Module key.
+    /// @param entry Filled with the cached module.
+    /// @return True if the module is cached and the file is valid.
+    [[nodiscard]] static bool read(size_t key, ShaderCacheEntry& entry);
+
+    /// @brief Write a module in the cache.
+    /// @param key Module key.
+    /// @param entry Module to store.
+    static void write(size_t key, const ShaderCacheEntry& entry);
+
+    /// @brief Serialize a module in the cache format.
+    /// @param key Module key.
+    /// @param entry Module to serialize.
+    /// @return Serialized module.
+    [[nodiscard]] static std::vector<uint8_t> serialize(size_t key, const ShaderCacheEntry& entry);
+
+    /// @brief Deserialize a module in the cache format.
+    /// @param data Serialized module.
+    /// @param key Expected module key.
+    /// @param entry Filled with the module.
+    /// @return True if the data is valid.
+    [[nodiscard]] static bool deserialize(std::span<const uint8_t> data, size_t key, ShaderCacheEntry& entry);
+
+private:
+    /// @brief Get the cache filename for a module.
+    /// @param key Module key.
+    /// @return Cache filename, empty if the cache is disabled.
+    [[nodiscard]] static std::filesystem::path cacheFilename(size_t key);
+};
+
+} // namespace chronicle::internal::vulkan
@@ -6,15 +6,35 @@
 #include "Storage/StorageContext.h"
 #include "VulkanCommon.h"
 #include "VulkanShader.h"
+#include "VulkanShaderArchive.h"
+#include "VulkanShaderCache.h"
 
 namespace chronicle::internal::vulkan {
 
+constexpr auto ShaderTargetEnvironment = shaderc_env_version_vulkan_1_1;
+#ifdef NDEBUG
+constexpr auto ShaderOptimizationLevel = shaderc_optimization_level_performance;
+#else
+constexpr auto ShaderOptimizationLevel = shaderc_optimization_level_zero;
+#endif
+
+/// @brief Stages compiled for every shader.
+constexpr std::array<ShaderStage, 2> ShaderStages = { ShaderStage::vertex, ShaderStage::fragment };
+
+/// @brief Marker of a macro that selects a shader variant, like "#pragma variant:QUANTIZED_VERTICES".
+static const std::regex VariantRegex("#pragma variant:(\\w+)");
+
 struct VulkanShaderFileInfo {
     std::string content;
 };
 
 class VulkanShaderIncluder : public shaderc::CompileOptions::IncluderInterface {
 public:
+    explicit VulkanShaderIncluder(std::vector<ShaderCacheDependency>& dependencies)
+        : _dependencies(dependencies)
+    {
+    }
+
     shaderc_include_result* GetInclude(const char* requested_source, shaderc_include_type type,
         const char* requesting_source, size_t include_depth) override
     {
@@ -24,6 +44,7 @@ public:
         try {
             auto file = StorageContext::file(requested_source);
             auto content = file.readAllText();
+            addDependency(requested_source, content);
             auto info = new VulkanShaderFileInfo();
             info->content = std::move(content);
             return new shaderc_include_result { requested_source, std::strlen(requested_source), info->content.data(),
@@ -40,39 +61,157 @@ public:
     }
 
 private:
+    std::vector<ShaderCacheDependency>& _dependencies;
+
     shaderc_include_result* makeErrorIncludeResult(const char* message)
     {
         return new shaderc_include_result { "", 0, message, strlen(message) };
     }
+
+    void addDependency(const std::string& filename, const std::string& content)
+    {
+        if (std::ranges::none_of(_dependencies, [&filename](const auto& item) { return item.filename == filename; })) {
+            _dependencies.push_back({ .filename = filename, .hash = std::hash<std::string>()(content) });
+        }
+    }
 };
 
 ShaderCompilerResult VulkanShaderCompiler::compile(const ShaderCompilerOptions& options)
 {
-    assert(!options.filename.empty());
+    shaderc_source_language shaderLanguage = {};
+    auto sourceCode = readSource(options.filename, shaderLanguage);
 
-    auto shaderLanguage = detectShaderLanguage(options.filename);
-    if (!shaderLanguage)
-        throw RendererError(fmt::format("Unsupport shader language for file {}.", options.filename));
+    // the macros order doesn't change the compiled modules
+    auto sourceHash = std::hash<std::string>()(sourceCode);
+    auto macroDefinitions = options.macroDefinitions;
+    std::ranges::sort(macroDefinitions);
 
-    auto file = StorageContext::file(options.filename);
-    auto sourceCode = file.readAllText();
-    assert(!sourceCode.empty());
+    ShaderCompilerResult result {};
+    for (auto i = 0; i < MaxDescriptorSetsCount; i++) {
+        result.descriptorSetsLayout[i].setNumber = i;
+    }
 
-    std::unordered_map<ShaderStage, std::vector<uint8_t>> codes;
-    std::unordered_map<ShaderStage, std::string> entryPoints;
+    result.modules.reserve(ShaderStages.size());
+    for (const auto stage : ShaderStages) {
+        auto key = getCacheKey(options.filename, sourceHash, macroDefinitions, stage);
 
-    std::array<ShaderStage, 2> stages = { ShaderStage::vertex, ShaderStage::fragment };
+        // a precompiled or cached module skips the compilation and the reflection
+        ShaderCacheEntry entry = {};
+        if (!readModule(key, entry)) {
+#ifdef CHR_SHADER_ARCHIVE_ONLY
+            throw RendererError(fmt::format("Shader {} ({}) for stage {} is not in the variant archive",
+                options.filename, join(macroDefinitions), magic_enum::enum_name(stage)));
+#else
+            entry.dependencies.clear();
+            entry.module = compileModule(sourceCode, shaderLanguage, options, stage, entry.dependencies);
+            VulkanShaderCache::write(key, entry);
+#endif
+        }
 
-    ShaderCompilerResult result {};
-    result.modules.reserve(stages.size());
-    for (const auto stage : stages) {
-        result.modules[stage]
-            = compileModule(sourceCode, shaderLanguage.value(), options, stage, result.descriptorSetsLayout);
+        for (const auto& binding : entry.module.bindings) {
+            addBindingToDescriptorSet(result.descriptorSetsLayout, binding);
+        }
+        result.modules[stage] = std::move(entry.module);
     }
 
     return result;
 }
 
+#ifndef CHR_SHADER_ARCHIVE_ONLY
+
+std::vector<std::pair<size_t, ShaderCacheEntry>> VulkanShaderCompiler::compileVariant(
+    const ShaderCompilerOptions& options)
+{
+    shaderc_source_language shaderLanguage = {};
+    auto sourceCode = readSource(options.filename, shaderLanguage);
+
+    auto sourceHash = std::hash<std::string>()(sourceCode);
+    auto macroDefinitions = options.macroDefinitions;
+    std::ranges::sort(macroDefinitions);
+
+    std::vector<std::pair<size_t, ShaderCacheEntry>> entries = {};
+    entries.reserve(ShaderStages.size());
+    for (const auto stage : ShaderStages) {
+        ShaderCacheEntry entry = {};
+        entry.module = compileModule(sourceCode, shaderLanguage, options, stage, entry.dependencies);
+        entries.emplace_back(getCacheKey(options.filename, sourceHash, macroDefinitions, stage), std::move(entry));
+    }
+    return entries;
+}
+
+#endif
+
+std::vector<std::string> VulkanShaderCompiler::getVariantMacros(const std::string& filename)
+{
+    auto file = StorageContext::file(filename);
+    auto sourceCode = file.readAllText();
+
+    std::vector<std::string> macroDefinitions = {};
+    std::stringstream stream(sourceCode);
+    std::string line;
+    std::smatch match;
+    while (std::getline(stream, line, '\n')) {
+        if (std::regex_search(line, match, VariantRegex)
+            && std::ranges::find(macroDefinitions, match[1].str()) == macroDefinitions.end()) {
+            macroDefinitions.push_back(match[1].str());
+        }
+    }
+    return macroDefinitions;
+}
+
+std::string VulkanShaderCompiler::readSource(const std::string& filename, shaderc_source_language& shaderLanguage)
+{
+    assert(!filename.empty());
+
+    auto detectedLanguage = detectShaderLanguage(filename);
+    if (!detectedLanguage)
+        throw RendererError(fmt::format("Unsupport shader language for file {}.", filename));
+    shaderLanguage = detectedLanguage.value();
+
+    auto file = StorageContext::file(filename);
+    auto sourceCode = file.readAllText();
+    assert(!sourceCode.empty());
+    return sourceCode;
+}
+
+bool VulkanShaderCompiler::readModule(size_t key, ShaderCacheEntry& entry)
+{
+    // the variant archive comes first, the disk cache has the modules compiled at runtime
+    if (VulkanShaderArchive::read(key, entry) && checkDependencies(entry.dependencies)) {
+        return true;
+    }
+#ifndef CHR_SHADER_ARCHIVE_ONLY
+    if (VulkanShaderCache::read(key, entry) && checkDependencies(entry.dependencies)) {
+        return true;
+    }
+#endif
+    return false;
+}
+
+size_t VulkanShaderCompiler::getCacheKey(const std::string& filename, size_t sourceHash,
+    const std::vector<std::string>& macroDefinitions, ShaderStage shaderStage)
+{
+    size_t hash = 0;
+    std::hash_combine(hash, filename, sourceHash, shaderStage, ShaderTargetEnvironment, ShaderOptimizationLevel);
+    for (const auto& macroDefinition : macroDefinitions) {
+        std::hash_combine(hash, macroDefinition);
+    }
+    return hash;
+}
+
+bool VulkanShaderCompiler::checkDependencies(const std::vector<ShaderCacheDependency>& dependencies)
+{
+    return std::ranges::all_of(dependencies, [](const auto& dependency) {
+        try {
+            return StorageContext::exists(dependency.filename)
+                && std::hash<std::string>()(StorageContext::file(dependency.filename).readAllText())
+                == dependency.hash;
+        } catch (const StorageError&) {
+            return false;
+        }
+    });
+}
+
 shaderc_shader_kind VulkanShaderCompiler::getSpirvShader(ShaderStage stage)
 {
     switch (stage) {
@@ -130,6 +269,12 @@ std::string VulkanShaderCompiler::cleanSourceFromOtherStages(const std::string&
             continue;
         }
 
+        // the variant markers are read by the shader cook tool, not by the compiler
+        if (std::regex_search(line, VariantRegex)) {
+            result.append("\n");
+            continue;
+        }
+
         if (!!(currentShaderStage & shaderStage)) {
             result.append(line);
         }
@@ -140,20 +285,18 @@ std::string VulkanShaderCompiler::cleanSourceFromOtherStages(const std::string&
 
 ShaderCompilerModule VulkanShaderCompiler::compileModule(const std::string_view& sourceCode,
     shaderc_source_language shaderLanguage, const ShaderCompilerOptions& options, ShaderStage shaderStage,
-    std::array<DescriptorSetLayout, MaxDescriptorSetsCount>& descriptorSetsLayout)
+    std::vector<ShaderCacheDependency>& dependencies)
 {
     shaderc::Compiler spirvCompiler = {};
     shaderc::CompileOptions spirvOptions = {};
 
-    spirvOptions.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_1);
-#ifdef NDEBUG
-    spirvOptions.SetOptimizationLevel(shaderc_optimization_level_performance);
-#else
-    spirvOptions.SetOptimizationLevel(shaderc_optimization_level_zero);
+    spirvOptions.SetTargetEnvironment(shaderc_target_env_vulkan, ShaderTargetEnvironment);
+    spirvOptions.SetOptimizationLevel(ShaderOptimizationLevel);
+#ifndef NDEBUG
     spirvOptions.SetGenerateDebugInfo();
 #endif
     spirvOptions.SetSourceLanguage(shaderLanguage);
-    spirvOptions.SetIncluder(std::make_unique<VulkanShaderIncluder>());
+    spirvOptions.SetIncluder(std::make_unique<VulkanShaderIncluder>(dependencies));
 
     switch (shaderStage) {
     case ShaderStage::fragment:
@@ -215,29 +358,26 @@ ShaderCompilerModule VulkanShaderCompiler::compileModule(const std::string_view&
             entryPointsAndStages.size(), options.filename));
     }
 
-    for (auto i = 0; i < MaxDescriptorSetsCount; i++) {
-        descriptorSetsLayout[i].setNumber = i;
-    }
-
-    // reflect resources
+    // reflect resources, they are merged with the other stages by the caller
+    std::vector<DescriptorSetLayoutBinding> bindings = {};
     auto resources = spirvCrossCompiler.get_shader_resources();
     for (const auto& resource : resources.uniform_buffers) {
         if (!isResourceInUse(spirvCrossCompiler, resource)) {
             continue;
         }
 
-        auto binding
-            = parseResource(spirvCrossCompiler, resource, options.filename, shaderStage, DescriptorType::uniformBuffer);
-        addBindingToDescriptorSet(descriptorSetsLayout, binding);
+        bindings.push_back(parseResource(
+            spirvCrossCompiler, resource, options.filename, shaderStage, DescriptorType::uniformBuffer));
     }
 
     for (const auto& resource : resources.sampled_images) {
-        auto binding = parseResource(
-            spirvCrossCompiler, resource, options.filename, shaderStage, DescriptorType::combinedImageSampler);
-        addBindingToDescriptorSet(descriptorSetsLayout, binding);
+        bindings.push_back(parseResource(
+            spirvCrossCompiler, resource, options.filename, shaderStage, DescriptorType::combinedImageSampler));
     }
 
-    return ShaderCompilerModule { .spirvBinary = spirvBinary, .entryPoint = entryPointsAndStages[0].name };
+    return ShaderCompilerModule {
+        .spirvBinary = spirvBinary, .entryPoint = entryPointsAndStages[0].name, .bindings = std::move(bindings)
+    };
 }
 
 DescriptorSetLayoutBinding VulkanShaderCompiler::parseResource(const spirv_cross::Compiler& compiler,
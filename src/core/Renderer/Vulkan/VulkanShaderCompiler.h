@@ -21,6 +21,19 @@ struct ShaderCompilerOptions {
 struct ShaderCompilerModule {
     std::vector<uint32_t> spirvBinary {};
     std::string entryPoint {};
+    std::vector<DescriptorSetLayoutBinding> bindings {}; ///< Bindings reflected from the module.
+};
+
+/// @brief File read while compiling a shader, used to check if a cached module is up to date.
+struct ShaderCacheDependency {
+    std::string filename {}; ///< Storage filename.
+    size_t hash { 0 }; ///< Hash of the file content.
+};
+
+/// @brief Compiled and reflected shader module, as stored in the cache and in the variant archive.
+struct ShaderCacheEntry {
+    std::vector<ShaderCacheDependency> dependencies {}; ///< Files included by the shader.
+    ShaderCompilerModule module {}; ///< Compiled module.
 };
 
 constexpr int MaxDescriptorSetsCount { 4 };
@@ -38,6 +51,20 @@ public:
     /// @return Data related to compiled shader, like spirv binary, entrypoints and descriptor sets.
     [[nodiscard]] static ShaderCompilerResult compile(const ShaderCompilerOptions& options);
 
+#ifndef CHR_SHADER_ARCHIVE_ONLY
+    /// @brief Compile all the stages of a shader variant, without using the caches.
+    ///        Used to build the variant archive.
+    /// @param options Shader compile options.
+    /// @return Compiled modules, with their keys.
+    [[nodiscard]] static std::vector<std::pair<size_t, ShaderCacheEntry>> compileVariant(
+        const ShaderCompilerOptions& options);
+#endif
+
+    /// @brief Get the macros that select the variants of a shader, declared with "#pragma variant:NAME".
+    /// @param filename Shader filename.
+    /// @return Variant macros.
+    [[nodiscard]] static std::vector<std::string> getVariantMacros(const std::string& filename);
+
 private:
     /// @brief Get shaderc shader kind from shader stage.
     /// @param stage Shader stage.
@@ -62,16 +89,42 @@ private:
     /// @return Cleaned source code.
     [[nodiscard]] static std::string cleanSourceFromOtherStages(const std::string& source, ShaderStage shaderStage);
 
+    /// @brief Read the source of a shader.
+    /// @param filename Shader filename.
+    /// @param shaderLanguage Filled with the shader language.
+    /// @return Source code.
+    [[nodiscard]] static std::string readSource(const std::string& filename, shaderc_source_language& shaderLanguage);
+
+    /// @brief Read a precompiled module from the variant archive or from the disk cache.
+    /// @param key Module key.
+    /// @param entry Filled with the module.
+    /// @return True if an up to date module is found.
+    [[nodiscard]] static bool readModule(size_t key, ShaderCacheEntry& entry);
+
+    /// @brief Get the key used to cache a shader module.
+    /// @param filename Shader filename.
+    /// @param sourceHash Hash of the shader source.
+    /// @param macroDefinitions Sorted macro definitions.
+    /// @param shaderStage Shader stage.
+    /// @return Cache key.
+    [[nodiscard]] static size_t getCacheKey(const std::string& filename, size_t sourceHash,
+        const std::vector<std::string>& macroDefinitions, ShaderStage shaderStage);
+
+    /// @brief Check if the files included by a cached module are unchanged.
+    /// @param dependencies Included files.
+    /// @return True if the module is up to date.
+    [[nodiscard]] static bool checkDependencies(const std::vector<ShaderCacheDependency>& dependencies);
+
     /// @brief Compile a shader module.
     /// @param sourceCode Source code to compile.
     /// @param shaderLanguage Shader language.
     /// @param options Shader compiler options.
     /// @param shaderStage Shader stage.
-    /// @param descriptorSetsLayout Array containing the descriptor sets layouts.
-    /// @return Compiled module.
+    /// @param dependencies Filled with the files included by the source.
+    /// @return Compiled module, with the reflected bindings.
     [[nodiscard]] static ShaderCompilerModule compileModule(const std::string_view& sourceCode,
         shaderc_source_language shaderLanguage, const ShaderCompilerOptions& options, ShaderStage shaderStage,
-        std::array<DescriptorSetLayout, MaxDescriptorSetsCount>& descriptorSetsLayout);
+        std::vector<ShaderCacheDependency>& dependencies);
 
     /// @brief Parse resources from SPIR-V compiler.
     /// @param compiler SPIR-V compiler.
@@ -13,8 +13,9 @@ CHR_CONCRETE(VulkanTexture);
 
 VulkanTexture::VulkanTexture(const SampledTextureInfo& textureInfo, const std::string& name)
     : _name(name)
-    , _format(Format::R8G8B8A8Unorm)
-    , _generateMipmaps(textureInfo.generateMipmaps)
+    , _format(textureInfo.format)
+    , _generateMipmaps(textureInfo.generateMipmaps && textureInfo.mipLevels.empty()
+          && textureInfo.format == Format::R8G8B8A8Unorm)
     , _width(textureInfo.width)
     , _height(textureInfo.height)
 {
@@ -23,55 +24,43 @@ VulkanTexture::VulkanTexture(const SampledTextureInfo& textureInfo, const std::s
     assert(_width > 0);
     assert(_height > 0);
 
-    if (!textureInfo.data.empty()) {
-        // create a buffer visible to the host
-        auto [stagingBufferMemory, stagingBuffer]
-            = VulkanUtils::createBuffer(textureInfo.data.size(), vk::BufferUsageFlagBits::eTransferSrc,
-                vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
-        // copy image data into the buffer
-        const auto data
-            = VulkanContext::device.mapMemory(stagingBufferMemory, 0, textureInfo.data.size(), vk::MemoryMapFlags());
-        std::memcpy(data, textureInfo.data.data(), textureInfo.data.size());
-        VulkanContext::device.unmapMemory(stagingBufferMemory);
+    auto format = VulkanEnums::formatToVulkan(_format);
 
-        // calculate mip levels
-        _mipLevels = _generateMipmaps ? static_cast<uint32_t>(std::floor(std::log2(std::max(_width, _height)))) + 1 : 1;
+    if (!textureInfo.data.empty()) {
+        // calculate mip levels, the block compressed formats can't be blitted so their levels are pre-baked
+        if (!textureInfo.mipLevels.empty()) {
+            _mipLevels = static_cast<uint32_t>(textureInfo.mipLevels.size());
+        } else {
+            _mipLevels
+                = _generateMipmaps ? static_cast<uint32_t>(std::floor(std::log2(std::max(_width, _height)))) + 1 : 1;
+        }
 
         // create vulkan image
-        auto [imageMemory, image] = VulkanUtils::createImage(_width, _height, _mipLevels, vk::SampleCountFlagBits::e1,
-            vk::Format::eR8G8B8A8Unorm, vk::ImageTiling::eOptimal,
+        auto [imageAllocation, image] = VulkanUtils::createImage(_width, _height, _mipLevels,
+            vk::SampleCountFlagBits::e1, format, vk::ImageTiling::eOptimal,
             vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst
                 | vk::ImageUsageFlagBits::eSampled,
             vk::MemoryPropertyFlagBits::eDeviceLocal);
 
-        // copy local buffer to the image buffer
-        VulkanUtils::transitionImageLayout(
-            image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, _mipLevels);
-        VulkanUtils::copyBufferToImage(stagingBuffer, image, _width, _height);
-
-        // destroy and free memory of local visible buffer
-        VulkanContext::device.destroyBuffer(stagingBuffer);
-        VulkanContext::device.freeMemory(stagingBufferMemory);
-
-        // generate mipmaps if required, or just trasition the image layout
-        if (_generateMipmaps) {
-            VulkanUtils::generateMipmaps(image, vk::Format::eR8G8B8A8Unorm, _width, _height, _mipLevels);
-        } else {
-            VulkanUtils::transitionImageLayout(
-                image, vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eShaderReadOnlyOptimal, _mipLevels);
-        }
+        // the copy, the mipmaps and the layout transitions go through the staging ring
+        _uploadFence = VulkanUploadManager::uploadImage({ .image = image,
+            .format = format,
+            .width = _width,
+            .height = _height,
+            .mipLevels = _mipLevels,
+            .mipLevelsData = textureInfo.mipLevels,
+            .generateMipmaps = _generateMipmaps,
+            .data = textureInfo.data });
 
         // stora image data
-        _imageMemory = imageMemory;
+        _imageAllocation = imageAllocation;
         _image = image;
 
         // create image view
-        _imageView = VulkanUtils::createImageView(
-            image, vk::Format::eR8G8B8A8Unorm, vk::ImageAspectFlagBits::eColor, _mipLevels);
+        _imageView = VulkanUtils::createImageView(image, format, vk::ImageAspectFlagBits::eColor, _mipLevels);
 
         // create sampler
-        _sampler = VulkanUtils::createTextureSampler(_mipLevels);
+        _sampler = VulkanUtils::createTextureSampler(_mipLevels, textureInfo.sampler);
     }
 }
 
@@ -99,10 +88,10 @@ VulkanTexture::VulkanTexture(const ColorTextureInfo& textureInfo, const std::str
     // calculate mip levels
     _mipLevels = _generateMipmaps ? static_cast<uint32_t>(std::floor(std::log2(std::max(_width, _height)))) + 1 : 1;
 
-    auto [imageMemory, image]
+    auto [imageAllocation, image]
         = VulkanUtils::createImage(_width, _height, _mipLevels, VulkanEnums::msaaToVulkan(textureInfo.msaa), format,
             vk::ImageTiling::eOptimal, usageFlags, vk::MemoryPropertyFlagBits::eDeviceLocal);
-    _imageMemory = imageMemory;
+    _imageAllocation = imageAllocation;
     _image = image;
     _imageView = VulkanUtils::createImageView(image, format, vk::ImageAspectFlagBits::eColor, _mipLevels);
 
@@ -125,10 +114,10 @@ VulkanTexture::VulkanTexture(const DepthTextureInfo& textureInfo, const std::str
 
     auto format = VulkanEnums::formatToVulkan(_format);
 
-    auto [imageMemory, image] = VulkanUtils::createImage(_width, _height, 1,
+    auto [imageAllocation, image] = VulkanUtils::createImage(_width, _height, 1,
         VulkanEnums::msaaToVulkan(textureInfo.msaa), format, vk::ImageTiling::eOptimal,
         vk::ImageUsageFlagBits::eDepthStencilAttachment, vk::MemoryPropertyFlagBits::eDeviceLocal);
-    _imageMemory = imageMemory;
+    _imageAllocation = imageAllocation;
     _image = image;
     _imageView = VulkanUtils::createImageView(image, format, vk::ImageAspectFlagBits::eDepth, 1);
 }
@@ -164,8 +153,12 @@ VulkanTexture::~VulkanTexture()
     }
 
     if (_type != TextureType::swapchain) {
+        // the image can be still in the upload batch
+        if (_uploadFence != 0) {
+            VulkanUploadManager::wait(_uploadFence);
+        }
         VulkanContext::device.destroyImage(_image);
-        VulkanContext::device.freeMemory(_imageMemory);
+        VulkanMemoryAllocator::free(_imageAllocation);
     }
 }
 
@@ -6,6 +6,8 @@
 #include "pch.h"
 
 #include "Renderer/BaseTexture.h"
+#include "VulkanMemoryAllocator.h"
+#include "VulkanUploadManager.h"
 
 namespace chronicle::internal::vulkan {
 
@@ -46,6 +48,10 @@ public:
     /// @brief @see BaseTexture#height
     [[nodiscard]] uint32_t height() const { return _height; }
 
+    /// @brief Check if the image upload is completed on the GPU.
+    /// @return True if the image can be sampled without waiting the upload.
+    [[nodiscard]] bool uploaded() const { return _uploadFence == 0 || VulkanUploadManager::isCompleted(_uploadFence); }
+
     /// @brief @see BaseTexture#textureId
     [[nodiscard]] TextureId textureId() const { return _imageView; }
 
@@ -73,7 +79,7 @@ public:
 
 private:
     std::string _name {}; ///< Name.
-    vk::DeviceMemory _imageMemory {}; ///< Device memory for the image.
+    VulkanAllocation _imageAllocation {}; ///< Device memory for the image.
     vk::Image _image {}; ///< Image.
     vk::ImageView _imageView {}; ///< Image view.
     vk::Sampler _sampler {}; ///< Image sampler.
@@ -84,6 +90,7 @@ private:
     uint32_t _mipLevels {}; ///< Image miplevels.
     uint32_t _width {}; ///< Image width.
     uint32_t _height {}; ///< Image height.
+    uint64_t _uploadFence { 0 }; ///< Completion fence of the image upload, zero if not uploaded.
 };
 
 } // namespace chronicle
\ No newline at end of file
@@ -0,0 +1,106 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "VulkanUniformRing.h"
+
+#include "VulkanMemoryAllocator.h"
+#include "VulkanUtils.h"
+
+namespace chronicle::internal::vulkan {
+
+constexpr vk::DeviceSize UniformRingFrameSize = 4 * 1024 * 1024; ///< Size of the region of a frame.
+
+struct VulkanUniformRingContext {
+    static inline vk::Buffer buffer {}; ///< Buffer with the regions of all the frames.
+    static inline VulkanAllocation allocation {}; ///< Memory of the buffer, persistently mapped.
+    static inline vk::DeviceSize alignment { 0 }; ///< Alignment of the dynamic offsets.
+    static inline vk::DeviceSize head { 0 }; ///< Next write position in the region of the current frame.
+    static inline uint64_t frameSerial { 1 }; ///< Serial number of the current frame.
+    static inline std::mutex mutex {}; ///< Mutex for the regions.
+};
+
+void VulkanUniformRing::init()
+{
+    CHRZONE_RENDERER;
+
+    CHRLOG_TRACE("Uniform ring init");
+
+    assert(!VulkanUniformRingContext::buffer);
+
+    VulkanUniformRingContext::alignment
+        = VulkanContext::physicalDevice.getProperties().limits.minUniformBufferOffsetAlignment;
+
+    // a region for every frame in flight, written by the host and read by the shaders
+    auto [allocation, buffer] = VulkanUtils::createBuffer(UniformRingFrameSize * VulkanContext::maxFramesInFlight,
+        vk::BufferUsageFlagBits::eUniformBuffer,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+    // the host visible memory is persistently mapped by the allocator
+    assert(allocation.mapped);
+
+    VulkanUniformRingContext::buffer = buffer;
+    VulkanUniformRingContext::allocation = allocation;
+    VulkanUniformRingContext::head = 0;
+
+#ifdef VULKAN_ENABLE_DEBUG_MARKER
+    VulkanUtils::setDebugObjectName(buffer, "Uniform ring");
+#endif // VULKAN_ENABLE_DEBUG_MARKER
+}
+
+void VulkanUniformRing::deinit()
+{
+    CHRZONE_RENDERER;
+
+    CHRLOG_TRACE("Uniform ring deinit");
+
+    VulkanContext::device.destroyBuffer(VulkanUniformRingContext::buffer);
+    VulkanMemoryAllocator::free(VulkanUniformRingContext::allocation);
+
+    VulkanUniformRingContext::buffer = nullptr;
+    VulkanUniformRingContext::allocation = {};
+}
+
+void VulkanUniformRing::beginFrame()
+{
+    CHRZONE_RENDERER;
+
+    std::scoped_lock<std::mutex> lock(VulkanUniformRingContext::mutex);
+
+    // the fence of the frame is signaled, its region is not read anymore
+    VulkanUniformRingContext::head = 0;
+    VulkanUniformRingContext::frameSerial++;
+}
+
+uint32_t VulkanUniformRing::allocate(std::span<const uint8_t> data)
+{
+    CHRZONE_RENDERER;
+
+    assert(!data.empty());
+    assert(VulkanUniformRingContext::buffer);
+
+    std::scoped_lock<std::mutex> lock(VulkanUniformRingContext::mutex);
+
+    auto alignment = VulkanUniformRingContext::alignment;
+    auto offset = (VulkanUniformRingContext::head + alignment - 1) & ~(alignment - 1);
+    if (offset + data.size() > UniformRingFrameSize) {
+        throw RendererError("Uniform ring region of the frame is full");
+    }
+    VulkanUniformRingContext::head = offset + data.size();
+
+    // the region of the frame follows the ones of the previous frames
+    offset += UniformRingFrameSize * VulkanContext::currentFrame;
+    std::memcpy(static_cast<uint8_t*>(VulkanUniformRingContext::allocation.mapped) + offset, data.data(), data.size());
+
+    return static_cast<uint32_t>(offset);
+}
+
+vk::Buffer VulkanUniformRing::buffer() { return VulkanUniformRingContext::buffer; }
+
+uint64_t VulkanUniformRing::frameSerial()
+{
+    std::scoped_lock<std::mutex> lock(VulkanUniformRingContext::mutex);
+
+    return VulkanUniformRingContext::frameSerial;
+}
+
+} // namespace chronicle::internal::vulkan
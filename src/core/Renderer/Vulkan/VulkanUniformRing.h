@@ -0,0 +1,41 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "VulkanCommon.h"
+
+namespace chronicle::internal::vulkan {
+
+/// @brief Linear allocator for the uniform data of the frames in flight.
+///        A persistently mapped buffer is split in a region for every frame in flight, the data of a frame is
+///        appended to its region and read with dynamic offsets, so the values written for a frame never overwrite
+///        the ones still read by the GPU. The region is reset when the frame starts again, after its fence.
+class VulkanUniformRing {
+public:
+    /// @brief Create the buffer, before the descriptor sets.
+    static void init();
+
+    /// @brief Destroy the buffer, when the GPU doesn't use it anymore.
+    static void deinit();
+
+    /// @brief Reset the region of the current frame, after the wait of its fence.
+    static void beginFrame();
+
+    /// @brief Copy data in the region of the current frame.
+    /// @param data Data to copy.
+    /// @return Dynamic offset of the data in the buffer.
+    [[nodiscard]] static uint32_t allocate(std::span<const uint8_t> data);
+
+    /// @brief Get the buffer, bound by the dynamic uniform descriptors.
+    /// @return Buffer.
+    [[nodiscard]] static vk::Buffer buffer();
+
+    /// @brief Get the serial number of the current frame, the data allocated in older frames can be overwritten.
+    /// @return Frame serial number, never zero.
+    [[nodiscard]] static uint64_t frameSerial();
+};
+
+} // namespace chronicle::internal::vulkan
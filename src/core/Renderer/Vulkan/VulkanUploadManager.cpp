@@ -0,0 +1,526 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "VulkanUploadManager.h"
+
+#include "VulkanMemoryAllocator.h"
+#include "VulkanUtils.h"
+
+namespace chronicle::internal::vulkan {
+
+constexpr vk::DeviceSize StagingRingSize = 32 * 1024 * 1024; ///< Size of the staging ring.
+constexpr vk::DeviceSize StagingAlignment = 256; ///< Covers the copy offset alignment of the buffers and the images.
+constexpr uint32_t UploadBatchesCount = 4; ///< Batches that can be in flight at the same time.
+
+/// @brief Image copy recorded on submit.
+struct VulkanPendingImage {
+    vk::Image image {}; ///< Destination image.
+    vk::Format format { vk::Format::eUndefined }; ///< Image format.
+    uint32_t width { 0 }; ///< Image width.
+    uint32_t height { 0 }; ///< Image height.
+    uint32_t mipLevels { 1 }; ///< Image mip levels.
+    std::vector<TextureMipLevel> mipLevelsData {}; ///< Pre-baked mip levels.
+    bool generateMipmaps { false }; ///< Generate the other mip levels from the first one.
+    vk::Buffer stagingBuffer {}; ///< Buffer with the data.
+    vk::DeviceSize stagingOffset { 0 }; ///< Offset of the data in the buffer.
+};
+
+/// @brief Copies submitted together.
+struct VulkanUploadBatch {
+    vk::CommandBuffer commandBuffer {}; ///< Command buffer with the copies, for the transfer queue.
+    vk::CommandBuffer acquireCommandBuffer {}; ///< Ownership acquires for the graphics queue.
+    vk::Semaphore semaphore {}; ///< Signaled by the transfer queue, waited by the acquires.
+    vk::Fence fence {}; ///< Signaled when the copies (and the acquires) are completed.
+    uint64_t ringEnd { 0 }; ///< Ring position after the data of the batch, released when the batch is retired.
+    uint64_t serial { 0 }; ///< Serial number, used as completion fence by the uploads.
+    std::vector<std::pair<VulkanAllocation, vk::Buffer>> stagingBuffers {}; ///< Data bigger than the ring.
+};
+
+struct VulkanUploadManagerContext {
+    static inline vk::CommandPool commandPool {}; ///< Command pool for the transfer family.
+    static inline vk::CommandPool acquireCommandPool {}; ///< Command pool for the graphics family.
+    static inline vk::Buffer ringBuffer {}; ///< Staging ring.
+    static inline VulkanAllocation ringAllocation {}; ///< Memory of the staging ring, persistently mapped.
+    static inline uint64_t ringHead { 0 }; ///< Next write position, the offset in the ring is head % size.
+    static inline uint64_t ringTail { 0 }; ///< Oldest position still read by the GPU.
+    static inline std::array<VulkanUploadBatch, UploadBatchesCount> batches {}; ///< Batches.
+    static inline uint32_t currentBatch { 0 }; ///< Batch that records the next copies.
+    static inline bool recording { false }; ///< True if the current batch has copies.
+    static inline std::deque<uint32_t> submittedBatches {}; ///< Batches in flight, from the oldest.
+    static inline std::vector<std::pair<VulkanAllocation, vk::Buffer>> stagingBuffers {}; ///< For the current batch.
+    static inline std::vector<VulkanPendingImage> pendingImages {}; ///< Images of the current batch.
+    static inline uint64_t batchSerial { 1 }; ///< Serial number of the current batch.
+    static inline uint64_t completedSerial { 0 }; ///< Serial number of the last retired batch.
+    static inline std::mutex mutex {}; ///< Mutex for the batches and the ring.
+};
+
+void VulkanUploadManager::init()
+{
+    CHRZONE_RENDERER;
+
+    CHRLOG_TRACE("Upload manager init");
+
+    auto& batches = VulkanUploadManagerContext::batches;
+
+    // command pool for the short lived command buffers
+    vk::CommandPoolCreateInfo poolInfo = {};
+    poolInfo.setFlags(vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+    poolInfo.setQueueFamilyIndex(VulkanContext::transferFamily);
+    VulkanUploadManagerContext::commandPool = VulkanContext::device.createCommandPool(poolInfo);
+
+    // command buffers and fences for the batches
+    vk::CommandBufferAllocateInfo allocInfo = {};
+    allocInfo.setLevel(vk::CommandBufferLevel::ePrimary);
+    allocInfo.setCommandPool(VulkanUploadManagerContext::commandPool);
+    allocInfo.setCommandBufferCount(UploadBatchesCount);
+    auto commandBuffers = VulkanContext::device.allocateCommandBuffers(allocInfo);
+    for (uint32_t i = 0; i < UploadBatchesCount; i++) {
+        batches[i].commandBuffer = commandBuffers[i];
+        batches[i].fence = VulkanContext::device.createFence({});
+    }
+
+    // the resources copied on the transfer queue are handed to the graphics queue
+    if (dedicatedTransfer()) {
+        poolInfo.setQueueFamilyIndex(VulkanContext::graphicsFamily);
+        VulkanUploadManagerContext::acquireCommandPool = VulkanContext::device.createCommandPool(poolInfo);
+
+        allocInfo.setCommandPool(VulkanUploadManagerContext::acquireCommandPool);
+        auto acquireCommandBuffers = VulkanContext::device.allocateCommandBuffers(allocInfo);
+        for (uint32_t i = 0; i < UploadBatchesCount; i++) {
+            batches[i].acquireCommandBuffer = acquireCommandBuffers[i];
+            batches[i].semaphore = VulkanContext::device.createSemaphore({});
+        }
+    }
+
+    // staging ring
+    auto [ringAllocation, ringBuffer] = VulkanUtils::createBuffer(StagingRingSize,
+        vk::BufferUsageFlagBits::eTransferSrc,
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+    assert(ringAllocation.mapped);
+    VulkanUploadManagerContext::ringAllocation = ringAllocation;
+    VulkanUploadManagerContext::ringBuffer = ringBuffer;
+    VulkanUploadManagerContext::ringHead = 0;
+    VulkanUploadManagerContext::ringTail = 0;
+
+#ifdef VULKAN_ENABLE_DEBUG_MARKER
+    VulkanUtils::setDebugObjectName(ringBuffer, "Staging ring");
+#endif // VULKAN_ENABLE_DEBUG_MARKER
+}
+
+void VulkanUploadManager::deinit()
+{
+    CHRZONE_RENDERER;
+
+    CHRLOG_TRACE("Upload manager deinit");
+
+    std::scoped_lock<std::mutex> lock(VulkanUploadManagerContext::mutex);
+
+    // complete the pending copies
+    submitBatch();
+    while (!VulkanUploadManagerContext::submittedBatches.empty()) {
+        retireBatch();
+    }
+
+    for (auto& batch : VulkanUploadManagerContext::batches) {
+        VulkanContext::device.destroyFence(batch.fence);
+        if (batch.semaphore) {
+            VulkanContext::device.destroySemaphore(batch.semaphore);
+        }
+        batch = {};
+    }
+    VulkanContext::device.destroyCommandPool(VulkanUploadManagerContext::commandPool);
+    if (VulkanUploadManagerContext::acquireCommandPool) {
+        VulkanContext::device.destroyCommandPool(VulkanUploadManagerContext::acquireCommandPool);
+        VulkanUploadManagerContext::acquireCommandPool = nullptr;
+    }
+
+    VulkanContext::device.destroyBuffer(VulkanUploadManagerContext::ringBuffer);
+    VulkanMemoryAllocator::free(VulkanUploadManagerContext::ringAllocation);
+    VulkanUploadManagerContext::ringBuffer = nullptr;
+    VulkanUploadManagerContext::ringAllocation = {};
+}
+
+uint64_t VulkanUploadManager::uploadBuffer(
+    vk::Buffer dstBuffer, std::span<const uint8_t> data, vk::DeviceSize dstOffset)
+{
+    CHRZONE_RENDERER;
+
+    assert(dstBuffer);
+    assert(!data.empty());
+
+    std::scoped_lock<std::mutex> lock(VulkanUploadManagerContext::mutex);
+
+    // the staging can submit the current batch, so it comes before the recording
+    auto [stagingBuffer, stagingOffset] = stage(data);
+    auto commandBuffer = beginBatch();
+    VulkanUtils::copyBuffer(commandBuffer, stagingBuffer, stagingOffset, dstBuffer, dstOffset, data.size());
+
+    // hand the range to the graphics queue, the release and the acquire barriers must match
+    if (dedicatedTransfer()) {
+        vk::BufferMemoryBarrier barrier = {};
+        barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+        barrier.setSrcQueueFamilyIndex(VulkanContext::transferFamily);
+        barrier.setDstQueueFamilyIndex(VulkanContext::graphicsFamily);
+        barrier.setBuffer(dstBuffer);
+        barrier.setOffset(dstOffset);
+        barrier.setSize(data.size());
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+            vk::DependencyFlags(), nullptr, barrier, nullptr);
+
+        barrier.setSrcAccessMask({});
+        barrier.setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead);
+        currentBatch().acquireCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
+            vk::PipelineStageFlagBits::eVertexInput, vk::DependencyFlags(), nullptr, barrier, nullptr);
+    }
+
+    return VulkanUploadManagerContext::batchSerial;
+}
+
+uint64_t VulkanUploadManager::uploadImage(const VulkanImageUpload& upload)
+{
+    CHRZONE_RENDERER;
+
+    assert(upload.image);
+    assert(upload.width > 0);
+    assert(upload.height > 0);
+    assert(!upload.data.empty());
+
+    // the blits are recorded on submit, so the format is checked before
+    if (upload.generateMipmaps) {
+        auto formatProperties = VulkanContext::physicalDevice.getFormatProperties(upload.format);
+        if (!(formatProperties.optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
+            throw RendererError("Texture image format does not support linear blitting");
+        }
+    }
+
+    std::scoped_lock<std::mutex> lock(VulkanUploadManagerContext::mutex);
+
+    // the commands are recorded on submit, so the barriers of all the images are batched
+    auto [stagingBuffer, stagingOffset] = stage(upload.data);
+    (void)beginBatch();
+    VulkanUploadManagerContext::pendingImages.push_back({ .image = upload.image,
+        .format = upload.format,
+        .width = upload.width,
+        .height = upload.height,
+        .mipLevels = upload.mipLevels,
+        .mipLevelsData = { upload.mipLevelsData.begin(), upload.mipLevelsData.end() },
+        .generateMipmaps = upload.generateMipmaps,
+        .stagingBuffer = stagingBuffer,
+        .stagingOffset = stagingOffset });
+    return VulkanUploadManagerContext::batchSerial;
+}
+
+bool VulkanUploadManager::isCompleted(uint64_t fence)
+{
+    CHRZONE_RENDERER;
+
+    std::scoped_lock<std::mutex> lock(VulkanUploadManagerContext::mutex);
+
+    retireCompletedBatches();
+    return fence <= VulkanUploadManagerContext::completedSerial;
+}
+
+void VulkanUploadManager::wait(uint64_t fence)
+{
+    CHRZONE_RENDERER;
+
+    std::scoped_lock<std::mutex> lock(VulkanUploadManagerContext::mutex);
+
+    if (fence == VulkanUploadManagerContext::batchSerial) {
+        submitBatch();
+    }
+    while (VulkanUploadManagerContext::completedSerial < fence
+        && !VulkanUploadManagerContext::submittedBatches.empty()) {
+        retireBatch();
+    }
+}
+
+void VulkanUploadManager::flush()
+{
+    CHRZONE_RENDERER;
+
+    std::scoped_lock<std::mutex> lock(VulkanUploadManagerContext::mutex);
+
+    retireCompletedBatches();
+    submitBatch();
+}
+
+std::pair<vk::Buffer, vk::DeviceSize> VulkanUploadManager::stage(std::span<const uint8_t> data)
+{
+    CHRZONE_RENDERER;
+
+    auto& ringHead = VulkanUploadManagerContext::ringHead;
+    auto& ringTail = VulkanUploadManagerContext::ringTail;
+    const auto size = static_cast<vk::DeviceSize>(data.size());
+
+    // the data bigger than the ring gets its own staging buffer, released with the batch that copies it
+    if (size > StagingRingSize) {
+        auto [allocation, buffer] = VulkanUtils::createBuffer(size, vk::BufferUsageFlagBits::eTransferSrc,
+            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+        std::memcpy(allocation.mapped, data.data(), data.size());
+        VulkanUploadManagerContext::stagingBuffers.emplace_back(allocation, buffer);
+        return { buffer, 0 };
+    }
+
+    vk::DeviceSize position = 0;
+    while (true) {
+        // the data never wraps around the end of the ring
+        position = (ringHead + StagingAlignment - 1) & ~(StagingAlignment - 1);
+        if (position % StagingRingSize + size > StagingRingSize) {
+            position += StagingRingSize - position % StagingRingSize;
+        }
+        if (position + size - ringTail <= StagingRingSize) {
+            break;
+        }
+
+        // the ring is empty, restart from its beginning
+        if (VulkanUploadManagerContext::submittedBatches.empty() && !VulkanUploadManagerContext::recording) {
+            ringHead = position - position % StagingRingSize;
+            ringTail = ringHead;
+            continue;
+        }
+
+        // wait the GPU for the oldest copies, the current batch is submitted if it has the space
+        CHRLOG_DEBUG("Staging ring full, waiting for the uploads");
+        if (VulkanUploadManagerContext::submittedBatches.empty()) {
+            submitBatch();
+        }
+        retireBatch();
+    }
+
+    auto offset = position % StagingRingSize;
+    std::memcpy(static_cast<uint8_t*>(VulkanUploadManagerContext::ringAllocation.mapped) + offset, data.data(),
+        data.size());
+    ringHead = position + size;
+    return { VulkanUploadManagerContext::ringBuffer, offset };
+}
+
+vk::CommandBuffer VulkanUploadManager::beginBatch()
+{
+    CHRZONE_RENDERER;
+
+    auto& batch = currentBatch();
+    if (VulkanUploadManagerContext::recording) {
+        return batch.commandBuffer;
+    }
+
+    // the batch can be still in flight from the previous round
+    while (std::ranges::find(VulkanUploadManagerContext::submittedBatches, VulkanUploadManagerContext::currentBatch)
+        != VulkanUploadManagerContext::submittedBatches.end()) {
+        retireBatch();
+    }
+
+    vk::CommandBufferBeginInfo beginInfo = {};
+    beginInfo.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+    batch.commandBuffer.reset();
+    batch.commandBuffer.begin(beginInfo);
+    if (batch.acquireCommandBuffer) {
+        batch.acquireCommandBuffer.reset();
+        batch.acquireCommandBuffer.begin(beginInfo);
+    }
+
+    VulkanUploadManagerContext::recording = true;
+    return batch.commandBuffer;
+}
+
+void VulkanUploadManager::submitBatch()
+{
+    CHRZONE_RENDERER;
+
+    if (!VulkanUploadManagerContext::recording) {
+        return;
+    }
+
+    auto& batch = currentBatch();
+    recordImages();
+
+    // the acquires on the graphics queue wait for the copies on the transfer queue
+    if (dedicatedTransfer()) {
+        batch.commandBuffer.end();
+        batch.acquireCommandBuffer.end();
+
+        vk::SubmitInfo transferSubmitInfo = {};
+        transferSubmitInfo.setCommandBuffers(batch.commandBuffer);
+        transferSubmitInfo.setSignalSemaphores(batch.semaphore);
+        VulkanContext::transferQueue.submit(transferSubmitInfo, nullptr);
+
+        std::array<vk::PipelineStageFlags, 1> waitStages = { vk::PipelineStageFlagBits::eAllCommands };
+        vk::SubmitInfo acquireSubmitInfo = {};
+        acquireSubmitInfo.setWaitSemaphores(batch.semaphore);
+        acquireSubmitInfo.setWaitDstStageMask(waitStages);
+        acquireSubmitInfo.setCommandBuffers(batch.acquireCommandBuffer);
+        VulkanContext::graphicsQueue.submit(acquireSubmitInfo, batch.fence);
+
+        finishBatch();
+        return;
+    }
+
+    // make the copies visible to the commands submitted later on the queue
+    vk::MemoryBarrier barrier = {};
+    barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite);
+    barrier.setDstAccessMask(vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead
+        | vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead);
+    batch.commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eVertexInput | vk::PipelineStageFlagBits::eVertexShader
+            | vk::PipelineStageFlagBits::eFragmentShader,
+        vk::DependencyFlags(), barrier, nullptr, nullptr);
+    batch.commandBuffer.end();
+
+    vk::SubmitInfo submitInfo = {};
+    submitInfo.setCommandBuffers(batch.commandBuffer);
+    VulkanContext::transferQueue.submit(submitInfo, batch.fence);
+
+    finishBatch();
+}
+
+void VulkanUploadManager::finishBatch()
+{
+    auto& batch = currentBatch();
+    batch.ringEnd = VulkanUploadManagerContext::ringHead;
+    batch.stagingBuffers = std::move(VulkanUploadManagerContext::stagingBuffers);
+    VulkanUploadManagerContext::stagingBuffers.clear();
+    batch.serial = VulkanUploadManagerContext::batchSerial++;
+    VulkanUploadManagerContext::submittedBatches.push_back(VulkanUploadManagerContext::currentBatch);
+    VulkanUploadManagerContext::currentBatch = (VulkanUploadManagerContext::currentBatch + 1) % UploadBatchesCount;
+    VulkanUploadManagerContext::recording = false;
+}
+
+void VulkanUploadManager::recordImages()
+{
+    CHRZONE_RENDERER;
+
+    auto& images = VulkanUploadManagerContext::pendingImages;
+    if (images.empty()) {
+        return;
+    }
+
+    auto& batch = currentBatch();
+    auto imageBarrier = [](const VulkanPendingImage& image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
+                            vk::AccessFlags srcAccessMask, vk::AccessFlags dstAccessMask) {
+        vk::ImageMemoryBarrier barrier = {};
+        barrier.setSrcAccessMask(srcAccessMask);
+        barrier.setDstAccessMask(dstAccessMask);
+        barrier.setOldLayout(oldLayout);
+        barrier.setNewLayout(newLayout);
+        barrier.setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+        barrier.setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED);
+        barrier.setImage(image.image);
+        barrier.setSubresourceRange({ vk::ImageAspectFlagBits::eColor, 0, image.mipLevels, 0, 1 });
+        return barrier;
+    };
+
+    // every image to the transfer destination layout, with a single barrier
+    std::vector<vk::ImageMemoryBarrier> barriers = {};
+    barriers.reserve(images.size());
+    for (const auto& image : images) {
+        barriers.push_back(imageBarrier(image, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+            vk::AccessFlags(), vk::AccessFlagBits::eTransferWrite));
+    }
+    batch.commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+        vk::DependencyFlags(), nullptr, nullptr, barriers);
+
+    for (const auto& image : images) {
+        VulkanUtils::copyBufferToImage(batch.commandBuffer, image.stagingBuffer, image.stagingOffset, image.image,
+            image.width, image.height, image.mipLevelsData);
+    }
+
+    // the images with generated mipmaps stay in the transfer destination layout for the blits
+    barriers.clear();
+    if (!dedicatedTransfer()) {
+        for (const auto& image : images) {
+            if (!image.generateMipmaps) {
+                barriers.push_back(imageBarrier(image, vk::ImageLayout::eTransferDstOptimal,
+                    vk::ImageLayout::eShaderReadOnlyOptimal, vk::AccessFlagBits::eTransferWrite,
+                    vk::AccessFlagBits::eShaderRead));
+            }
+        }
+        if (!barriers.empty()) {
+            batch.commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                vk::PipelineStageFlagBits::eFragmentShader, vk::DependencyFlags(), nullptr, nullptr, barriers);
+        }
+        for (const auto& image : images) {
+            if (image.generateMipmaps) {
+                VulkanUtils::generateMipmaps(
+                    batch.commandBuffer, image.image, image.format, image.width, image.height, image.mipLevels);
+            }
+        }
+        images.clear();
+        return;
+    }
+
+    // hand the images to the graphics queue, the layout transition is part of the ownership transfer
+    for (const auto& image : images) {
+        auto barrier = imageBarrier(image, vk::ImageLayout::eTransferDstOptimal,
+            image.generateMipmaps ? vk::ImageLayout::eTransferDstOptimal : vk::ImageLayout::eShaderReadOnlyOptimal,
+            vk::AccessFlagBits::eTransferWrite, vk::AccessFlags());
+        barrier.setSrcQueueFamilyIndex(VulkanContext::transferFamily);
+        barrier.setDstQueueFamilyIndex(VulkanContext::graphicsFamily);
+        barriers.push_back(barrier);
+    }
+    batch.commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eBottomOfPipe,
+        vk::DependencyFlags(), nullptr, nullptr, barriers);
+
+    // the blits need a graphics queue, so the mipmaps are generated after the acquire
+    for (size_t i = 0; i < images.size(); i++) {
+        barriers[i].setSrcAccessMask(vk::AccessFlags());
+        barriers[i].setDstAccessMask(images[i].generateMipmaps
+                ? vk::AccessFlagBits::eTransferRead | vk::AccessFlagBits::eTransferWrite
+                : vk::AccessFlagBits::eShaderRead);
+    }
+    batch.acquireCommandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eAllCommands,
+        vk::PipelineStageFlagBits::eTransfer | vk::PipelineStageFlagBits::eFragmentShader, vk::DependencyFlags(),
+        nullptr, nullptr, barriers);
+    for (const auto& image : images) {
+        if (image.generateMipmaps) {
+            VulkanUtils::generateMipmaps(
+                batch.acquireCommandBuffer, image.image, image.format, image.width, image.height, image.mipLevels);
+        }
+    }
+    images.clear();
+}
+
+void VulkanUploadManager::retireCompletedBatches()
+{
+    CHRZONE_RENDERER;
+
+    const auto& batches = VulkanUploadManagerContext::batches;
+    const auto& submittedBatches = VulkanUploadManagerContext::submittedBatches;
+    while (!submittedBatches.empty()
+        && VulkanContext::device.getFenceStatus(batches[submittedBatches.front()].fence) == vk::Result::eSuccess) {
+        retireBatch();
+    }
+}
+
+VulkanUploadBatch& VulkanUploadManager::currentBatch()
+{
+    return VulkanUploadManagerContext::batches[VulkanUploadManagerContext::currentBatch];
+}
+
+bool VulkanUploadManager::dedicatedTransfer()
+{
+    return VulkanContext::transferFamily != VulkanContext::graphicsFamily;
+}
+
+void VulkanUploadManager::retireBatch()
+{
+    CHRZONE_RENDERER;
+
+    assert(!VulkanUploadManagerContext::submittedBatches.empty());
+
+    auto& batch = VulkanUploadManagerContext::batches[VulkanUploadManagerContext::submittedBatches.front()];
+    VulkanUploadManagerContext::submittedBatches.pop_front();
+
+    (void)VulkanContext::device.waitForFences(batch.fence, true, std::numeric_limits<uint64_t>::max());
+    VulkanContext::device.resetFences(batch.fence);
+
+    // the batches are retired in order, so the ring is released up to the end of this one
+    VulkanUploadManagerContext::ringTail = batch.ringEnd;
+    VulkanUploadManagerContext::completedSerial = batch.serial;
+    for (const auto& [allocation, buffer] : batch.stagingBuffers) {
+        VulkanContext::device.destroyBuffer(buffer);
+        VulkanMemoryAllocator::free(allocation);
+    }
+    batch.stagingBuffers.clear();
+}
+
+} // namespace chronicle::internal::vulkan
@@ -0,0 +1,101 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "Renderer/Data/TextureInfo.h"
+#include "VulkanCommon.h"
+
+namespace chronicle::internal::vulkan {
+
+struct VulkanUploadBatch;
+
+/// @brief Image to upload.
+struct VulkanImageUpload {
+    vk::Image image {}; ///< Destination image, in undefined layout.
+    vk::Format format { vk::Format::eUndefined }; ///< Image format.
+    uint32_t width { 0 }; ///< Image width.
+    uint32_t height { 0 }; ///< Image height.
+    uint32_t mipLevels { 1 }; ///< Image mip levels.
+    std::span<const TextureMipLevel> mipLevelsData {}; ///< Pre-baked mip levels, empty if only the first is in data.
+    bool generateMipmaps { false }; ///< Generate the other mip levels from the first one.
+    std::span<const uint8_t> data {}; ///< Image data.
+};
+
+/// @brief Uploads the buffers and the images through a persistently mapped staging ring.
+///        The copies are recorded in a batch command buffer, that is submitted before the next frame (or when the
+///        ring is full) and retired with a fence, so creating a resource never waits for the GPU to be idle.
+///        When the device has a transfer only queue family the copies run there, and the resources are handed to
+///        the graphics queue with queue family ownership transfers.
+class VulkanUploadManager {
+public:
+    /// @brief Create the staging ring and the batches.
+    static void init();
+
+    /// @brief Submit the pending copies, wait for them and destroy the staging ring.
+    static void deinit();
+
+    /// @brief Copy data into a device local buffer.
+    ///        Only the destination range is handed to the graphics queue, so the rest of the buffer can be in use.
+    /// @param dstBuffer Destination buffer, with the transfer destination usage.
+    /// @param data Data to copy.
+    /// @param dstOffset Offset of the data in the destination buffer.
+    /// @return Completion fence of the upload.
+    static uint64_t uploadBuffer(vk::Buffer dstBuffer, std::span<const uint8_t> data, vk::DeviceSize dstOffset = 0);
+
+    /// @brief Copy data into an image and transition it for the shader reads.
+    ///        The transitions, the copies and the mipmaps of all the images in a batch are recorded together on
+    ///        submit, so the barriers of the images are merged.
+    /// @param upload Image to upload.
+    /// @return Completion fence of the upload.
+    static uint64_t uploadImage(const VulkanImageUpload& upload);
+
+    /// @brief Check if an upload is completed on the GPU.
+    /// @param fence Completion fence of the upload.
+    /// @return True if the upload is completed.
+    [[nodiscard]] static bool isCompleted(uint64_t fence);
+
+    /// @brief Wait for an upload, it's submitted if it's still recording.
+    /// @param fence Completion fence of the upload.
+    static void wait(uint64_t fence);
+
+    /// @brief Submit the recorded copies, must be called before the submit of the commands that use the resources.
+    static void flush();
+
+private:
+    /// @brief Copy data into the staging ring.
+    /// @param data Data to copy.
+    /// @return Staging buffer and offset of the data.
+    [[nodiscard]] static std::pair<vk::Buffer, vk::DeviceSize> stage(std::span<const uint8_t> data);
+
+    /// @brief Get the command buffer of the current batch, recording started.
+    /// @return Command buffer.
+    [[nodiscard]] static vk::CommandBuffer beginBatch();
+
+    /// @brief Record the commands of the pending images in the current batch.
+    static void recordImages();
+
+    /// @brief Retire the batches completed by the GPU, without waiting.
+    static void retireCompletedBatches();
+
+    /// @brief Submit the current batch, if it's recording.
+    static void submitBatch();
+
+    /// @brief Move to the next batch, after the submit of the current one.
+    static void finishBatch();
+
+    /// @brief Get the current batch.
+    /// @return Current batch.
+    [[nodiscard]] static VulkanUploadBatch& currentBatch();
+
+    /// @brief Check if the copies run on a transfer only queue.
+    /// @return True if the resources need the ownership transfers.
+    [[nodiscard]] static bool dedicatedTransfer();
+
+    /// @brief Wait the oldest submitted batch and release its staging data.
+    static void retireBatch();
+};
+
+} // namespace chronicle::internal::vulkan
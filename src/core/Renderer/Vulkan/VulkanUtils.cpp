@@ -4,6 +4,7 @@
 #include "VulkanUtils.h"
 
 #include "VulkanCommon.h"
+#include "VulkanEnums.h"
 #include "VulkanExtensions.h"
 
 #ifdef GLFW_PLATFORM
@@ -12,7 +13,7 @@
 
 namespace chronicle::internal::vulkan {
 
-std::pair<vk::DeviceMemory, vk::Image> VulkanUtils::createImage(uint32_t width, uint32_t height, uint32_t mipLevels,
+std::pair<VulkanAllocation, vk::Image> VulkanUtils::createImage(uint32_t width, uint32_t height, uint32_t mipLevels,
     vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage,
     vk::MemoryPropertyFlags properties)
 {
@@ -48,17 +49,14 @@ std::pair<vk::DeviceMemory, vk::Image> VulkanUtils::createImage(uint32_t width,
 
     // allocate memory
     const auto memRequirements = VulkanContext::device.getImageMemoryRequirements(image);
-    vk::MemoryAllocateInfo allocInfo = {};
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.setAllocationSize(memRequirements.size);
-    allocInfo.setMemoryTypeIndex(findMemoryType(memRequirements.memoryTypeBits, properties));
-    auto imageMemory = VulkanContext::device.allocateMemory(allocInfo, nullptr);
+    auto imageAllocation
+        = VulkanMemoryAllocator::allocate(memRequirements, properties, tiling == vk::ImageTiling::eLinear);
 
     // bind image memory
-    vkBindImageMemory(VulkanContext::device, image, imageMemory, 0);
+    VulkanContext::device.bindImageMemory(image, imageAllocation.memory, imageAllocation.offset);
 
     // return data
-    return { imageMemory, image };
+    return { imageAllocation, image };
 }
 
 vk::ImageView VulkanUtils::createImageView(
@@ -89,7 +87,7 @@ vk::ImageView VulkanUtils::createImageView(
     return VulkanContext::device.createImageView(viewInfo);
 }
 
-vk::Sampler VulkanUtils::createTextureSampler(uint32_t mipLevels)
+vk::Sampler VulkanUtils::createTextureSampler(uint32_t mipLevels, const SamplerInfo& sampler)
 {
     CHRZONE_RENDERER;
 
@@ -100,25 +98,25 @@ vk::Sampler VulkanUtils::createTextureSampler(uint32_t mipLevels)
 
     // create sampler
     vk::SamplerCreateInfo samplerInfo = {};
-    samplerInfo.setMagFilter(vk::Filter::eLinear);
-    samplerInfo.setMinFilter(vk::Filter::eLinear);
-    samplerInfo.setAddressModeU(vk::SamplerAddressMode::eRepeat);
-    samplerInfo.setAddressModeV(vk::SamplerAddressMode::eRepeat);
-    samplerInfo.setAddressModeW(vk::SamplerAddressMode::eRepeat);
+    samplerInfo.setMagFilter(VulkanEnums::filterToVulkan(sampler.magFilter));
+    samplerInfo.setMinFilter(VulkanEnums::filterToVulkan(sampler.minFilter));
+    samplerInfo.setAddressModeU(VulkanEnums::samplerAddressModeToVulkan(sampler.addressModeU));
+    samplerInfo.setAddressModeV(VulkanEnums::samplerAddressModeToVulkan(sampler.addressModeV));
+    samplerInfo.setAddressModeW(VulkanEnums::samplerAddressModeToVulkan(sampler.addressModeU));
     samplerInfo.setAnisotropyEnable(true);
     samplerInfo.setMaxAnisotropy(properties.limits.maxSamplerAnisotropy);
     samplerInfo.setBorderColor(vk::BorderColor::eIntOpaqueBlack);
     samplerInfo.setUnnormalizedCoordinates(false);
     samplerInfo.setCompareEnable(false);
     samplerInfo.setCompareOp(vk::CompareOp::eAlways);
-    samplerInfo.setMipmapMode(vk::SamplerMipmapMode::eLinear);
+    samplerInfo.setMipmapMode(VulkanEnums::samplerMipmapModeToVulkan(sampler.mipmapMode));
     samplerInfo.setMipLodBias(0.0f);
     samplerInfo.setMinLod(0.0f);
-    samplerInfo.setMaxLod(static_cast<float>(mipLevels));
+    samplerInfo.setMaxLod(sampler.mipmaps ? static_cast<float>(mipLevels) : 0.0f);
     return VulkanContext::device.createSampler(samplerInfo);
 }
 
-std::pair<vk::DeviceMemory, vk::Buffer> VulkanUtils::createBuffer(
+std::pair<VulkanAllocation, vk::Buffer> VulkanUtils::createBuffer(
     vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties)
 {
     CHRZONE_RENDERER;
@@ -141,88 +139,82 @@ std::pair<vk::DeviceMemory, vk::Buffer> VulkanUtils::createBuffer(
     auto memRequirements = VulkanContext::device.getBufferMemoryRequirements(buffer);
 
     // allocate memory
-    vk::MemoryAllocateInfo allocInfo = {};
-    allocInfo.setAllocationSize(memRequirements.size);
-    allocInfo.setMemoryTypeIndex(findMemoryType(memRequirements.memoryTypeBits, properties));
-    auto bufferMemory = VulkanContext::device.allocateMemory(allocInfo);
+    auto bufferAllocation = VulkanMemoryAllocator::allocate(memRequirements, properties, true);
 
     // bind buffer memory
-    VulkanContext::device.bindBufferMemory(buffer, bufferMemory, 0);
+    VulkanContext::device.bindBufferMemory(buffer, bufferAllocation.memory, bufferAllocation.offset);
 
     // return data
-    return std::pair<vk::DeviceMemory, vk::Buffer>(bufferMemory, buffer);
+    return std::pair<VulkanAllocation, vk::Buffer>(bufferAllocation, buffer);
 }
 
-void VulkanUtils::copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size)
+void VulkanUtils::copyBuffer(vk::CommandBuffer commandBuffer, vk::Buffer srcBuffer, vk::DeviceSize srcOffset,
+    vk::Buffer dstBuffer, vk::DeviceSize dstOffset, vk::DeviceSize size)
 {
     CHRZONE_RENDERER;
 
+    assert(commandBuffer);
     assert(size > 0);
     assert(srcBuffer);
     assert(dstBuffer);
 
     CHRLOG_TRACE("Copying Vulkan buffer: size={}", size);
 
-    // begin single time command buffer
-    auto commandBuffer = beginSingleTimeCommands();
-
     // copy buffer
     vk::BufferCopy copyRegion = {};
+    copyRegion.setSrcOffset(srcOffset);
+    copyRegion.setDstOffset(dstOffset);
     copyRegion.setSize(size);
     commandBuffer.copyBuffer(srcBuffer, dstBuffer, copyRegion);
-
-    // end single time command buffer
-    endSingleTimeCommands(commandBuffer);
 }
 
-void VulkanUtils::copyBufferToImage(vk::Buffer srcBuffer, vk::Image dstImage, uint32_t width, uint32_t height)
+void VulkanUtils::copyBufferToImage(vk::CommandBuffer commandBuffer, vk::Buffer srcBuffer, vk::DeviceSize srcOffset,
+    vk::Image dstImage, uint32_t width, uint32_t height, std::span<const TextureMipLevel> mipLevels)
 {
     CHRZONE_RENDERER;
 
+    assert(commandBuffer);
     assert(width > 0);
     assert(height > 0);
     assert(srcBuffer);
     assert(dstImage);
 
-    CHRLOG_TRACE("Copying Vulkan buffer to image: size={}x{}", width, height);
-
-    // begin single time command buffer
-    auto commandBuffer = beginSingleTimeCommands();
-
-    // image subresource layers
-    vk::ImageSubresourceLayers subresourceLayers = {};
-    subresourceLayers.setAspectMask(vk::ImageAspectFlagBits::eColor);
-    subresourceLayers.setMipLevel(0);
-    subresourceLayers.setBaseArrayLayer(0);
-    subresourceLayers.setLayerCount(1);
+    CHRLOG_TRACE("Copying Vulkan buffer to image: size={}x{}, mip levels={}", width, height, mipLevels.size());
+
+    // a region for every mip level, the levels are tightly packed
+    std::vector<vk::BufferImageCopy> regions(std::max<size_t>(mipLevels.size(), 1));
+    for (uint32_t level = 0; level < regions.size(); level++) {
+        // image subresource layers
+        vk::ImageSubresourceLayers subresourceLayers = {};
+        subresourceLayers.setAspectMask(vk::ImageAspectFlagBits::eColor);
+        subresourceLayers.setMipLevel(level);
+        subresourceLayers.setBaseArrayLayer(0);
+        subresourceLayers.setLayerCount(1);
+
+        auto& region = regions[level];
+        region.setBufferOffset(srcOffset + (mipLevels.empty() ? 0 : mipLevels[level].offset));
+        region.setBufferRowLength(0);
+        region.setBufferImageHeight(0);
+        region.setImageSubresource(subresourceLayers);
+        region.setImageOffset({ 0, 0, 0 });
+        region.setImageExtent({ std::max(width >> level, 1u), std::max(height >> level, 1u), 1 });
+    }
 
     // copy buffer to image
-    vk::BufferImageCopy region = {};
-    region.setBufferOffset(0);
-    region.setBufferRowLength(0);
-    region.setBufferImageHeight(0);
-    region.setImageSubresource(subresourceLayers);
-    region.setImageOffset({ 0, 0, 0 });
-    region.setImageExtent({ width, height, 1 });
-    commandBuffer.copyBufferToImage(srcBuffer, dstImage, vk::ImageLayout::eTransferDstOptimal, region);
-
-    // end single time command buffer
-    endSingleTimeCommands(commandBuffer);
+    commandBuffer.copyBufferToImage(srcBuffer, dstImage, vk::ImageLayout::eTransferDstOptimal, regions);
 }
 
-void VulkanUtils::transitionImageLayout(
-    vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, uint32_t mipLevels)
+void VulkanUtils::transitionImageLayout(vk::CommandBuffer commandBuffer, vk::Image image, vk::ImageLayout oldLayout,
+    vk::ImageLayout newLayout, uint32_t mipLevels)
 {
     CHRZONE_RENDERER;
 
+    assert(commandBuffer);
     assert(image);
 
     CHRLOG_TRACE("Transitioning Vulkan image layout: from={}, to={}, mip levels={}", vk::to_string(oldLayout),
         vk::to_string(newLayout), mipLevels);
 
-    // begin single time command buffer
-    vk::CommandBuffer commandBuffer = beginSingleTimeCommands();
-
     // image subresource range
     vk::ImageSubresourceRange subresourceRange = {};
     subresourceRange.setAspectMask(vk::ImageAspectFlagBits::eColor);
@@ -262,16 +254,14 @@ void VulkanUtils::transitionImageLayout(
 
     // create pipeline barrier
     commandBuffer.pipelineBarrier(sourceStage, destinationStage, vk::DependencyFlags(), nullptr, nullptr, barrier);
-
-    // end single time command buffer
-    endSingleTimeCommands(commandBuffer);
 }
 
-void VulkanUtils::generateMipmaps(
-    vk::Image image, vk::Format format, uint32_t width, uint32_t height, uint32_t mipLevels)
+void VulkanUtils::generateMipmaps(vk::CommandBuffer commandBuffer, vk::Image image, vk::Format format, uint32_t width,
+    uint32_t height, uint32_t mipLevels)
 {
     CHRZONE_RENDERER;
 
+    assert(commandBuffer);
     assert(image);
 
     CHRLOG_TRACE("Generating Vulkan mipmaps: size={}x{}, format={}, mip levels={}", width, height,
@@ -283,9 +273,6 @@ void VulkanUtils::generateMipmaps(
         throw RendererError("Texture image format does not support linear blitting");
     }
 
-    // begin single time command buffer
-    auto commandBuffer = beginSingleTimeCommands();
-
     // image subresource range
     vk::ImageSubresourceRange subresource = {};
     subresource.setAspectMask(vk::ImageAspectFlagBits::eColor);
@@ -356,9 +343,6 @@ void VulkanUtils::generateMipmaps(
     barrier.setDstAccessMask(vk::AccessFlagBits::eShaderRead);
     commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
         vk::DependencyFlags(), nullptr, nullptr, barrier);
-
-    // end single time command buffer
-    endSingleTimeCommands(commandBuffer);
 }
 
 uint32_t VulkanUtils::findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties)
@@ -550,6 +534,16 @@ VulkanQueueFamilyIndices VulkanUtils::findQueueFamilies(vk::PhysicalDevice physi
         i++;
     }
 
+    // a transfer only family runs on the DMA engine, so the uploads overlap the rendering
+    for (uint32_t family = 0; family < queueFamilies.size(); family++) {
+        const auto& queueFamily = queueFamilies[family];
+        if (queueFamily.queueCount > 0 && queueFamily.queueFlags & vk::QueueFlagBits::eTransfer
+            && !(queueFamily.queueFlags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+            indices.transferFamily = family;
+            break;
+        }
+    }
+
     // return data
     return indices;
 }
@@ -5,14 +5,16 @@
 
 #include "pch.h"
 
+#include "Renderer/Data/TextureInfo.h"
 #include "VulkanCommon.h"
+#include "VulkanMemoryAllocator.h"
 
 namespace chronicle::internal::vulkan {
 
 /// @brief Vulkan utilities.
 class VulkanUtils {
 public:
-    /// @brief Create an image and allocate his memory.
+    /// @brief Create an image and allocate his memory from @ref VulkanMemoryAllocator.
     /// @param width Image width.
     /// @param height Image height.
     /// @param mipLevels Mip levels.
@@ -21,8 +23,8 @@ public:
     /// @param tiling Image tiling.
     /// @param usage Image usage flags.
     /// @param properties Memory properties.
-    /// @return A pair with an image and a device memory.
-    [[nodiscard]] static std::pair<vk::DeviceMemory, vk::Image> createImage(uint32_t width, uint32_t height,
+    /// @return A pair with an image and its memory allocation.
+    [[nodiscard]] static std::pair<VulkanAllocation, vk::Image> createImage(uint32_t width, uint32_t height,
         uint32_t mipLevels, vk::SampleCountFlagBits numSamples, vk::Format format, vk::ImageTiling tiling,
         vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties);
 
@@ -37,46 +39,57 @@ public:
 
     /// @brief Create a texture sampler.
     /// @param mipLevels Mip levels.
+    /// @param sampler Sampler state.
     /// @return Texture sampler.
-    [[nodiscard]] static vk::Sampler createTextureSampler(uint32_t mipLevels);
+    [[nodiscard]] static vk::Sampler createTextureSampler(uint32_t mipLevels, const SamplerInfo& sampler = {});
 
-    /// @brief Create a buffer.
+    /// @brief Create a buffer and allocate its memory from @ref VulkanMemoryAllocator.
     /// @param size Buffer size.
     /// @param usage Buffer usage flags.
     /// @param properties Memory property flags.
-    /// @return A pair with a buffer and a device memory.
-    static std::pair<vk::DeviceMemory, vk::Buffer> createBuffer(
+    /// @return A pair with a buffer and its memory allocation, mapped if the memory is host visible.
+    static std::pair<VulkanAllocation, vk::Buffer> createBuffer(
         vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties);
 
-    /// @brief Copy one buffer into another.
+    /// @brief Record the copy of one buffer into another.
+    /// @param commandBuffer Command buffer.
     /// @param srcBuffer Source buffer.
+    /// @param srcOffset Offset in the source buffer.
     /// @param dstBuffer Destination buffer.
+    /// @param dstOffset Offset in the destination buffer.
     /// @param size Size to copy.
-    static void copyBuffer(vk::Buffer srcBuffer, vk::Buffer dstBuffer, vk::DeviceSize size);
+    static void copyBuffer(vk::CommandBuffer commandBuffer, vk::Buffer srcBuffer, vk::DeviceSize srcOffset,
+        vk::Buffer dstBuffer, vk::DeviceSize dstOffset, vk::DeviceSize size);
 
-    /// @brief Copy a buffer into an image.
+    /// @brief Record the copy of a buffer into an image.
+    /// @param commandBuffer Command buffer.
     /// @param srcBuffer Source buffer.
+    /// @param srcOffset Offset of the image data in the source buffer.
     /// @param dstImage Destination image.
     /// @param width Image width.
     /// @param height Image height.
-    static void copyBufferToImage(vk::Buffer srcBuffer, vk::Image dstImage, uint32_t width, uint32_t height);
+    /// @param mipLevels Mip levels in the buffer, if empty only the first level is copied from the buffer start.
+    static void copyBufferToImage(vk::CommandBuffer commandBuffer, vk::Buffer srcBuffer, vk::DeviceSize srcOffset,
+        vk::Image dstImage, uint32_t width, uint32_t height, std::span<const TextureMipLevel> mipLevels = {});
 
-    /// @brief Transition the layout of an image.
+    /// @brief Record the layout transition of an image.
+    /// @param commandBuffer Command buffer.
     /// @param image Image.
     /// @param oldLayout Old layout.
     /// @param newLayout New layout.
     /// @param mipLevels Mip levels.
-    static void transitionImageLayout(
-        vk::Image image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, uint32_t mipLevels);
+    static void transitionImageLayout(vk::CommandBuffer commandBuffer, vk::Image image, vk::ImageLayout oldLayout,
+        vk::ImageLayout newLayout, uint32_t mipLevels);
 
-    /// @brief Generate mipmaps for an image.
+    /// @brief Record the mipmaps generation for an image.
+    /// @param commandBuffer Command buffer.
     /// @param image Image.
     /// @param format Image format.
     /// @param width Image width.
     /// @param height Image height.
     /// @param mipLevels Mip levels.
-    static void generateMipmaps(
-        vk::Image image, vk::Format format, uint32_t width, uint32_t height, uint32_t mipLevels);
+    static void generateMipmaps(vk::CommandBuffer commandBuffer, vk::Image image, vk::Format format, uint32_t width,
+        uint32_t height, uint32_t mipLevels);
 
     /// @brief Find memory type.
     /// @param typeFilter Type filter.
@@ -5,6 +5,7 @@
 
 #include "VulkanGC.h"
 #include "VulkanInstance.h"
+#include "VulkanUploadManager.h"
 #include "VulkanUtils.h"
 
 namespace chronicle::internal::vulkan {
@@ -21,37 +22,20 @@ VulkanVertexBuffer::VulkanVertexBuffer(const uint8_t* src, size_t size, const st
 
     CHRLOG_TRACE("Set vertex buffer data: size={}", size);
 
-    // create a buffer visible to the host
-    vk::DeviceSize bufferSize = size;
-    auto [stagingBufferMemory, stagingBuffer]
-        = VulkanUtils::createBuffer(bufferSize, vk::BufferUsageFlagBits::eTransferSrc,
-            vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
-
-    assert(stagingBuffer);
-    assert(stagingBufferMemory);
-
-    // copy data to buffer
-    void* dst = VulkanContext::device.mapMemory(stagingBufferMemory, 0, bufferSize);
-    memcpy(dst, src, bufferSize);
-    VulkanContext::device.unmapMemory(stagingBufferMemory);
-
     // create a buffer visible only from the GPU
-    auto [bufferMemory, buffer] = VulkanUtils::createBuffer(bufferSize,
+    vk::DeviceSize bufferSize = size;
+    auto [bufferAllocation, buffer] = VulkanUtils::createBuffer(bufferSize,
         vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eVertexBuffer,
         vk::MemoryPropertyFlagBits::eDeviceLocal);
 
     assert(buffer);
-    assert(bufferMemory);
+    assert(bufferAllocation);
 
     _buffer = buffer;
-    _bufferMemory = bufferMemory;
-
-    // copy data from local visible buffer to GPU visible buffer
-    VulkanUtils::copyBuffer(stagingBuffer, _buffer, bufferSize);
+    _bufferAllocation = bufferAllocation;
 
-    // destroy local visible buffer
-    VulkanContext::device.destroyBuffer(stagingBuffer);
-    VulkanContext::device.freeMemory(stagingBufferMemory);
+    // the copy goes through the staging ring, it's submitted before the next frame
+    VulkanUploadManager::uploadBuffer(_buffer, std::span(src, size));
 
 #ifdef VULKAN_ENABLE_DEBUG_MARKER
     VulkanUtils::setDebugObjectName(_buffer, _name);
@@ -66,7 +50,7 @@ VulkanVertexBuffer::~VulkanVertexBuffer()
 
     // destroy buffer and free memory
     VulkanGC::add(_buffer);
-    VulkanGC::add(_bufferMemory);
+    VulkanGC::add(_bufferAllocation);
 }
 
 VertexBufferRef VulkanVertexBuffer::create(const std::vector<uint8_t>& data, const std::string& name)
@@ -1,5 +1,10 @@
 #version 450 core
 
+// variants precompiled by chronicle-shadercook
+#pragma variant:QUANTIZED_VERTICES
+#pragma variant:HAS_TEXCOORD1
+#pragma variant:HAS_COLOR0
+
 #pragma stage:all
 
 struct VertexOutput
@@ -12,11 +17,22 @@ struct VertexOutput
 #pragma stage:vertex
 
 // inputs
+#ifdef QUANTIZED_VERTICES
+layout(location = 0) in vec4 a_Position; // unorm16, dequantized with the push constants
+layout(location = 1) in vec2 a_Normal; // octahedral snorm16
+#else
 layout(location = 0) in vec3 a_Position;
 layout(location = 1) in vec3 a_Normal;
+#endif
 layout(location = 2) in vec2 a_TexCoord0;
+#ifdef HAS_TEXCOORD1
 layout(location = 3) in vec2 a_TexCoord1;
-layout(location = 4) in vec2 a_Color;
+#endif
+#ifdef HAS_COLOR0
+layout(location = 4) in vec4 a_Color;
+#endif
+layout(location = 8) in mat4 a_InstanceTransform; // per instance, locations 8-11
+layout(location = 12) in mat3 a_InstanceNormalTransform; // per instance inverse transpose, locations 12-14
 
 // outputs
 layout(location = 0) out VertexOutput vertexOutput;
@@ -28,13 +44,38 @@ layout(binding = 0) uniform UniformBufferObject {
     mat4 modelMatrix;
     mat4 viewMatrix;
     mat4 projectionMatrix;
+    mat4 normalModelMatrix; // inverse transpose of the model matrix
 } ubo;
 
+#ifdef QUANTIZED_VERTICES
+layout(push_constant) uniform VertexDequantization {
+    vec4 positionOffset;
+    vec4 positionScale;
+} dequantization;
+
+vec3 decodeOctahedral(vec2 encoded)
+{
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = max(-normal.z, 0.0);
+    normal.xy += vec2(normal.x >= 0.0 ? -t : t, normal.y >= 0.0 ? -t : t);
+    return normalize(normal);
+}
+#endif
+
 void main()
 {
+#ifdef QUANTIZED_VERTICES
+    vec3 position = dequantization.positionOffset.xyz + a_Position.xyz * dequantization.positionScale.xyz;
+    vec3 normal = decodeOctahedral(a_Normal);
+#else
+    vec3 position = a_Position;
+    vec3 normal = a_Normal;
+#endif
+
     vertexOutput.texCoord0 = a_TexCoord0;
-    vertexOutput.normal = a_Normal;
-    gl_Position = ubo.projectionMatrix * ubo.viewMatrix * ubo.modelMatrix * vec4(a_Position, 1.0);
+    // the inverse transpose of (model * instance) is the product of the two inverse transposes
+    vertexOutput.normal = normalize(mat3(ubo.normalModelMatrix) * a_InstanceNormalTransform * normal);
+    gl_Position = ubo.projectionMatrix * ubo.viewMatrix * ubo.modelMatrix * a_InstanceTransform * vec4(position, 1.0);
 }
 
 #pragma stage:fragment
@@ -56,42 +97,33 @@ layout(binding = 0, set = 1) uniform MaterialBufferObject {
     bool doubleSided;
 } materialUbo;
 
-#ifdef HAS_BASE_COLOR_TEXTURE
-layout(binding = 1, set = 1) uniform sampler2D baseColorTexSampler;
-#endif
+// textures, the missing ones are bound to a default texture and disabled by the specialization constants
+layout(constant_id = 0) const bool HAS_BASE_COLOR_TEXTURE = false;
+layout(constant_id = 1) const bool HAS_METALLIC_ROUGHNESS_TEXTURE = false;
+layout(constant_id = 2) const bool HAS_NORMAL_TEXTURE = false;
+layout(constant_id = 3) const bool HAS_OCCLUSION_TEXTURE = false;
+layout(constant_id = 4) const bool HAS_EMISSIVE_TEXTURE = false;
 
-#ifdef HAS_METALLIC_ROUGHNESS_TEXTURE
+layout(binding = 1, set = 1) uniform sampler2D baseColorTexSampler;
 layout(binding = 2, set = 1) uniform sampler2D metallicRoughnessSampler;
-#endif
-
-#ifdef HAS_NORMAL_TEXTURE
-layout(binding = 3, set = 1) uniform sampler2D normalSampler; 
-#endif
-
-#ifdef HAS_OCCLUSION_TEXTURE
+layout(binding = 3, set = 1) uniform sampler2D normalSampler;
 layout(binding = 4, set = 1) uniform sampler2D occlusionSampler;
-#endif
-
-#ifdef HAS_EMISSIVE_TEXTURE
 layout(binding = 5, set = 1) uniform sampler2D emissiveSampler;
-#endif
 
 vec4 getBaseColor(vec2 texCoord)
 {
-#ifdef HAS_BASE_COLOR_TEXTURE
-    return texture(baseColorTexSampler, texCoord);
-#else
+    if (HAS_BASE_COLOR_TEXTURE) {
+        return texture(baseColorTexSampler, texCoord);
+    }
     return vec4(1.0f);
-#endif
 }
 
 vec4 getNormal(vec2 texCoord)
 {
-#ifdef HAS_NORMAL_TEXTURE
-    return texture(normalSampler, texCoord);
-#else
+    if (HAS_NORMAL_TEXTURE) {
+        return texture(normalSampler, texCoord);
+    }
     return vec4(1.0f);
-#endif
 }
 
 void main() {
@@ -0,0 +1,115 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "MappedFile.h"
+
+#ifdef CHRPLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace chronicle {
+
+CHR_CONCRETE(MappedFile);
+
+#ifdef CHRPLATFORM_WINDOWS
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    CHRZONE_STORAGE;
+
+    auto fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        throw StorageError(fmt::format("Failed to open file {}", path.string()));
+    _fileHandle = fileHandle;
+
+    LARGE_INTEGER fileSize {};
+    if (!GetFileSizeEx(fileHandle, &fileSize)) {
+        CloseHandle(fileHandle);
+        throw StorageError(fmt::format("Failed to get the size of file {}", path.string()));
+    }
+    _size = static_cast<size_t>(fileSize.QuadPart);
+
+    // empty files can't be mapped
+    if (_size == 0)
+        return;
+
+    _mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mappingHandle == nullptr) {
+        CloseHandle(fileHandle);
+        throw StorageError(fmt::format("Failed to create the mapping for file {}", path.string()));
+    }
+
+    _data = static_cast<const uint8_t*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (_data == nullptr) {
+        CloseHandle(_mappingHandle);
+        CloseHandle(fileHandle);
+        throw StorageError(fmt::format("Failed to map file {}", path.string()));
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    CHRZONE_STORAGE;
+
+    if (_data != nullptr)
+        UnmapViewOfFile(_data);
+    if (_mappingHandle != nullptr)
+        CloseHandle(_mappingHandle);
+    if (_fileHandle != nullptr)
+        CloseHandle(_fileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    CHRZONE_STORAGE;
+
+    auto fileDescriptor = ::open(path.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+        throw StorageError(fmt::format("Failed to open file {}", path.string()));
+
+    struct stat fileStat { };
+    if (fstat(fileDescriptor, &fileStat) != 0) {
+        ::close(fileDescriptor);
+        throw StorageError(fmt::format("Failed to get the size of file {}", path.string()));
+    }
+    _size = static_cast<size_t>(fileStat.st_size);
+
+    // empty files can't be mapped
+    if (_size == 0) {
+        ::close(fileDescriptor);
+        return;
+    }
+
+    // the mapping stay valid after the file descriptor is closed
+    auto* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    ::close(fileDescriptor);
+    if (data == MAP_FAILED)
+        throw StorageError(fmt::format("Failed to map file {}", path.string()));
+
+    madvise(data, _size, MADV_SEQUENTIAL);
+    _data = static_cast<const uint8_t*>(data);
+}
+
+MappedFile::~MappedFile()
+{
+    CHRZONE_STORAGE;
+
+    if (_data != nullptr)
+        munmap(const_cast<uint8_t*>(_data), _size);
+}
+
+#endif
+
+MappedFileRef MappedFile::open(const std::filesystem::path& path) { return std::make_shared<ConcreteMappedFile>(path); }
+
+} // namespace chronicle
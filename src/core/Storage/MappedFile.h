@@ -0,0 +1,53 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+#include "Common.h"
+
+namespace chronicle {
+
+class MappedFile;
+using MappedFileRef = std::shared_ptr<MappedFile>;
+
+/// @brief Read only memory mapping of a file.
+class MappedFile : private NonCopyable<MappedFile> {
+protected:
+    /// @brief Default constructor.
+    /// @param path File path.
+    explicit MappedFile(const std::filesystem::path& path);
+
+public:
+    /// @brief Destructor.
+    ~MappedFile();
+
+    /// @brief Get the mapped data.
+    /// @return Pointer to the first byte of the file.
+    [[nodiscard]] const uint8_t* data() const { return _data; }
+
+    /// @brief Get the mapped data size.
+    /// @return File size.
+    [[nodiscard]] size_t size() const { return _size; }
+
+    /// @brief Get the mapped data as a span.
+    /// @return Span over the whole file.
+    [[nodiscard]] std::span<const uint8_t> span() const { return { _data, _size }; }
+
+    /// @brief Map a file in memory.
+    /// @param path File path.
+    /// @return The mapped file.
+    [[nodiscard]] static MappedFileRef open(const std::filesystem::path& path);
+
+private:
+    const uint8_t* _data { nullptr }; ///< Mapped data.
+    size_t _size { 0 }; ///< Mapped data size.
+
+#ifdef CHRPLATFORM_WINDOWS
+    void* _fileHandle { nullptr }; ///< File handle.
+    void* _mappingHandle { nullptr }; ///< File mapping handle.
+#endif
+};
+
+} // namespace chronicle
@@ -30,6 +30,8 @@ public:
     [[nodiscard]] float zFar() const { return _zFar; }
     void setZFar(float zFar) { _zFar = zFar; }
 
+    [[nodiscard]] glm::vec3 position() const { return _cameraPos; }
+
     [[nodiscard]] glm::mat4 view() const { return _view; }
     [[nodiscard]] glm::mat4 projection() const { return _projection; }
 
@@ -91,8 +91,8 @@ Scene::Scene(const std::string& name)
     _frameBuffer = FrameBuffer::create(frameBufferInfo, fmt::format("Frambuffer for scene {}", _name));
 
     // TODO: test to remove
-    auto test = AssetLoader::load("D:\\Progetti\\glTF-Sample-Models\\2.0\\Sponza\\glTF\\Sponza.gltf", _renderPass);
-    _mesh = test.meshes[0];
+    _assetLoad = AssetLoader::loadAsync(
+        "D:\\Progetti\\glTF-Sample-Models\\2.0\\Sponza\\glTF\\Sponza.gltf", _renderPass);
 }
 
 void Scene::render(CommandBufferRef commandBuffer)
@@ -121,31 +121,119 @@ void Scene::render(CommandBufferRef commandBuffer)
         _camera.recalculateProjection();
     }
 
-    // draw
-    commandBuffer->beginDebugLabel("Start draw scene", { 0.0f, 1.0f, 0.0f, 1.0f });
-    for (auto i = 0; i < _mesh->submeshCount(); i++) {
-        commandBuffer->bindPipeline(_mesh->pipeline(i)->pipelineId());
-        commandBuffer->bindVertexBuffers(_mesh->vertexBufferIds(i), _mesh->vertexBufferOffsets(i));
-        commandBuffer->bindIndexBuffer(_mesh->indexBufferId(i), _mesh->indexType(i));
-        commandBuffer->bindDescriptorSet(
-            RenderContext::descriptorSet()->descriptorSetId(), _mesh->pipeline(i)->pipelineLayoutId(), 0);
-        commandBuffer->bindDescriptorSet(
-            _mesh->material(i)->descriptorSet()->descriptorSetId(), _mesh->pipeline(i)->pipelineLayoutId(), 1);
-        commandBuffer->drawIndexed(_mesh->indicesCount(i), 1);
-    }
-    commandBuffer->endDebugLabel();
-
     // descriptor set
     _ubo.model = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+    _ubo.normalModel = glm::transpose(glm::inverse(_ubo.model));
     _ubo.view = _camera.view();
     _ubo.proj = _camera.projection();
 
-    RenderContext::descriptorSet()->setUniform<internal::vulkan::UniformBufferObject>("ubo"_hs, _ubo);
+    const auto& frameDescriptorSet = RenderContext::descriptorSet();
+    frameDescriptorSet->setUniform<internal::vulkan::UniformBufferObject>("ubo"_hs, _ubo);
+
+    // the geometry is in the pool buffers, they are bound again only when a range is in another page
+    GeometryBufferId boundVertexBuffer = {};
+    GeometryBufferId boundInstanceBuffer = {};
+    GeometryBufferId boundIndexBuffer = {};
+    IndexType boundIndexType = IndexType::undefined;
+
+    // draw the meshes already resident, every submesh with a single call for all the instances
+    commandBuffer->beginDebugLabel("Start draw scene", { 0.0f, 1.0f, 0.0f, 1.0f });
+    for (const auto& mesh : _assetLoad->result().meshes) {
+        // the meshes without valid primitives are not created
+        if (!mesh) {
+            continue;
+        }
+
+        const auto& instances = mesh->instancesRange();
+        for (uint32_t i = 0; i < mesh->submeshCount(); i++) {
+            // the pipelines are created in background, the submesh is skipped until its pipeline is ready
+            if (!mesh->pipeline(i)->ready()) {
+                continue;
+            }
+
+            const auto& vertices = mesh->vertices(i);
+            const auto& indices = mesh->indices(i);
+            auto materialDescriptorSet = mesh->material(i)->descriptorSet();
+
+            commandBuffer->bindPipeline(mesh->pipeline(i)->pipelineId());
+            if (vertices.bufferId != boundVertexBuffer || instances.bufferId != boundInstanceBuffer) {
+                commandBuffer->bindVertexBuffers({ vertices.bufferId, instances.bufferId }, { 0, 0 });
+                boundVertexBuffer = vertices.bufferId;
+                boundInstanceBuffer = instances.bufferId;
+            }
+            if (indices && (indices.bufferId != boundIndexBuffer || mesh->indexType(i) != boundIndexType)) {
+                commandBuffer->bindIndexBuffer(indices.bufferId, mesh->indexType(i));
+                boundIndexBuffer = indices.bufferId;
+                boundIndexType = mesh->indexType(i);
+            }
+            commandBuffer->bindDescriptorSet(frameDescriptorSet->descriptorSetId(),
+                mesh->pipeline(i)->pipelineLayoutId(), 0, frameDescriptorSet->dynamicOffsets());
+            commandBuffer->bindDescriptorSet(materialDescriptorSet->descriptorSetId(),
+                mesh->pipeline(i)->pipelineLayoutId(), 1, materialDescriptorSet->dynamicOffsets());
+            if (mesh->quantized(i)) {
+                const auto& dequantization = mesh->dequantization(i);
+                commandBuffer->pushConstants(mesh->pipeline(i)->pipelineLayoutId(), ShaderStage::vertex, 0,
+                    sizeof(VertexDequantization), &dequantization);
+            }
+
+            // the non-indexed submeshes don't have levels of detail
+            if (!indices) {
+                commandBuffer->draw(mesh->verticesCount(i), mesh->instancesCount(), vertices.first, instances.first);
+                continue;
+            }
+
+            const auto& lod = selectLod(mesh, i);
+            commandBuffer->drawIndexed(lod.indicesCount, mesh->instancesCount(), indices.first + lod.firstIndex,
+                static_cast<int32_t>(vertices.first), instances.first);
+        }
+    }
+    commandBuffer->endDebugLabel();
 
     // end
     commandBuffer->endRenderPass();
 }
 
+const SubmeshLod& Scene::selectLod(const MeshRef& mesh, uint32_t submeshIndex) const
+{
+    const auto& lods = mesh->lods(submeshIndex);
+    assert(!lods.empty());
+
+    // the instances share the draw call, so the level is the finest required by one of them
+    auto lodIndex = static_cast<uint32_t>(lods.size() - 1);
+    for (const auto& instance : mesh->instances()) {
+        lodIndex = std::min(lodIndex, selectLodIndex(mesh, submeshIndex, _ubo.model * instance));
+        if (lodIndex == 0) {
+            break;
+        }
+    }
+    return lods[lodIndex];
+}
+
+uint32_t Scene::selectLodIndex(const MeshRef& mesh, uint32_t submeshIndex, const glm::mat4& model) const
+{
+    const auto& lods = mesh->lods(submeshIndex);
+
+    // bounding sphere in world space, the error is scaled like the largest axis
+    const auto& boundingBox = mesh->boundingBox(submeshIndex);
+    auto center = glm::vec3(model * glm::vec4((boundingBox.min + boundingBox.max) * 0.5f, 1.0f));
+    auto scale = std::max({ glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])),
+        glm::length(glm::vec3(model[2])) });
+    auto radius = glm::length(boundingBox.max - boundingBox.min) * 0.5f * scale;
+    auto distance = std::max(glm::distance(_camera.position(), center) - radius, _camera.zNear());
+
+    // pixels covered by a unit length at the distance of the closest point of the sphere
+    auto pixelsPerUnit
+        = static_cast<float>(_height) / (2.0f * distance * std::tan(glm::radians(_camera.fov()) * 0.5f));
+
+    // the coarsest level with an error not visible
+    for (auto lodIndex = static_cast<uint32_t>(lods.size() - 1); lodIndex > 0; lodIndex--) {
+        if (lods[lodIndex].error * scale * pixelsPerUnit <= _lodErrorThreshold) {
+            return lodIndex;
+        }
+    }
+    return 0;
+}
+
 SceneRef Scene::create(const std::string& name)
 {
     CHRZONE_SCENE;
@@ -32,6 +32,9 @@ public:
     //}
 
 private:
+    [[nodiscard]] const SubmeshLod& selectLod(const MeshRef& mesh, uint32_t submeshIndex) const;
+    [[nodiscard]] uint32_t selectLodIndex(const MeshRef& mesh, uint32_t submeshIndex, const glm::mat4& model) const;
+
     std::string _name = {};
     // std::vector<CommandBufferRef> _commandBuffers = {};
 
@@ -47,9 +50,12 @@ private:
     RenderPassRef _renderPass = {};
     FrameBufferRef _frameBuffer = {};
 
-    MeshRef _mesh = {};
+    AssetLoadHandleRef _assetLoad = {};
     internal::vulkan::UniformBufferObject _ubo {};
     Camera _camera;
+
+    // maximum screen space error of the levels of detail, in pixels
+    float _lodErrorThreshold = 1.0f;
 };
 
 } // namespace chronicle
\ No newline at end of file
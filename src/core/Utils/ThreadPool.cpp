@@ -0,0 +1,105 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "ThreadPool.h"
+
+namespace chronicle {
+
+/// @brief Pool that owns the calling thread, null if it's not a worker thread.
+static thread_local const ThreadPool* currentPool = nullptr;
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    _workers.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        _workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _condition.notify_all();
+
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& job)
+{
+    if (count == 0) {
+        return;
+    }
+
+    // a worker waiting for the chunks of its own pool can deadlock it, so the jobs are executed inline
+    if (currentPool == this) {
+        for (size_t i = 0; i < count; i++) {
+            job(i);
+        }
+        return;
+    }
+
+    // split the range in a few chunks for every worker, so the jobs with different costs are balanced
+    auto chunksCount = std::min(count, static_cast<size_t>(_workers.size()) * 4);
+    auto chunkSize = (count + chunksCount - 1) / chunksCount;
+
+    std::vector<std::future<void>> futures {};
+    futures.reserve(chunksCount);
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        auto end = std::min(begin + chunkSize, count);
+        futures.push_back(submit([&job, begin, end]() {
+            for (auto i = begin; i < end; i++) {
+                job(i);
+            }
+        }));
+    }
+
+    // wait all the chunks before rethrowing, the jobs reference the caller stack
+    for (auto& future : futures) {
+        future.wait();
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> job)
+{
+    {
+        std::scoped_lock<std::mutex> lock(_mutex);
+        _jobs.push(std::move(job));
+    }
+    _condition.notify_one();
+}
+
+void ThreadPool::workerLoop()
+{
+    currentPool = this;
+
+    while (true) {
+        std::function<void()> job {};
+
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+            if (_stopping && _jobs.empty()) {
+                return;
+            }
+
+            job = std::move(_jobs.front());
+            _jobs.pop();
+        }
+
+        job();
+    }
+}
+
+} // namespace chronicle
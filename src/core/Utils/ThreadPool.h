@@ -0,0 +1,59 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#pragma once
+
+#include "pch.h"
+
+namespace chronicle {
+
+/// @brief Fixed size pool of worker threads used to run CPU bound jobs.
+class ThreadPool : private NonCopyable<ThreadPool> {
+public:
+    /// @brief Default constructor.
+    /// @param threadCount Number of worker threads, 0 to use the hardware concurrency.
+    explicit ThreadPool(uint32_t threadCount = 0);
+
+    /// @brief Destructor. Wait for the queued jobs and join the workers.
+    ~ThreadPool();
+
+    /// @brief Get the number of worker threads.
+    /// @return Worker threads count.
+    [[nodiscard]] uint32_t threadCount() const { return static_cast<uint32_t>(_workers.size()); }
+
+    /// @brief Queue a job in the pool.
+    /// @param job Job to execute.
+    /// @return Future that holds the job result or the exception thrown by the job.
+    template <typename F> [[nodiscard]] std::future<std::invoke_result_t<F>> submit(F&& job)
+    {
+        using ResultType = std::invoke_result_t<F>;
+
+        auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(job));
+        auto future = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    /// @brief Execute a job for every index in the range [0, count) and wait for completion.
+    ///        The exceptions thrown by the jobs are propagated to the caller. When it's called by a worker of the
+    ///        same pool the jobs are executed inline on the calling thread.
+    /// @param count Number of indices.
+    /// @param job Job to execute for every index.
+    void parallelFor(size_t count, const std::function<void(size_t)>& job);
+
+private:
+    std::vector<std::thread> _workers {}; ///< Worker threads.
+    std::queue<std::function<void()>> _jobs {}; ///< Pending jobs.
+    std::mutex _mutex {}; ///< Mutex that protects the jobs queue.
+    std::condition_variable _condition {}; ///< Condition used to wake up the workers.
+    bool _stopping { false }; ///< Set when the pool is shutting down.
+
+    /// @brief Push a job in the queue and wake up a worker.
+    /// @param job Job to execute.
+    void enqueue(std::function<void()> job);
+
+    /// @brief Worker thread main loop.
+    void workerLoop();
+};
+
+} // namespace chronicle
@@ -100,15 +100,23 @@
 #pragma warning(pop)
 
 // std lib
+#include <atomic>
 #include <bit>
 #include <chrono>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <mutex>
 #include <optional>
+#include <queue>
 #include <regex>
 #include <set>
+#include <span>
 #include <string>
+#include <thread>
 #include <vector>
 
 // logs
@@ -6,6 +6,7 @@
 #include <Assets/old/MeshAsset.h>
 #include <Assets/old/TextureAsset.h>
 #include <Loaders/AssetLoader.h>
+#include <Loaders/ShaderLoader.h>
 #include <Platform/Platform.h>
 #include <Renderer/Renderer.h>
 #include <Storage/StorageContext.h>
@@ -23,8 +24,16 @@ public:
     {
         StorageContext::init();
         Platform::init();
+
+        // the shader cache is in the working directory, like the other files used by the example
+        RenderContext::setCacheDirectory(std::filesystem::current_path() / "Cache");
         RenderContext::init();
 
+        // precompiled shader variants, built by the chronicle-shadervariants target
+        if (auto archive = std::filesystem::current_path() / "ShaderVariants.bin"; std::filesystem::exists(archive)) {
+            ShaderLoader::loadArchive(archive);
+        }
+
         Platform::dispatcher().sink<CursorPositionEvent>().connect<&ExampleApp::onCursorPosition>(this);
         Platform::dispatcher().sink<MouseButtonEvent>().connect<&ExampleApp::onMouseButton>(this);
         Platform::dispatcher().sink<KeyEvent>().connect<&ExampleApp::onKeyPress>(this);
@@ -65,6 +74,7 @@ public:
 
         //_mesh2.reset();
         _scene.reset();
+        AssetLoader::deinit();
 
         RenderContext::deinit();
         Platform::deinit();
@@ -79,6 +89,7 @@ public:
 
         while (Platform::poll(delta)) {
             StorageContext::poll();
+            AssetLoader::poll();
             if (!RenderContext::beginFrame())
                 continue;
 
@@ -115,6 +126,7 @@ public:
             // time += delta;
 
             _ubo.model = glm::rotate(glm::mat4(1.0f), time * glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+            _ubo.normalModel = glm::transpose(glm::inverse(_ubo.model));
             _ubo.view = _camera.view();
             _ubo.proj = _camera.projection();
 
@@ -0,0 +1,112 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "pch.h"
+
+#include <Renderer/Vulkan/VulkanShaderArchive.h>
+#include <Renderer/Vulkan/VulkanShaderCompiler.h>
+#include <Storage/StorageContext.h>
+#include <Utils/ThreadPool.h>
+
+using namespace chronicle;
+using namespace chronicle::internal::vulkan;
+
+/// @brief Shader variant to compile.
+struct ShaderVariant {
+    std::string filename {}; ///< Shader filename.
+    std::vector<std::string> macroDefinitions {}; ///< Enabled variant macros.
+};
+
+/// @brief Find the built-in shaders.
+/// @return Shader filenames.
+static std::vector<std::string> findBuiltInShaders()
+{
+    std::filesystem::path resourcesPath { RESOURCES_DEBUG_PATH };
+    resourcesPath /= "Resources";
+
+    std::vector<std::string> filenames = {};
+    for (const auto& item : std::filesystem::recursive_directory_iterator(resourcesPath)) {
+        auto extension = item.path().extension();
+        if (item.is_regular_file() && (extension == ".glsl" || extension == ".hlsl")) {
+            auto relativePath = std::filesystem::relative(item.path(), resourcesPath).generic_string();
+            filenames.push_back(fmt::format("Built-In/{}", relativePath));
+        }
+    }
+    std::ranges::sort(filenames);
+    return filenames;
+}
+
+/// @brief Enumerate all the combinations of the variant macros of a shader.
+/// @param filename Shader filename.
+/// @param variants Filled with the shader variants.
+static void addVariants(const std::string& filename, std::vector<ShaderVariant>& variants)
+{
+    auto macroDefinitions = VulkanShaderCompiler::getVariantMacros(filename);
+    if (macroDefinitions.size() >= 16) {
+        throw RendererError(fmt::format("Too many variant macros in shader {}", filename));
+    }
+
+    auto count = size_t { 1 } << macroDefinitions.size();
+    CHRLOG_INFO("{}: {} variant macros, {} variants", filename, macroDefinitions.size(), count);
+    for (size_t mask = 0; mask < count; mask++) {
+        ShaderVariant variant = { .filename = filename };
+        for (size_t i = 0; i < macroDefinitions.size(); i++) {
+            if ((mask & (size_t { 1 } << i)) != 0) {
+                variant.macroDefinitions.push_back(macroDefinitions[i]);
+            }
+        }
+        variants.push_back(std::move(variant));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    spdlog::set_level(spdlog::level::warn);
+
+    if (argc < 2) {
+        fmt::print(stderr, "Usage: {} <archive> [shaders...]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        StorageContext::init();
+
+        std::vector<std::string> filenames(argv + 2, argv + argc);
+        if (filenames.empty()) {
+            filenames = findBuiltInShaders();
+        }
+
+        std::vector<ShaderVariant> variants = {};
+        for (const auto& filename : filenames) {
+            addVariants(filename, variants);
+        }
+
+        // every variant is compiled by a worker, the results are collected under the lock
+        auto startTime = std::chrono::high_resolution_clock::now();
+        std::vector<std::pair<size_t, ShaderCacheEntry>> entries = {};
+        std::mutex mutex = {};
+        ThreadPool threadPool = {};
+        threadPool.parallelFor(variants.size(), [&variants, &entries, &mutex](size_t index) {
+            const auto& variant = variants[index];
+            auto variantEntries = VulkanShaderCompiler::compileVariant(
+                { .filename = variant.filename, .macroDefinitions = variant.macroDefinitions });
+
+            std::scoped_lock<std::mutex> lock(mutex);
+            std::ranges::move(variantEntries, std::back_inserter(entries));
+        });
+
+        VulkanShaderArchive::write(argv[1], entries);
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+        fmt::print("{} variants, {} modules cooked in {} ms with {} threads: {}\n", variants.size(), entries.size(),
+            duration.count(), threadPool.threadCount(), argv[1]);
+
+        StorageContext::deinit();
+    } catch (const std::exception& e) {
+        CHRLOG_ERROR("Shader cook failed: {}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2023 Sandro Cavazzoni
+// This code is licensed under MIT license (see LICENSE.txt for details)
+
+#include "pch.h"
+
+#include <Loaders/TextureCooker.h>
+
+using namespace chronicle;
+
+int main(int argc, char* argv[])
+{
+    spdlog::set_level(spdlog::level::warn);
+
+    // the options are before the files, so any filename is accepted
+    TextureCookOptions options = {};
+    int index = 1;
+    for (; index < argc; index++) {
+        std::string_view argument = argv[index];
+        if (argument == "--srgb") {
+            options.srgb = true;
+        } else if (argument == "--alpha-cutoff" && index + 1 < argc) {
+            options.alphaCutoff = std::strtof(argv[++index], nullptr);
+        } else {
+            break;
+        }
+    }
+
+    if (argc - index != 2) {
+        fmt::print(stderr, "Usage: {} [--srgb] [--alpha-cutoff <value>] <source> <destination>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        if (!TextureCooker::cookFile(argv[index], argv[index + 1], options)) {
+            CHRLOG_ERROR("Texture cook failed: {}", argv[index]);
+            return EXIT_FAILURE;
+        }
+    } catch (const std::exception& e) {
+        CHRLOG_ERROR("Texture cook failed: {}", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}